@@ -0,0 +1,315 @@
+/// Note: benchmark runner of the luky scripts.
+/// Runs each workload several times in a child process, with its output sent to /dev/null,
+/// and reports the wall times, the peak resident memory and the allocations count,
+/// printed by luky --alloc-stats, so the interpreter is the luky_stats build.
+/// The results are written as JSON, and compared to a stored baseline whether one is given.
+/// Usage: luky_bench [--luky path] [--runs n] [--vm] [--out file] [--baseline file]
+///     [--threshold percent] [workloads or directories...]
+
+#include <algorithm> // sort
+#include <chrono>
+#include <cmath> // ceil
+#include <cstdlib> // strtod
+#include <filesystem>
+#include <fstream>
+#include <iomanip> // setprecision
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h> // open
+#include <sys/resource.h> // rusage
+#include <sys/wait.h> // wait4
+#include <unistd.h> // fork, execv, pipe
+
+namespace fs = std::filesystem;
+
+namespace {
+    struct Options {
+        std::string luky = "build/luky_stats";
+        int runs =5;
+        bool vm = false;
+        std::string out = "build/bench_results.json";
+        std::string baseline;
+        double threshold =10;
+        std::vector<std::string> paths;
+    };
+
+    struct RunResult {
+        bool ok = false;
+        double ms =0;
+        long rssKb =0;
+        long allocations =0;
+    };
+
+    struct BenchResult {
+        std::string name;
+        std::vector<double> times;
+        double medianMs =0;
+        double p90Ms =0;
+        double minMs =0;
+        double maxMs =0;
+        long peakRssKb =0;
+        long allocations =0;
+    };
+
+    // values of a baseline entry, keyed by field name
+    using Baseline = std::map<std::string, std::map<std::string, double>>;
+
+    void usage() {
+        std::cerr << "Usage: luky_bench [--luky path] [--runs n] [--vm] [--out file] [--baseline file]\n"
+            << "    [--threshold percent] [workloads or directories...]\n"
+            << "--luky: interpreter to run, counting its allocations (default: build/luky_stats)\n"
+            << "--runs: number of runs of each workload (default: 5)\n"
+            << "--vm: run the workloads with the bytecode VM\n"
+            << "--out: JSON file of the results (default: build/bench_results.json)\n"
+            << "--baseline: JSON file of a previous run, the regressions are reported\n"
+            << "--threshold: slowdown in percent reported as a regression (default: 10)\n"
+            << "The default workloads are the .luk files of the bench directory.\n";
+    }
+
+    // Note: the allocations count is the last line printed by luky --alloc-stats on stderr
+    long parseAllocations(const std::string& err) {
+        const std::string key = "Alloc: allocations: ";
+        auto pos = err.rfind(key);
+        if (pos == std::string::npos) return -1;
+
+        return std::strtol(err.c_str() + pos + key.size(), nullptr, 10);
+    }
+
+    RunResult runOnce(const Options& opts, const std::string& path) {
+        RunResult result;
+        int errPipe[2];
+        if (pipe(errPipe) != 0) return result;
+
+        auto start = std::chrono::steady_clock::now();
+        pid_t pid = fork();
+        if (pid < 0) return result;
+        if (pid == 0) {
+            int devNull = open("/dev/null", O_WRONLY);
+            dup2(devNull, STDOUT_FILENO);
+            dup2(errPipe[1], STDERR_FILENO);
+            close(errPipe[0]);
+            std::vector<std::string> args = {opts.luky, "--alloc-stats"};
+            if (opts.vm) args.push_back("--vm");
+            args.push_back(path);
+            std::vector<char*> argv;
+            for (auto& arg: args) argv.push_back(const_cast<char*>(arg.c_str()));
+            argv.push_back(nullptr);
+            execv(argv[0], argv.data());
+            _exit(127);
+        }
+
+        close(errPipe[1]);
+        std::string err;
+        char buf[4096];
+        ssize_t n;
+        while ((n = read(errPipe[0], buf, sizeof(buf))) > 0) err.append(buf, size_t(n));
+        close(errPipe[0]);
+
+        int status =0;
+        struct rusage usage {};
+        wait4(pid, &status, 0, &usage);
+        auto end = std::chrono::steady_clock::now();
+        result.ms = std::chrono::duration<double, std::milli>(end - start).count();
+        // Note: ru_maxrss is in kilobytes on Linux
+        result.rssKb = usage.ru_maxrss;
+        result.allocations = parseAllocations(err);
+        result.ok = WIFEXITED(status) && WEXITSTATUS(status) == 0 && result.allocations >= 0;
+        if (!result.ok) std::cerr << "luky_bench: " << path << " failed:\n" << err;
+
+        return result;
+    }
+
+    // Note: nearest rank percentile of the sorted times
+    double percentile(const std::vector<double>& sorted, double pct) {
+        size_t rank = size_t(std::ceil(pct / 100.0 * double(sorted.size())));
+        if (rank == 0) rank =1;
+
+        return sorted[rank -1];
+    }
+
+    double median(const std::vector<double>& sorted) {
+        size_t mid = sorted.size() / 2;
+        if (sorted.size() % 2 == 1) return sorted[mid];
+
+        return (sorted[mid -1] + sorted[mid]) / 2;
+    }
+
+    bool runBench(const Options& opts, const std::string& path, BenchResult& bench) {
+        bench.name = fs::path(path).stem().string();
+        // Note: a first run, not measured, warms up the file cache
+        if (!runOnce(opts, path).ok) return false;
+        for (int i=0; i < opts.runs; ++i) {
+            auto run = runOnce(opts, path);
+            if (!run.ok) return false;
+            bench.times.push_back(run.ms);
+            bench.peakRssKb = std::max(bench.peakRssKb, run.rssKb);
+            bench.allocations = run.allocations;
+        }
+        auto sorted = bench.times;
+        std::sort(sorted.begin(), sorted.end());
+        bench.medianMs = median(sorted);
+        bench.p90Ms = percentile(sorted, 90);
+        bench.minMs = sorted.front();
+        bench.maxMs = sorted.back();
+
+        return true;
+    }
+
+    std::vector<std::string> collectWorkloads(const std::vector<std::string>& paths) {
+        std::vector<std::string> files;
+        for (auto& path: paths) {
+            if (!fs::is_directory(path)) {
+                files.push_back(path);
+                continue;
+            }
+            std::vector<std::string> found;
+            for (auto& entry: fs::directory_iterator(path)) {
+                if (entry.path().extension() == ".luk") found.push_back(entry.path().string());
+            }
+            std::sort(found.begin(), found.end());
+            files.insert(files.end(), found.begin(), found.end());
+        }
+
+        return files;
+    }
+
+    // Note: each benchmark is written on its own line, so the baseline is read line by line
+    void writeJson(std::ostream& ost, const Options& opts, const std::vector<BenchResult>& results) {
+        ost << std::fixed << std::setprecision(3);
+        ost << "{\n";
+        ost << "  \"luky\": \"" << opts.luky << "\",\n";
+        ost << "  \"vm\": " << (opts.vm ? "true" : "false") << ",\n";
+        ost << "  \"runs\": " << opts.runs << ",\n";
+        ost << "  \"benchmarks\": [\n";
+        for (size_t i=0; i < results.size(); ++i) {
+            auto& bench = results[i];
+            ost << "    {\"name\": \"" << bench.name << "\""
+                << ", \"median_ms\": " << bench.medianMs
+                << ", \"p90_ms\": " << bench.p90Ms
+                << ", \"min_ms\": " << bench.minMs
+                << ", \"max_ms\": " << bench.maxMs
+                << ", \"peak_rss_kb\": " << bench.peakRssKb
+                << ", \"allocations\": " << bench.allocations << "}"
+                << (i +1 < results.size() ? ",\n" : "\n");
+        }
+        ost << "  ]\n}\n";
+    }
+
+    // Note: reads only the files written by writeJson
+    bool readBaseline(const std::string& path, Baseline& baseline) {
+        std::ifstream file(path);
+        if (!file.is_open()) return false;
+        std::string line;
+        while (std::getline(file, line)) {
+            auto pos = line.find("{\"name\": \"");
+            if (pos == std::string::npos) continue;
+            pos += 10;
+            auto end = line.find('"', pos);
+            if (end == std::string::npos) continue;
+            auto& fields = baseline[line.substr(pos, end - pos)];
+            for (pos = line.find(", \"", end); pos != std::string::npos; pos = line.find(", \"", pos)) {
+                pos += 3;
+                auto keyEnd = line.find('"', pos);
+                if (keyEnd == std::string::npos) break;
+                fields[line.substr(pos, keyEnd - pos)] = std::strtod(line.c_str() + keyEnd + 3, nullptr);
+            }
+        }
+
+        return true;
+    }
+
+    // returns the number of regressions
+    int compare(const std::vector<BenchResult>& results, const Baseline& baseline, double threshold) {
+        int regressions =0;
+        std::cout << "\nCompared to the baseline, threshold: " << threshold << "%\n";
+        for (auto& bench: results) {
+            auto iter = baseline.find(bench.name);
+            if (iter == baseline.end()) {
+                std::cout << "  " << bench.name << ": not in the baseline\n";
+                continue;
+            }
+            auto& fields = iter->second;
+            double oldMs = fields.count("median_ms") ? fields.at("median_ms") : 0;
+            double oldAllocs = fields.count("allocations") ? fields.at("allocations") : 0;
+            double timeDelta = oldMs > 0 ? (bench.medianMs - oldMs) / oldMs * 100 : 0;
+            double allocDelta = oldAllocs > 0 ? (double(bench.allocations) - oldAllocs) / oldAllocs * 100 : 0;
+            bool slower = timeDelta > threshold;
+            bool moreAllocs = allocDelta > threshold;
+            std::cout << "  " << std::left << std::setw(12) << bench.name << std::right
+                << " time: " << std::showpos << std::setw(7) << timeDelta << "%"
+                << ", allocations: " << std::setw(7) << allocDelta << "%" << std::noshowpos
+                << (slower || moreAllocs ? "  REGRESSION" : "") << "\n";
+            if (slower || moreAllocs) ++regressions;
+        }
+
+        return regressions;
+    }
+
+    bool parseOptions(int argc, char* argv[], Options& opts) {
+        for (int i=1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            bool hasValue = i +1 < argc;
+            if (arg == "--vm") opts.vm = true;
+            else if (arg == "--luky" && hasValue) opts.luky = argv[++i];
+            else if (arg == "--runs" && hasValue) opts.runs = std::atoi(argv[++i]);
+            else if (arg == "--out" && hasValue) opts.out = argv[++i];
+            else if (arg == "--baseline" && hasValue) opts.baseline = argv[++i];
+            else if (arg == "--threshold" && hasValue) opts.threshold = std::atof(argv[++i]);
+            else if (arg.rfind("--", 0) == 0) return false;
+            else opts.paths.push_back(arg);
+        }
+        if (opts.paths.empty()) opts.paths.push_back("bench");
+
+        return opts.runs > 0;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options opts;
+    if (!parseOptions(argc, argv, opts)) {
+        usage();
+        return 2;
+    }
+    auto files = collectWorkloads(opts.paths);
+    if (files.empty()) {
+        std::cerr << "luky_bench: no workload found.\n";
+        return 2;
+    }
+
+    std::vector<BenchResult> results;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::left << std::setw(12) << "benchmark" << std::right
+        << std::setw(12) << "median ms" << std::setw(10) << "p90 ms"
+        << std::setw(10) << "min ms" << std::setw(12) << "peak KB"
+        << std::setw(14) << "allocations" << "\n";
+    for (auto& file: files) {
+        BenchResult bench;
+        if (!runBench(opts, file, bench)) return 1;
+        std::cout << std::left << std::setw(12) << bench.name << std::right
+            << std::setw(12) << bench.medianMs << std::setw(10) << bench.p90Ms
+            << std::setw(10) << bench.minMs << std::setw(12) << bench.peakRssKb
+            << std::setw(14) << bench.allocations << "\n";
+        results.push_back(std::move(bench));
+    }
+
+    std::ofstream out(opts.out);
+    if (!out.is_open()) {
+        std::cerr << "luky_bench: cannot write " << opts.out << "\n";
+        return 1;
+    }
+    writeJson(out, opts, results);
+    std::cout << "Results written to " << opts.out << "\n";
+
+    if (opts.baseline.empty()) return 0;
+    Baseline baseline;
+    if (!readBaseline(opts.baseline, baseline)) {
+        std::cerr << "luky_bench: cannot read the baseline " << opts.baseline << "\n";
+        return 1;
+    }
+
+    return compare(results, baseline, opts.threshold) > 0 ? 1 : 0;
+}
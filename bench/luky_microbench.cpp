@@ -0,0 +1,366 @@
+/// Note: microbenchmarks of the interpreter components, driven directly, without running a script.
+/// Each benchmark is calibrated to run about 20 ms per sample, and reports the median
+/// of its samples, in nanoseconds per operation.
+/// Usage: luky_microbench [--samples n] [--scale factor] [filter...]
+/// A filter keeps the benchmarks whose name contains it, like: luky_microbench env object
+
+#include "../src/common.hpp"
+#include "../src/lukerror.hpp"
+#include "../src/scanner.hpp"
+#include "../src/parser.hpp"
+#include "../src/reservedwords.hpp"
+#include "../src/resolver.hpp"
+#include "../src/interpreter.hpp"
+#include "../src/environment.hpp"
+#include "../src/lukobject.hpp"
+#include "../src/lukclass.hpp"
+#include "../src/lukinstance.hpp"
+#include "../src/luksource.hpp"
+#include "../src/luksymbol.hpp"
+
+#include <algorithm> // sort
+#include <chrono>
+#include <cstdlib> // atoi, atof
+#include <iomanip> // setw
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace luky;
+
+namespace {
+    // Note: keeps the compiler from removing a computation whose result is not used
+    template <class T>
+    inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__)
+        asm volatile("" : : "r"(&value) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+
+    class Harness {
+    public:
+        Harness(std::vector<std::string> filters, int samples, double scale) :
+            m_filters(std::move(filters)), m_samples(samples), m_scale(scale) {}
+
+        bool selected(const std::string& name) const {
+            if (m_filters.empty()) return true;
+            for (auto& filter: m_filters) {
+                if (name.find(filter) != std::string::npos) return true;
+            }
+            return false;
+        }
+
+        // Note: fn runs opsPerCall operations per call, the time is reported per operation
+        template <class Fn>
+        void run(const std::string& name, size_t opsPerCall, Fn&& fn) {
+            if (!selected(name)) return;
+            fn();
+            size_t calls = calibrate(fn);
+            std::vector<double> samples;
+            for (int i=0; i < m_samples; ++i) {
+                samples.push_back(timeCalls(fn, calls) / double(calls * opsPerCall));
+            }
+            std::sort(samples.begin(), samples.end());
+            double median = samples[samples.size() / 2];
+            std::cout << std::left << std::setw(28) << name << std::right
+                << std::fixed << std::setprecision(1)
+                << std::setw(14) << median << " ns/op"
+                << std::setw(16) << std::setprecision(0) << 1e9 / median << " op/s\n";
+        }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        template <class Fn>
+        static double timeCalls(Fn& fn, size_t calls) {
+            auto start = Clock::now();
+            for (size_t i=0; i < calls; ++i) fn();
+            return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        }
+
+        // number of calls of a sample, doubled until the sample is long enough
+        template <class Fn>
+        size_t calibrate(Fn& fn) const {
+            const double target = 20e6 * m_scale;
+            size_t calls =1;
+            while (true) {
+                double elapsed = timeCalls(fn, calls);
+                if (elapsed >= target || calls >= (size_t(1) << 30)) break;
+                calls = elapsed > target / 16 ? size_t(double(calls) * target / elapsed) +1 : calls * 2;
+            }
+            return calls;
+        }
+
+        std::vector<std::string> m_filters;
+        int m_samples;
+        double m_scale;
+    };
+
+    // Note: a script using functions, classes, loops and strings, repeated to get a large source
+    std::string generateSource(int copies) {
+        std::string source;
+        for (int i=0; i < copies; ++i) {
+            auto n = std::to_string(i);
+            source += "fun fib" + n + "(n) {\n"
+                "    if (n < 2) return n\n"
+                "    return fib" + n + "(n - 1) + fib" + n + "(n - 2)\n"
+                "}\n"
+                "class Point" + n + " {\n"
+                "    init(x, y) {\n"
+                "        this.x = x\n"
+                "        this.y = y\n"
+                "    }\n"
+                "    norm() { return this.x * this.x + this.y * this.y }\n"
+                "}\n"
+                "var total" + n + " = 0\n"
+                "for (var i = 0; i < 10; i += 1) {\n"
+                "    var p = Point" + n + "(i, 2.5)\n"
+                "    total" + n + " += p.norm() + fib" + n + "(5)\n"
+                "}\n"
+                "print \"total: $total" + n + "\", [1, 2, 3], {\"key\": 4}\n";
+        }
+        return source;
+    }
+
+    // Note: a source of words only, reserved words and identifiers, some starting like a reserved word
+    std::string generateWords(int copies) {
+        std::string source;
+        for (int i=0; i < copies; ++i) {
+            source += "if value and count or total while item in items return print_value\n"
+                "this super nil true false do_it classify format orbit whiles var fun\n";
+        }
+        return source;
+    }
+
+    // Note: the tokens are kept by the unit, like the scripts of luky
+    std::vector<TokPtr> scan(SourceUnit& unit, LukError& lukErr) {
+        Scanner scanner(unit, lukErr);
+        return scanner.scanTokens();
+    }
+
+    // Note: the parser takes its tokens, so each run parses a copy of the pointers
+    std::vector<StmtPtr> parse(std::vector<TokPtr> tokens, const SourcePtr& unit, LukError& lukErr) {
+        Parser parser(std::move(tokens), unit, lukErr);
+        return parser.parse();
+    }
+
+    // Note: the names and their tokens are kept by a unit living until the end, like the scanned ones
+    TokPtr identifier(const std::string& name) {
+        static SourcePtr names = SourceUnit::fromString("");
+        std::vector<Token> block;
+        block.emplace_back(TokenType::IDENTIFIER, names->addString(name), "", 1, 1);
+        return &names->addTokens(std::move(block)).front();
+    }
+
+    void benchFrontEnd(Harness& harness, Interpreter& interp, LukError& lukErr) {
+        // about 25000 lines of source
+        const SourcePtr unit = SourceUnit::fromString(generateSource(1500));
+        const std::string_view source = unit->source();
+        const auto tokens = scan(*unit, lukErr);
+        const size_t lines = std::count(source.begin(), source.end(), '\n');
+        std::cout << "source: " << source.size() / 1024 << " KB, " << lines << " lines, "
+            << tokens.size() << " tokens\n";
+
+        harness.run("scanner.scanTokens/token", tokens.size(), [&]() {
+            auto result = scan(*unit, lukErr);
+            doNotOptimize(result);
+        });
+        harness.run("parser.parse/token", tokens.size(), [&]() {
+            auto stmts = parse(tokens, unit, lukErr);
+            doNotOptimize(stmts);
+        });
+        auto stmts = parse(tokens, unit, lukErr);
+        harness.run("resolver.resolve/token", tokens.size(), [&]() {
+            Resolver resolver(interp, lukErr);
+            resolver.resolve(stmts);
+            doNotOptimize(stmts);
+        });
+    }
+
+    void benchReservedWords(Harness& harness, LukError& lukErr) {
+        const SourcePtr unit = SourceUnit::fromString(generateWords(10000));
+        const auto tokens = scan(*unit, lukErr);
+        harness.run("scanner.scanTokens/word", tokens.size(), [&]() {
+            auto result = scan(*unit, lukErr);
+            doNotOptimize(result);
+        });
+
+        std::vector<std::string_view> words;
+        for (size_t i=0; i < tokens.size() && words.size() < 256; ++i) {
+            if (!tokens[i]->lexeme.empty() && tokens[i]->lexeme != ";") words.push_back(tokens[i]->lexeme);
+        }
+        harness.run("reserved.lookup/word", words.size(), [&]() {
+            for (auto word: words) doNotOptimize(reserved::lookup(word));
+        });
+    }
+
+    void benchEnvironment(Harness& harness) {
+        const size_t count =64;
+        std::vector<TokPtr> names;
+        for (size_t i=0; i < count; ++i) names.push_back(identifier("var" + std::to_string(i)));
+
+        harness.run("env.define/var", count, [&]() {
+            auto env = std::make_shared<Environment>();
+            for (auto& name: names) env->define(name->symbol, LukObject(TLukInt(1)));
+            doNotOptimize(env);
+        });
+
+        auto globals = std::make_shared<Environment>();
+        for (auto& name: names) globals->define(name->symbol, LukObject(TLukInt(1)));
+        harness.run("env.get/global", count, [&]() {
+            for (auto& name: names) doNotOptimize(globals->get(name));
+        });
+
+        // Note: a chain of block environments, each with its slots, like the nested scopes
+        for (int depth: {0, 4, 16}) {
+            EnvPtr env = std::make_shared<Environment>(globals);
+            for (int slot=0; slot < 4; ++slot) env->defineSlot(slot, LukObject(TLukInt(slot)));
+            for (int i=0; i < depth; ++i) {
+                env = std::make_shared<Environment>(env);
+                env->defineSlot(0, LukObject(TLukInt(i)));
+            }
+            harness.run("env.getAt/depth " + std::to_string(depth), count, [&]() {
+                for (size_t i=0; i < count; ++i) doNotOptimize(env->getAt(depth, int(i & 3)));
+            });
+            harness.run("env.get/depth " + std::to_string(depth), count, [&]() {
+                for (auto& name: names) doNotOptimize(env->get(name));
+            });
+        }
+    }
+
+    void benchObject(Harness& harness) {
+        const size_t count =256;
+        harness.run("object.construct/int", count, [&]() {
+            for (size_t i=0; i < count; ++i) {
+                LukObject obj{TLukInt(i)};
+                doNotOptimize(obj);
+            }
+        });
+        harness.run("object.construct/string", count, [&]() {
+            for (size_t i=0; i < count; ++i) {
+                LukObject obj(std::string("a short string"));
+                doNotOptimize(obj);
+            }
+        });
+
+        LukObject number(2.5);
+        LukObject str(std::string("shared string"));
+        harness.run("object.copy/double", count, [&]() {
+            for (size_t i=0; i < count; ++i) {
+                LukObject copy = number;
+                doNotOptimize(copy);
+            }
+        });
+        harness.run("object.copy/string", count, [&]() {
+            for (size_t i=0; i < count; ++i) {
+                LukObject copy = str;
+                doNotOptimize(copy);
+            }
+        });
+
+        LukObject a(TLukInt(7));
+        LukObject b(TLukInt(3));
+        LukObject x(1.5);
+        harness.run("object.add/int", count, [&]() {
+            for (size_t i=0; i < count; ++i) {
+                LukObject sum = a + b;
+                doNotOptimize(sum);
+            }
+        });
+        harness.run("object.mul/double", count, [&]() {
+            for (size_t i=0; i < count; ++i) {
+                LukObject product = x * a;
+                doNotOptimize(product);
+            }
+        });
+        harness.run("object.equal/string", count, [&]() {
+            LukObject other(std::string("shared string"));
+            for (size_t i=0; i < count; ++i) {
+                bool same = str == other;
+                doNotOptimize(same);
+            }
+        });
+    }
+
+    void benchClass(Harness& harness, Interpreter& interp, LukError& lukErr) {
+        const SourcePtr unit = SourceUnit::fromString(
+            "class Point {\n"
+            "    init(x, y) {\n"
+            "        this.x = x\n"
+            "        this.y = y\n"
+            "    }\n"
+            "    norm() { return this.x * this.x + this.y * this.y }\n"
+            "}\n");
+        auto stmts = parse(scan(*unit, lukErr), unit, lukErr);
+        Resolver resolver(interp, lukErr);
+        resolver.resolve(stmts);
+        interp.interpret(stmts);
+        if (lukErr.hadError) return;
+
+        auto className = identifier("Point");
+        LukObject klassObj = interp.m_globals->get(className);
+        auto klass = dynamic_cast<LukClass*>(klassObj.getCallable());
+        if (klass == nullptr) return;
+
+        const size_t count =64;
+        std::vector<LukObject> args = {LukObject(TLukInt(3)), LukObject(TLukInt(4))};
+        harness.run("class.call/init", count, [&]() {
+            for (size_t i=0; i < count; ++i) {
+                LukObject inst = klass->call(interp, args);
+                doNotOptimize(inst);
+            }
+        });
+
+        LukObject inst = klass->call(interp, args);
+        auto instance = static_cast<LukInstance*>(inst.getInstance());
+        auto fieldName = identifier("y");
+        auto methodName = identifier("norm");
+        harness.run("instance.get/field", count, [&]() {
+            for (size_t i=0; i < count; ++i) doNotOptimize(instance->get(fieldName));
+        });
+        InlineCache cache;
+        harness.run("instance.get/field cached", count, [&]() {
+            for (size_t i=0; i < count; ++i) doNotOptimize(instance->get(fieldName, &cache));
+        });
+        harness.run("instance.get/method", count, [&]() {
+            for (size_t i=0; i < count; ++i) doNotOptimize(instance->get(methodName));
+        });
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> filters;
+    int samples =5;
+    double scale =1;
+    for (int i=1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--samples" && i +1 < argc) samples = std::atoi(argv[++i]);
+        else if (arg == "--scale" && i +1 < argc) scale = std::atof(argv[++i]);
+        else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "Usage: luky_microbench [--samples n] [--scale factor] [filter...]\n"
+                << "--samples: number of timed samples of each benchmark (default: 5)\n"
+                << "--scale: multiplies the duration of a sample, about 20 ms (default: 1)\n"
+                << "filter: runs only the benchmarks whose name contains it\n";
+            return 2;
+        } else filters.push_back(arg);
+    }
+    if (samples < 1) samples =1;
+
+    LukError lukErr;
+    Interpreter interp(lukErr);
+    Harness harness(filters, samples, scale);
+    benchFrontEnd(harness, interp, lukErr);
+    benchReservedWords(harness, lukErr);
+    benchEnvironment(harness);
+    benchObject(harness);
+    benchClass(harness, interp, lukErr);
+    if (lukErr.hadError) {
+        std::cerr << "luky_microbench: the benchmark scripts have errors.\n";
+        return 1;
+    }
+
+    return 0;
+}
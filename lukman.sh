@@ -10,6 +10,9 @@ rootDir=$(dirname $0)
 testDir="$rootDir/tests"
 lukApp="$rootDir/build/release/luky"
 lukDebugApp="$rootDir/build/debug/luky_debug"
+lukStatsApp="$rootDir/build/release/luky_stats"
+lukBenchApp="$rootDir/build/release/luky_bench"
+benchDir="$rootDir/bench"
 sconsFile="$rootDir/SConstruct"
 excludeFile="17_03_native_readln.luk"
 # echo "Here is rootDir: $rootDir, et testDir: $testDir"
@@ -37,6 +40,9 @@ help="$appName usage:
     -F: run debug from file
     -t, test: running some tests
     -T, testall: running all tests
+    -V, testallvm: running all tests with the bytecode VM
+    -P, bench [options]: running the benchmarks of bench/, with the runner options
+        (--vm, --runs n, --out file, --baseline file, --threshold percent)
     "
 
 # check whether lukyApp exists
@@ -107,10 +113,15 @@ elif [[ "$1" = "-t" || "$1" = "test" ]]; then
     echo -e "\nEnd test";
 
 # running all tests
-elif [[ "$1" = "-T" || "$1" = "testall" ]]; then
+# Note: with the bytecode VM, outputs must be the same as the tree-walking interpreter
+elif [[ "$1" = "-T" || "$1" = "testall" || "$1" = "-V" || "$1" = "testallvm" ]]; then
     CheckFile $lukApp
     count=1
-    echo -e "Running all tests\n"
+    vmOpt=""
+    if [[ "$1" = "-V" || "$1" = "testallvm" ]]; then
+        vmOpt="--vm"
+    fi
+    echo -e "Running all tests $vmOpt\n"
     for fname in $testDir/*.luk; do
         name=$(basename $fname)
         echo -e "#$count"
@@ -119,12 +130,21 @@ elif [[ "$1" = "-T" || "$1" = "testall" ]]; then
             echo -e "Pass...\n"
             continue
         fi
-        $lukApp $fname
+        $lukApp $vmOpt $fname
         let count=$count+1
         echo -e "#----------------------------------------\n\n"
     done
     echo -e "\nEnd test";
 
+# running the benchmarks
+# Note: the results are written as JSON, compared to the baseline whether given
+elif [[ "$1" = "-P" || "$1" = "bench" ]]; then
+    CheckFile $lukStatsApp
+    CheckFile $lukBenchApp
+    shift
+    $lukBenchApp --luky $lukStatsApp "$@" $benchDir
+    exit $?
+
 # run normal version with file, without options
 elif [ -e "$1" ]; then
     CheckFile $lukApp
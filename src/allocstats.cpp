@@ -0,0 +1,44 @@
+#include "allocstats.hpp"
+
+#include <cstdlib> // malloc, free
+#include <new> // bad_alloc
+
+using namespace luky;
+
+size_t AllocStats::s_count =0;
+size_t AllocStats::s_bytes =0;
+
+#ifdef LUKY_ALLOC_STATS
+bool AllocStats::enabled() noexcept { return true; }
+#else
+bool AllocStats::enabled() noexcept { return false; }
+#endif
+
+void AllocStats::printStats(std::ostream& ost) {
+    if (!enabled()) {
+        ost << "Alloc: the allocations are not counted, run the luky_stats build\n";
+        return;
+    }
+    ost << "Alloc: allocations: " << s_count
+        << ", bytes: " << s_bytes << "\n";
+}
+
+#ifdef LUKY_ALLOC_STATS
+// Note: the array and nothrow forms of the standard library call these ones,
+// the aligned forms are not replaced, they are not counted.
+void* operator new(std::size_t size) {
+    AllocStats::record(size);
+    void* ptr = std::malloc(size ? size : 1);
+    if (ptr == nullptr) throw std::bad_alloc();
+
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+#endif // LUKY_ALLOC_STATS
@@ -0,0 +1,33 @@
+#ifndef ALLOCSTATS_HPP
+#define ALLOCSTATS_HPP
+
+#include <cstddef> // size_t
+#include <iostream>
+
+namespace luky {
+    /// Note: counts the calls to the global operator new, replaced in allocstats.cpp,
+    /// so the benchmark runner can track the allocations of a whole script.
+    /// The operator is replaced only whether LUKY_ALLOC_STATS is defined, in the luky_stats build,
+    /// so the allocations of the luky build are not slowed down by the counting.
+    /// The interpreter is single threaded, the counters are not atomic.
+    class AllocStats {
+    public:
+        static size_t count() noexcept { return s_count; }
+        static size_t bytes() noexcept { return s_bytes; }
+        // whether the allocations are counted by this build
+        static bool enabled() noexcept;
+        static void printStats(std::ostream& ost);
+
+        // Note: only called by the replaced operator new
+        static void record(size_t size) noexcept {
+            ++s_count;
+            s_bytes += size;
+        }
+
+    private:
+        static size_t s_count;
+        static size_t s_bytes;
+    };
+}
+
+#endif // ALLOCSTATS_HPP
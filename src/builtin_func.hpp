@@ -11,6 +11,22 @@
 #include "builtins/str_func.hpp"
 #include "builtins/type_func.hpp"
 #include "builtins/len_func.hpp"
+#include "builtins/substr_func.hpp"
+#include "builtins/push_func.hpp"
+#include "builtins/pop_func.hpp"
+#include "builtins/get_func.hpp"
+#include "builtins/has_func.hpp"
+#include "builtins/delete_func.hpp"
+#include "builtins/keys_func.hpp"
+#include "builtins/array_func.hpp"
+#include "builtins/fill_func.hpp"
+#include "builtins/arrayop_func.hpp"
+#include "builtins/compare_func.hpp"
+#include "builtins/reduce_func.hpp"
+#include "builtins/dot_func.hpp"
+#include "builtins/scale_func.hpp"
+#include "builtins/range_func.hpp"
+#include "builtins/gc_func.hpp"
 
 namespace luky {
     class BuiltinFunc {
@@ -20,41 +36,97 @@ namespace luky {
         
         void initNative() {
             // native clock function
-            auto clock_func = std::make_shared<ClockFunc>();
-            m_env->define("clock", std::make_shared<LukObject>(clock_func));
+            auto clock_func = makeRef<ClockFunc>();
+            m_env->define("clock", LukObject(clock_func));
      
             // native double function
-            auto double_func = std::make_shared<DoubleFunc>();
-            m_env->define("double", std::make_shared<LukObject>(double_func));
+            auto double_func = makeRef<DoubleFunc>();
+            m_env->define("double", LukObject(double_func));
 
             // native int function
-            auto int_func = std::make_shared<IntFunc>();
-            m_env->define("int", std::make_shared<LukObject>(int_func));
+            auto int_func = makeRef<IntFunc>();
+            m_env->define("int", LukObject(int_func));
 
             // native println function
-            auto println_func = std::make_shared<PrintlnFunc>();
-            m_env->define("println", std::make_shared<LukObject>(println_func));
+            auto println_func = makeRef<PrintlnFunc>();
+            m_env->define("println", LukObject(println_func));
             
             // native random function
-            auto random_func = std::make_shared<RandomFunc>();
-            m_env->define("random", std::make_shared<LukObject>(random_func));
+            auto random_func = makeRef<RandomFunc>();
+            m_env->define("random", LukObject(random_func));
          
             // native readln function
-            auto readln_func = std::make_shared<ReadlnFunc>();
-            m_env->define("readln", std::make_shared<LukObject>(readln_func));
+            auto readln_func = makeRef<ReadlnFunc>();
+            m_env->define("readln", LukObject(readln_func));
             
             // native str function
-            auto str_func = std::make_shared<StrFunc>();
-            m_env->define("str", std::make_shared<LukObject>(str_func));
+            auto str_func = makeRef<StrFunc>();
+            m_env->define("str", LukObject(str_func));
 
             
             // native type function
-            auto type_func = std::make_shared<TypeFunc>();
-            m_env->define("type", std::make_shared<LukObject>(type_func));
+            auto type_func = makeRef<TypeFunc>();
+            m_env->define("type", LukObject(type_func));
 
             // native len function
-            auto len_func = std::make_shared<LenFunc>();
-            m_env->define("len", std::make_shared<LukObject>(len_func));
+            auto len_func = makeRef<LenFunc>();
+            m_env->define("len", LukObject(len_func));
+
+            // native substr function
+            auto substr_func = makeRef<SubstrFunc>();
+            m_env->define("substr", LukObject(substr_func));
+
+            // native push and pop functions, for lists
+            auto push_func = makeRef<PushFunc>();
+            m_env->define("push", LukObject(push_func));
+            auto pop_func = makeRef<PopFunc>();
+            m_env->define("pop", LukObject(pop_func));
+
+            // native get, has, delete and keys functions, for maps
+            auto get_func = makeRef<GetFunc>();
+            m_env->define("get", LukObject(get_func));
+            auto has_func = makeRef<HasFunc>();
+            m_env->define("has", LukObject(has_func));
+            auto delete_func = makeRef<DeleteFunc>();
+            m_env->define("delete", LukObject(delete_func));
+            auto keys_func = makeRef<KeysFunc>();
+            m_env->define("keys", LukObject(keys_func));
+
+            // native typed arrays, and their element-wise and reduction functions
+            auto float64_func = makeRef<ArrayFunc>(ArrayKind::Float64);
+            m_env->define("Float64Array", LukObject(float64_func));
+            auto int64_func = makeRef<ArrayFunc>(ArrayKind::Int64);
+            m_env->define("Int64Array", LukObject(int64_func));
+            auto fill_func = makeRef<FillFunc>();
+            m_env->define("fill", LukObject(fill_func));
+            auto add_func = makeRef<ArrayOpFunc>("add", simd::Op::Add);
+            m_env->define("add", LukObject(add_func));
+            auto sub_func = makeRef<ArrayOpFunc>("sub", simd::Op::Sub);
+            m_env->define("sub", LukObject(sub_func));
+            auto mul_func = makeRef<ArrayOpFunc>("mul", simd::Op::Mul);
+            m_env->define("mul", LukObject(mul_func));
+            auto div_func = makeRef<ArrayOpFunc>("div", simd::Op::Div);
+            m_env->define("div", LukObject(div_func));
+            auto compare_func = makeRef<CompareFunc>();
+            m_env->define("compare", LukObject(compare_func));
+            auto sum_func = makeRef<ReduceFunc>(Reduce::Sum);
+            m_env->define("sum", LukObject(sum_func));
+            auto min_func = makeRef<ReduceFunc>(Reduce::Min);
+            m_env->define("min", LukObject(min_func));
+            auto max_func = makeRef<ReduceFunc>(Reduce::Max);
+            m_env->define("max", LukObject(max_func));
+            auto dot_func = makeRef<DotFunc>();
+            m_env->define("dot", LukObject(dot_func));
+            auto scale_func = makeRef<ScaleFunc>();
+            m_env->define("scale", LukObject(scale_func));
+
+            // lazy range of integers, iterated by the for-in loop
+            auto range_func = makeRef<RangeFunc>();
+            m_env->define("range", LukObject(range_func));
+
+            // native gc function, runs the cycle collector
+            auto gc_func = makeRef<GcFunc>();
+            m_env->define("gc", LukObject(gc_func));
 
 
     }
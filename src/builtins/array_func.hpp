@@ -0,0 +1,56 @@
+#ifndef ARRAY_FUNC_HPP
+#define ARRAY_FUNC_HPP
+#include "../lukarray.hpp"
+#include "../luklist.hpp"
+#include "../lukrange.hpp"
+
+#include <string>
+#include <vector>
+
+namespace luky {
+    class LukCallable;
+    class Interpreter;
+
+    /// Note: Float64Array(...) and Int64Array(...) create a typed array:
+    /// (size) of zeros, (list), (array) or (range) converted, 
+    /// (start, stop) or (start, stop, step) of the range of values.
+    class ArrayFunc : public LukCallable {
+    public:
+        explicit ArrayFunc(ArrayKind kind) : m_kind(kind) {} 
+
+        virtual size_t arity() override { return 255; }
+        virtual LukObject  call(Interpreter& /*interp*/, 
+               std::vector<LukObject>& v_args) override {
+            if (v_args.size() == 1) {
+                auto& arg = v_args[0];
+                if (arg.isInt()) {
+                    if (arg.getInt() < 0) throw RuntimeError("Array size cannot be negative.");
+                    return LukObject(makeRef<LukArray>(m_kind, size_t(arg.getInt())));
+                }
+                if (arg.isList()) return LukObject(LukArray::fromList(m_kind, *arg.getList()));
+                if (arg.isArray()) return LukObject(LukArray::fromArray(m_kind, *arg.getArray()));
+                if (arg.isRange()) {
+                    auto range = arg.getRange();
+                    return LukObject(LukArray::range(m_kind, LukObject(range->start()),
+                            LukObject(range->stop()), LukObject(range->step())));
+                }
+            } else if (v_args.size() == 2 || v_args.size() == 3) {
+                LukObject step = v_args.size() == 3 ? v_args[2] : LukObject(TLukInt(1));
+                return LukObject(LukArray::range(m_kind, v_args[0], v_args[1], step));
+            }
+
+            throw RuntimeError(name() + "() expects a size, a list, an array or a range.");
+        }
+       
+        virtual std::string toString() const override { return "<Native Function: " + name() + "()>"; }
+
+    private:
+        std::string name() const {
+            return m_kind == ArrayKind::Float64 ? "Float64Array" : "Int64Array";
+        }
+
+        ArrayKind m_kind;
+    };
+}
+
+#endif // ARRAY_FUNC_HPP
@@ -0,0 +1,41 @@
+#ifndef ARRAYOP_FUNC_HPP
+#define ARRAYOP_FUNC_HPP
+#include "../lukarray.hpp"
+#include "../simd.hpp"
+
+#include <string>
+#include <vector>
+#include <sstream> // ostringstream
+
+namespace luky {
+    class LukCallable;
+    class Interpreter;
+
+    /// Note: add(a, b), sub(a, b), mul(a, b) and div(a, b) return a new array
+    /// of the element-wise operation, b is an array of the same size or a number.
+    class ArrayOpFunc : public LukCallable {
+    public:
+        ArrayOpFunc(const std::string& name, simd::Op op) : m_name(name), m_op(op) {} 
+
+        virtual size_t arity() override { return 2; }
+        virtual LukObject  call(Interpreter& /*interp*/, 
+               std::vector<LukObject>& v_args) override {
+            if (!v_args[0].isArray()) {
+                std::ostringstream errMsg;
+                errMsg << "Object of type '"
+                << v_args[0].typeOf()  << "' has no " << m_name << "().";
+                throw RuntimeError(errMsg.str());
+            }
+
+            return LukObject(LukArray::binary(m_op, *v_args[0].getArray(), v_args[1]));
+        }
+       
+        virtual std::string toString() const override { return "<Native Function: " + m_name + "()>"; }
+
+    private:
+        std::string m_name;
+        simd::Op m_op;
+    };
+}
+
+#endif // ARRAYOP_FUNC_HPP
@@ -15,11 +15,11 @@ namespace luky {
         ClockFunc() { m_start = TClock::now(); }
         
         virtual size_t arity() override { return 0; }
-        virtual ObjPtr  call(Interpreter& /*interp*/, 
-               std::vector<ObjPtr>& /*args*/) override {
+        virtual LukObject  call(Interpreter& /*interp*/, 
+               std::vector<LukObject>& /*args*/) override {
             double dur = std::chrono::duration<double>(TClock::now() - m_start).count();
 
-            return std::make_shared<LukObject>(dur);
+            return LukObject(dur);
        }
        
        virtual std::string toString() const override { return "<Function clock()>"; }
@@ -0,0 +1,37 @@
+#ifndef COMPARE_FUNC_HPP
+#define COMPARE_FUNC_HPP
+#include "../lukarray.hpp"
+
+#include <string>
+#include <vector>
+#include <sstream> // ostringstream
+
+namespace luky {
+    class LukCallable;
+    class Interpreter;
+
+    /// Note: compare(a, b) returns a new Int64Array of -1, 0 or 1,
+    /// whether each value of a is lesser, equal or greater than b.
+    class CompareFunc : public LukCallable {
+    public:
+        CompareFunc() {} 
+
+        virtual size_t arity() override { return 2; }
+        virtual LukObject  call(Interpreter& /*interp*/, 
+               std::vector<LukObject>& v_args) override {
+            if (!v_args[0].isArray()) {
+                std::ostringstream errMsg;
+                errMsg << "Object of type '"
+                << v_args[0].typeOf()  << "' has no compare().";
+                throw RuntimeError(errMsg.str());
+            }
+
+            return LukObject(LukArray::compare(*v_args[0].getArray(), v_args[1]));
+        }
+       
+        virtual std::string toString() const override { return "<Native Function: compare()>"; }
+
+    };
+}
+
+#endif // COMPARE_FUNC_HPP
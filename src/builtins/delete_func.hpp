@@ -0,0 +1,39 @@
+#ifndef DELETE_FUNC_HPP
+#define DELETE_FUNC_HPP
+#include "../lukmap.hpp"
+
+#include <string>
+#include <vector>
+#include <sstream> // ostringstream
+
+namespace luky {
+    class LukCallable;
+    class Interpreter;
+
+    /// Note: delete(map, key) removes the key from the map, 
+    /// and returns whether the key was in the map.
+    class DeleteFunc : public LukCallable {
+    public:
+        DeleteFunc() {} 
+
+        virtual size_t arity() override { return 2; }
+        virtual LukObject  call(Interpreter& /*interp*/, 
+               std::vector<LukObject>& v_args) override {
+            if (!v_args[0].isMap()) {
+                std::ostringstream errMsg;
+                errMsg << "Object of type '"
+                << v_args[0].typeOf()  << "' has no delete().";
+                throw RuntimeError(errMsg.str());
+            }
+            if (!LukMap::isKey(v_args[1])) 
+                throw RuntimeError("Map key must be a string, a number or a bool.");
+
+            return LukObject(v_args[0].getMap()->remove(v_args[1]));
+        }
+       
+        virtual std::string toString() const override { return "<Native Function: delete()>"; }
+
+    };
+}
+
+#endif // DELETE_FUNC_HPP
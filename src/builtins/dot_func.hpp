@@ -0,0 +1,32 @@
+#ifndef DOT_FUNC_HPP
+#define DOT_FUNC_HPP
+#include "../lukarray.hpp"
+
+#include <string>
+#include <vector>
+
+namespace luky {
+    class LukCallable;
+    class Interpreter;
+
+    /// Note: dot(a, b) returns the dot product of two arrays of the same size
+    class DotFunc : public LukCallable {
+    public:
+        DotFunc() {} 
+
+        virtual size_t arity() override { return 2; }
+        virtual LukObject  call(Interpreter& /*interp*/, 
+               std::vector<LukObject>& v_args) override {
+            if (!v_args[0].isArray() || !v_args[1].isArray()) {
+                throw RuntimeError("dot() expects two arrays.");
+            }
+
+            return LukArray::dot(*v_args[0].getArray(), *v_args[1].getArray());
+        }
+       
+        virtual std::string toString() const override { return "<Native Function: dot()>"; }
+
+    };
+}
+
+#endif // DOT_FUNC_HPP
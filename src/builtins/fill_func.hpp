@@ -0,0 +1,37 @@
+#ifndef FILL_FUNC_HPP
+#define FILL_FUNC_HPP
+#include "../lukarray.hpp"
+
+#include <string>
+#include <vector>
+#include <sstream> // ostringstream
+
+namespace luky {
+    class LukCallable;
+    class Interpreter;
+
+    /// Note: fill(array, value) sets all the values of the array, and returns the array
+    class FillFunc : public LukCallable {
+    public:
+        FillFunc() {} 
+
+        virtual size_t arity() override { return 2; }
+        virtual LukObject  call(Interpreter& /*interp*/, 
+               std::vector<LukObject>& v_args) override {
+            if (!v_args[0].isArray()) {
+                std::ostringstream errMsg;
+                errMsg << "Object of type '"
+                << v_args[0].typeOf()  << "' has no fill().";
+                throw RuntimeError(errMsg.str());
+            }
+            v_args[0].getArray()->fill(v_args[1]);
+
+            return v_args[0];
+        }
+       
+        virtual std::string toString() const override { return "<Native Function: fill()>"; }
+
+    };
+}
+
+#endif // FILL_FUNC_HPP
@@ -0,0 +1,38 @@
+#ifndef GC_FUNC_HPP
+#define GC_FUNC_HPP
+#include "../lukgc.hpp"
+#include "../lukmap.hpp"
+
+#include <string>
+#include <vector>
+
+namespace luky {
+    class LukCallable;
+    class Interpreter;
+
+    /// Note: gc() runs a collection of the cycle collector now,
+    /// and returns a map of the objects "freed" by it and of the tracked objects still "alive".
+    /// A call is a safe point, like the calls of the script functions.
+    class GcFunc : public LukCallable {
+    public:
+        GcFunc() {}
+
+        virtual size_t arity() override { return 0; }
+        virtual LukObject  call(Interpreter& /*interp*/, 
+               std::vector<LukObject>& /*v_args*/) override {
+            auto& gc = LukGC::get();
+            const TLukInt freed = static_cast<TLukInt>(gc.collect());
+            const TLukInt alive = static_cast<TLukInt>(gc.count());
+            auto stats = makeRef<LukMap>();
+            stats->set(LukObject("freed"), LukObject(freed));
+            stats->set(LukObject("alive"), LukObject(alive));
+
+            return LukObject(stats);
+        }
+       
+        virtual std::string toString() const override { return "<Native Function: gc()>"; }
+
+    };
+}
+
+#endif // GC_FUNC_HPP
@@ -0,0 +1,40 @@
+#ifndef GET_FUNC_HPP
+#define GET_FUNC_HPP
+#include "../lukmap.hpp"
+
+#include <string>
+#include <vector>
+#include <sstream> // ostringstream
+
+namespace luky {
+    class LukCallable;
+    class Interpreter;
+
+    /// Note: get(map, key, default) returns the value of the key,
+    /// or the default value whether the key is not in the map.
+    class GetFunc : public LukCallable {
+    public:
+        GetFunc() {} 
+
+        virtual size_t arity() override { return 3; }
+        virtual LukObject  call(Interpreter& /*interp*/, 
+               std::vector<LukObject>& v_args) override {
+            if (!v_args[0].isMap()) {
+                std::ostringstream errMsg;
+                errMsg << "Object of type '"
+                << v_args[0].typeOf()  << "' has no get().";
+                throw RuntimeError(errMsg.str());
+            }
+            if (!LukMap::isKey(v_args[1])) 
+                throw RuntimeError("Map key must be a string, a number or a bool.");
+            LukObject* val = v_args[0].getMap()->find(v_args[1]);
+
+            return val ? *val : v_args[2];
+        }
+       
+        virtual std::string toString() const override { return "<Native Function: get()>"; }
+
+    };
+}
+
+#endif // GET_FUNC_HPP
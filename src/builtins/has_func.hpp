@@ -0,0 +1,38 @@
+#ifndef HAS_FUNC_HPP
+#define HAS_FUNC_HPP
+#include "../lukmap.hpp"
+
+#include <string>
+#include <vector>
+#include <sstream> // ostringstream
+
+namespace luky {
+    class LukCallable;
+    class Interpreter;
+
+    /// Note: has(map, key) returns whether the key is in the map
+    class HasFunc : public LukCallable {
+    public:
+        HasFunc() {} 
+
+        virtual size_t arity() override { return 2; }
+        virtual LukObject  call(Interpreter& /*interp*/, 
+               std::vector<LukObject>& v_args) override {
+            if (!v_args[0].isMap()) {
+                std::ostringstream errMsg;
+                errMsg << "Object of type '"
+                << v_args[0].typeOf()  << "' has no has().";
+                throw RuntimeError(errMsg.str());
+            }
+            if (!LukMap::isKey(v_args[1])) 
+                throw RuntimeError("Map key must be a string, a number or a bool.");
+
+            return LukObject(v_args[0].getMap()->find(v_args[1]) != nullptr);
+        }
+       
+        virtual std::string toString() const override { return "<Native Function: has()>"; }
+
+    };
+}
+
+#endif // HAS_FUNC_HPP
@@ -13,10 +13,10 @@ namespace luky {
         IntFunc() {} 
 
         virtual size_t arity() override { return 1; }
-        virtual ObjPtr  call(Interpreter& /*interp*/, 
-               std::vector<ObjPtr>& v_args) override {
+        virtual LukObject  call(Interpreter& /*interp*/, 
+               std::vector<LukObject>& v_args) override {
            
-            return std::make_shared<LukObject>(v_args[0]->toInt());
+            return LukObject(v_args[0].toInt());
         }
        
         virtual std::string toString() const override { return "<Native Function: int()>"; }
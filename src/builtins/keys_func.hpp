@@ -0,0 +1,37 @@
+#ifndef KEYS_FUNC_HPP
+#define KEYS_FUNC_HPP
+#include "../lukmap.hpp"
+#include "../luklist.hpp"
+
+#include <string>
+#include <vector>
+#include <sstream> // ostringstream
+
+namespace luky {
+    class LukCallable;
+    class Interpreter;
+
+    /// Note: keys(map) returns a new list of the keys of the map, in insertion order
+    class KeysFunc : public LukCallable {
+    public:
+        KeysFunc() {} 
+
+        virtual size_t arity() override { return 1; }
+        virtual LukObject  call(Interpreter& /*interp*/, 
+               std::vector<LukObject>& v_args) override {
+            if (!v_args[0].isMap()) {
+                std::ostringstream errMsg;
+                errMsg << "Object of type '"
+                << v_args[0].typeOf()  << "' has no keys().";
+                throw RuntimeError(errMsg.str());
+            }
+
+            return LukObject(makeRef<LukList>(v_args[0].getMap()->keys()));
+        }
+       
+        virtual std::string toString() const override { return "<Native Function: keys()>"; }
+
+    };
+}
+
+#endif // KEYS_FUNC_HPP
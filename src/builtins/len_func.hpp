@@ -1,5 +1,10 @@
 #ifndef LEN_FUNC_HPP
 #define LEN_FUNC_HPP
+#include "../luklist.hpp"
+#include "../lukmap.hpp"
+#include "../lukarray.hpp"
+#include "../lukrange.hpp"
+
 #include <string>
 #include <vector>
 #include <sstream> // ostringstream
@@ -8,21 +13,37 @@ namespace luky {
     class LukCallable;
     class Interpreter;
 
-    /// Note: retrieve string length
+    /// Note: retrieve string, list, map, array or range length
     class LenFunc : public LukCallable {
     public:
         LenFunc() {} 
 
         virtual size_t arity() override { return 1; }
-        virtual ObjPtr  call(Interpreter& /*interp*/, 
-               std::vector<ObjPtr>& v_args) override {
-            if (v_args[0]->isString()) {
-                TLukInt val = v_args[0]->toString().size();
-                return std::make_shared<LukObject>(val);
+        virtual LukObject  call(Interpreter& /*interp*/, 
+               std::vector<LukObject>& v_args) override {
+            if (v_args[0].isString()) {
+                TLukInt val = v_args[0].getView().size();
+                return LukObject(val);
+            }
+            if (v_args[0].isList()) {
+                TLukInt val = v_args[0].getList()->size();
+                return LukObject(val);
+            }
+            if (v_args[0].isMap()) {
+                TLukInt val = v_args[0].getMap()->size();
+                return LukObject(val);
+            }
+            if (v_args[0].isArray()) {
+                TLukInt val = v_args[0].getArray()->size();
+                return LukObject(val);
+            }
+            if (v_args[0].isRange()) {
+                TLukInt val = v_args[0].getRange()->size();
+                return LukObject(val);
             }
             std::ostringstream errMsg;
             errMsg << "Object of type '"
-            << v_args[0]->typeOf()  << "' has no len().";
+            << v_args[0].typeOf()  << "' has no len().";
             throw RuntimeError(errMsg.str());
             
         }
@@ -0,0 +1,36 @@
+#ifndef POP_FUNC_HPP
+#define POP_FUNC_HPP
+#include "../luklist.hpp"
+
+#include <string>
+#include <vector>
+#include <sstream> // ostringstream
+
+namespace luky {
+    class LukCallable;
+    class Interpreter;
+
+    /// Note: pop(list) removes the last item of the list, and returns it
+    class PopFunc : public LukCallable {
+    public:
+        PopFunc() {} 
+
+        virtual size_t arity() override { return 1; }
+        virtual LukObject  call(Interpreter& /*interp*/, 
+               std::vector<LukObject>& v_args) override {
+            if (!v_args[0].isList()) {
+                std::ostringstream errMsg;
+                errMsg << "Object of type '"
+                << v_args[0].typeOf()  << "' has no pop().";
+                throw RuntimeError(errMsg.str());
+            }
+
+            return v_args[0].getList()->pop();
+        }
+       
+        virtual std::string toString() const override { return "<Native Function: pop()>"; }
+
+    };
+}
+
+#endif // POP_FUNC_HPP
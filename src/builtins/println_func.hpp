@@ -20,8 +20,8 @@ namespace luky {
 
         /// Note: 255 arguments means variadic function
         virtual size_t arity() override { return 255; }
-        virtual ObjPtr  call(Interpreter& /*interp*/, 
-               std::vector<ObjPtr>& v_args) override {
+        virtual LukObject  call(Interpreter& /*interp*/, 
+               std::vector<LukObject>& v_args) override {
             if (isKeyworded) {
                 /// Note: to switching to ostream out, you must make an ostream* pointer 
                 /// to assign an ostream variable either to std::cout or std::cerr
@@ -43,7 +43,7 @@ namespace luky {
                 *m_out << m_keywords["end"];
             }
 
-            return nilptr;
+            return LukObject();
         }
        
         virtual std::string toString() const override { return "<Native Function: println(...)>"; }
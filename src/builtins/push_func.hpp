@@ -0,0 +1,39 @@
+#ifndef PUSH_FUNC_HPP
+#define PUSH_FUNC_HPP
+#include "../luklist.hpp"
+
+#include <string>
+#include <vector>
+#include <sstream> // ostringstream
+
+namespace luky {
+    class LukCallable;
+    class Interpreter;
+
+    /// Note: push(list, value) appends the value at the end of the list,
+    /// and returns the new length of the list.
+    class PushFunc : public LukCallable {
+    public:
+        PushFunc() {} 
+
+        virtual size_t arity() override { return 2; }
+        virtual LukObject  call(Interpreter& /*interp*/, 
+               std::vector<LukObject>& v_args) override {
+            if (!v_args[0].isList()) {
+                std::ostringstream errMsg;
+                errMsg << "Object of type '"
+                << v_args[0].typeOf()  << "' has no push().";
+                throw RuntimeError(errMsg.str());
+            }
+            auto list = v_args[0].getList();
+            list->push(v_args[1]);
+
+            return LukObject(TLukInt(list->size()));
+        }
+       
+        virtual std::string toString() const override { return "<Native Function: push()>"; }
+
+    };
+}
+
+#endif // PUSH_FUNC_HPP
@@ -22,22 +22,22 @@ namespace luky {
             // // TODO: manage minimum parameters
             return 255; 
         }
-        virtual ObjPtr  call(Interpreter& /*interp*/, 
-               std::vector<ObjPtr>& v_args) override {
+        virtual LukObject  call(Interpreter& /*interp*/, 
+               std::vector<LukObject>& v_args) override {
            
             auto size = v_args.size();
             TLukInt val =0;
             auto start = m_start;
             auto stop = m_stop;
-            if (size == 1) stop = v_args[0]->toInt();
+            if (size == 1) stop = v_args[0].toInt();
             else if (size == 2) {
-                start = v_args[0]->toInt();
-                stop = v_args[1]->toInt();
+                start = v_args[0].toInt();
+                stop = v_args[1].toInt();
             }
             val = (rand() % stop);
             if (val < start) val += start;
           
-            return std::make_shared<LukObject>(val);
+            return LukObject(val);
         }
        
         virtual std::string toString() const override { return "<Native Function: random>"; }
@@ -0,0 +1,44 @@
+#ifndef RANGE_FUNC_HPP
+#define RANGE_FUNC_HPP
+#include "../lukrange.hpp"
+
+#include <string>
+#include <vector>
+
+namespace luky {
+    class LukCallable;
+    class Interpreter;
+
+    /// Note: range(stop), range(start, stop) or range(start, stop, step),
+    /// returns a lazy range, its values are computed by the for-in loop.
+    class RangeFunc : public LukCallable {
+    public:
+        RangeFunc() {} 
+
+        virtual size_t arity() override { return 255; }
+        virtual LukObject  call(Interpreter& /*interp*/, 
+               std::vector<LukObject>& v_args) override {
+            if (v_args.empty() || v_args.size() > 3) 
+                throw RuntimeError("range() expects 1 to 3 arguments.");
+            for (auto& arg: v_args) {
+                if (!arg.isInt()) throw RuntimeError("range() arguments must be integers.");
+            }
+            TLukInt start =0;
+            TLukInt stop = v_args[0].getInt();
+            TLukInt step =1;
+            if (v_args.size() >= 2) {
+                start = v_args[0].getInt();
+                stop = v_args[1].getInt();
+            }
+            if (v_args.size() == 3) step = v_args[2].getInt();
+            if (step == 0) throw RuntimeError("range() step cannot be zero.");
+
+            return LukObject(makeRef<LukRange>(start, stop, step));
+        }
+       
+        virtual std::string toString() const override { return "<Native Function: range()>"; }
+
+    };
+}
+
+#endif // RANGE_FUNC_HPP
@@ -12,8 +12,8 @@ namespace luky {
     public:
         ReadlnFunc() {}
         virtual size_t arity() override { return 1; }
-        virtual ObjPtr  call(Interpreter& /*interp*/, 
-               std::vector<ObjPtr>& v_args) override {
+        virtual LukObject  call(Interpreter& /*interp*/, 
+               std::vector<LukObject>& v_args) override {
           std::string line;
           if (v_args.size() >= 1) {
             std::cout << v_args[0];
@@ -25,7 +25,7 @@ namespace luky {
             else break;
           }
 
-          return std::make_shared<LukObject>(line);
+          return LukObject(line);
        }
        
        virtual std::string toString() const override { return "<Native Function: readln)arg)>"; }
@@ -0,0 +1,50 @@
+#ifndef REDUCE_FUNC_HPP
+#define REDUCE_FUNC_HPP
+#include "../lukarray.hpp"
+
+#include <string>
+#include <vector>
+#include <sstream> // ostringstream
+
+namespace luky {
+    class LukCallable;
+    class Interpreter;
+
+    enum class Reduce { Sum, Min, Max };
+
+    /// Note: sum(array), min(array) and max(array) reduce an array to a single value
+    class ReduceFunc : public LukCallable {
+    public:
+        explicit ReduceFunc(Reduce reduce) : m_reduce(reduce) {} 
+
+        virtual size_t arity() override { return 1; }
+        virtual LukObject  call(Interpreter& /*interp*/, 
+               std::vector<LukObject>& v_args) override {
+            if (!v_args[0].isArray()) {
+                std::ostringstream errMsg;
+                errMsg << "Object of type '"
+                << v_args[0].typeOf()  << "' has no " << name() << "().";
+                throw RuntimeError(errMsg.str());
+            }
+            auto array = v_args[0].getArray();
+            switch (m_reduce) {
+                case Reduce::Sum: return array->sum();
+                case Reduce::Min: return array->min();
+                case Reduce::Max: return array->max();
+            }
+
+            return LukObject();
+        }
+       
+        virtual std::string toString() const override { return "<Native Function: " + name() + "()>"; }
+
+    private:
+        std::string name() const {
+            return m_reduce == Reduce::Sum ? "sum" : m_reduce == Reduce::Min ? "min" : "max";
+        }
+
+        Reduce m_reduce;
+    };
+}
+
+#endif // REDUCE_FUNC_HPP
@@ -0,0 +1,38 @@
+#ifndef SCALE_FUNC_HPP
+#define SCALE_FUNC_HPP
+#include "../lukarray.hpp"
+
+#include <string>
+#include <vector>
+#include <sstream> // ostringstream
+
+namespace luky {
+    class LukCallable;
+    class Interpreter;
+
+    /// Note: scale(array, factor) multiplies the values of the array in place, 
+    /// without allocating a new array, and returns the array.
+    class ScaleFunc : public LukCallable {
+    public:
+        ScaleFunc() {} 
+
+        virtual size_t arity() override { return 2; }
+        virtual LukObject  call(Interpreter& /*interp*/, 
+               std::vector<LukObject>& v_args) override {
+            if (!v_args[0].isArray()) {
+                std::ostringstream errMsg;
+                errMsg << "Object of type '"
+                << v_args[0].typeOf()  << "' has no scale().";
+                throw RuntimeError(errMsg.str());
+            }
+            v_args[0].getArray()->scale(v_args[1]);
+
+            return v_args[0];
+        }
+       
+        virtual std::string toString() const override { return "<Native Function: scale()>"; }
+
+    };
+}
+
+#endif // SCALE_FUNC_HPP
@@ -3,7 +3,6 @@
 
 #include <string>
 #include <vector>
-#include <sstream> // ostringstream
 
 namespace luky {
     class LukCallable;
@@ -15,14 +14,14 @@ namespace luky {
         StrFunc() {} 
 
         virtual size_t arity() override { return 255; }
-        virtual ObjPtr  call(Interpreter& /*interp*/, 
-               std::vector<ObjPtr>& v_args) override {
-            std::ostringstream msg;
+        virtual LukObject  call(Interpreter& /*interp*/, 
+               std::vector<LukObject>& v_args) override {
+            std::string msg;
             for (auto& arg: v_args) {
-                msg << arg->toString();
+                arg.appendTo(msg);
             }
        
-            return std::make_shared<LukObject>(msg.str());
+            return LukObject(std::move(msg));
         }
        
         virtual std::string toString() const override { return "<Native Function: double()>"; }
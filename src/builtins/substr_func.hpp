@@ -0,0 +1,51 @@
+#ifndef SUBSTR_FUNC_HPP
+#define SUBSTR_FUNC_HPP
+#include "../lukstring.hpp"
+
+#include <string>
+#include <vector>
+#include <sstream> // ostringstream
+
+namespace luky {
+    class LukCallable;
+    class Interpreter;
+
+    /// Note: substr(string, start, count) returns count chars from start,
+    /// or until the end of the string, without copying them.
+    class SubstrFunc : public LukCallable {
+    public:
+        SubstrFunc() {} 
+
+        virtual size_t arity() override { return 3; }
+        virtual LukObject  call(Interpreter& /*interp*/, 
+               std::vector<LukObject>& v_args) override {
+            if (!v_args[0].isString()) {
+                std::ostringstream errMsg;
+                errMsg << "Object of type '"
+                << v_args[0].typeOf()  << "' has no substr().";
+                throw RuntimeError(errMsg.str());
+            }
+            if (!v_args[1].isInt() || !v_args[2].isInt()) {
+                throw RuntimeError("substr() start and count must be integers.");
+            }
+            TLukInt size = v_args[0].getView().size();
+            TLukInt start = v_args[1].getInt();
+            TLukInt count = v_args[2].getInt();
+            if (start < 0 || start > size || count < 0) {
+                throw RuntimeError("substr() index out of range.");
+            }
+            if (count > size - start) count = size - start;
+            // Note: an empty string is stored with its quotes
+            if (count == 0) return LukObject(std::string());
+            if (count == size) return v_args[0];
+
+            LukRef<LukString> parent(v_args[0].getLukString());
+            return LukObject(makeRef<LukString>(std::move(parent), size_t(start), size_t(count)));
+        }
+       
+        virtual std::string toString() const override { return "<Native Function: substr()>"; }
+
+    };
+}
+
+#endif // SUBSTR_FUNC_HPP
@@ -0,0 +1,136 @@
+#ifndef CHUNK_HPP
+#define CHUNK_HPP
+
+#include "common.hpp"
+#include "lukobject.hpp"
+#include "token.hpp"
+#include "inlinecache.hpp"
+
+#include <cstdint> // uint8_t, uint16_t
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace luky {
+    // forward declarations
+    class FunctionExpr;
+    class ClassStmt;
+
+    /// Note: list of the bytecode instructions, with their operands.
+    /// The same list generates the OpCode enum and the dispatch table of the VM,
+    /// so they cannot be out of sync.
+    /// operands: u8 is one byte, u16 is two bytes, tok is an u16 index in the tokens table,
+    /// cache is an u16 index in the inline caches table.
+    #define LUK_OPCODES(X) \
+        X(Constant)      /* u16 constant */ \
+        X(Nil) \
+        X(True) \
+        X(False) \
+        X(Pop) \
+        X(Dup) \
+        X(Swap) \
+        X(GetLocal)      /* u8 depth, u16 slot */ \
+        X(SetLocal)      /* u8 depth, u16 slot */ \
+        X(DefineLocal)   /* u16 slot */ \
+        X(GetGlobal)     /* tok name */ \
+        X(SetGlobal)     /* tok name */ \
+        X(DefineGlobal)  /* tok name */ \
+        X(CompoundLocal) /* u8 depth, u16 slot, tok operator, updates the variable in place */ \
+        X(CompoundGlobal)/* tok name, tok operator, updates the variable in place */ \
+        X(GetProperty)   /* tok name, cache */ \
+        X(SetProperty)   /* tok name, cache */ \
+        X(GetSuper)      /* u8 depth, u16 slot, u8 this depth, tok method, cache */ \
+        X(GetMethod)     /* tok name, tok paren, cache, pushes the callee and "this" or nil */ \
+        X(BuildList)     /* u16 count */ \
+        X(BuildMap)      /* u16 count of entries, tok brace, the keys and values alternate */ \
+        X(GetItem) \
+        X(SetItem)       /* tok operator, updates the item in place */ \
+        X(Slice)         /* the omitted bounds are nil */ \
+        X(Add)           /* tok operator */ \
+        X(Subtract)      /* tok operator */ \
+        X(Multiply)      /* tok operator */ \
+        X(Divide)        /* tok operator */ \
+        X(Less)          /* tok operator */ \
+        X(LessEqual)     /* tok operator */ \
+        X(Greater)       /* tok operator */ \
+        X(GreaterEqual)  /* tok operator */ \
+        X(Equal)         /* tok operator */ \
+        X(NotEqual)      /* tok operator */ \
+        X(Binary)        /* tok operator, generic binary operation */ \
+        X(Unary)         /* tok operator, generic unary operation */ \
+        X(Not) \
+        X(Jump)          /* u16 forward offset */ \
+        X(JumpIfFalse)   /* u16 forward offset, keeps the condition */ \
+        X(JumpIfTrue)    /* u16 forward offset, keeps the condition */ \
+        X(PopJumpIfFalse)/* u16 forward offset, pops the condition */ \
+        X(Loop)          /* u16 backward offset */ \
+        X(ForPrep)       /* tok keyword, checks the iterable, pushes the start position */ \
+        X(ForIn)         /* u16 slot, u16 forward offset, stores the next value or exits */ \
+        X(CheckCallable) /* tok paren */ \
+        X(Call)          /* u8 argCount, tok paren */ \
+        X(CallKeywords)  /* u8 argCount, tok paren, u16 keywords */ \
+        X(Invoke)        /* u8 argCount, after GetMethod */ \
+        X(Closure)       /* u16 function */ \
+        X(Inherit)       /* u16 class */ \
+        X(Class)         /* u16 class */ \
+        X(Interpolate)   /* u16 count */ \
+        X(Print)         /* u16 count */ \
+        X(ExprResult) \
+        X(PushEnv) \
+        X(PopEnv) \
+        X(EndBlock) \
+        X(Error)         /* tok, u16 constant message */ \
+        X(Return) \
+        X(Halt)
+
+    enum class OpCode : uint8_t {
+    #define LUK_OPCODE_ENUM(name) name,
+        LUK_OPCODES(LUK_OPCODE_ENUM)
+    #undef LUK_OPCODE_ENUM
+    };
+
+    /// Note: function compiled by the Closure instruction,
+    /// the chunk of its body is stored on the declaration itself.
+    struct FunctionProto {
+        std::string m_name;
+        std::shared_ptr<FunctionExpr> m_declaration;
+    };
+
+    /// Note: keywords passed at a call site, their values are pushed after the arguments
+    struct KeywordsProto {
+        std::vector<TokPtr> m_names;
+    };
+
+    /// Note: a chunk is the compiled form of a script or a function body,
+    /// it owns the bytecode and the tables indexed by the operands.
+    class Chunk {
+    public:
+        std::vector<uint8_t> m_code;
+        std::vector<LukObject> m_constants;
+        std::vector<TokPtr> m_tokens;
+        std::vector<FunctionProto> m_functions;
+        std::vector<ClassStmt*> m_classes;
+        std::vector<KeywordsProto> m_keywords;
+        // Note: the caches belong to the expressions of the AST,
+        // which live as long as the chunk compiled from them.
+        std::vector<InlineCache*> m_caches;
+
+        void write(uint8_t byte) { m_code.push_back(byte); }
+        void write(OpCode op) { m_code.push_back(static_cast<uint8_t>(op)); }
+        void writeShort(uint16_t val) {
+            m_code.push_back(uint8_t(val >> 8));
+            m_code.push_back(uint8_t(val & 0xff));
+        }
+        size_t size() const { return m_code.size(); }
+
+        // Note: returns the index of the new entry in the table
+        size_t addConstant(const LukObject& val) { m_constants.push_back(val); return m_constants.size() -1; }
+        size_t addToken(const TokPtr& tok) { m_tokens.push_back(tok); return m_tokens.size() -1; }
+        size_t addFunction(const FunctionProto& func) { m_functions.push_back(func); return m_functions.size() -1; }
+        size_t addClass(ClassStmt* klass) { m_classes.push_back(klass); return m_classes.size() -1; }
+        size_t addKeywords(const KeywordsProto& kw) { m_keywords.push_back(kw); return m_keywords.size() -1; }
+        size_t addCache(InlineCache* cache) { m_caches.push_back(cache); return m_caches.size() -1; }
+    };
+}
+
+#endif // CHUNK_HPP
@@ -8,11 +8,14 @@ namespace luky {
     class Token;
     class Environment;
     class FunctionStmt;
+    class SourceUnit;
 
     using ExprPtr = std::shared_ptr<Expr>;
     using StmtPtr = std::shared_ptr<Stmt>;
-    using ObjPtr = std::shared_ptr<LukObject>;
-    using TokPtr = std::shared_ptr<Token>;
+    // Note: tokens are kept by their SourceUnit, which outlives the AST pointing to them,
+    // so a plain pointer
+    using TokPtr = Token*;
+    using SourcePtr = std::shared_ptr<SourceUnit>;
     using EnvPtr = std::shared_ptr<Environment>;
     using FuncPtr = std::shared_ptr<FunctionStmt>;
     using TLukInt = __int64_t; // __int128_t;
@@ -0,0 +1,637 @@
+#include "compiler.hpp"
+#include "logger.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace luky;
+
+Compiler::Compiler(LukError& lukErr) : m_lukErr(lukErr) {
+    LOG_MSG(cat_INTERP, "\nIn Compiler constructor");
+}
+
+std::shared_ptr<Chunk> Compiler::compile(std::vector<StmtPtr>& statements) {
+    LOG_MSG(cat_INTERP, "\nIn Compiler compile, statements: ", statements.size());
+    auto chunk = std::make_shared<Chunk>();
+    p_chunk = chunk.get();
+    m_envDepth =0;
+    m_loops.clear();
+    for (auto& stmt: statements) {
+        if (stmt) compile(stmt);
+    }
+    // Note: the script halts without resetting the last expression result,
+    // so the interpreter can print it.
+    emit(OpCode::Halt);
+    p_chunk = nullptr;
+
+    return chunk;
+}
+
+void Compiler::compile(ExprPtr expr) {
+    // Note: a lambda needs its shared declaration, to store its chunk on it
+    if (expr->isFunctionExpr()) {
+        compileClosure("", std::static_pointer_cast<FunctionExpr>(expr));
+        return;
+    }
+    expr->accept(*this);
+}
+
+void Compiler::compile(StmtPtr& stmt) {
+    stmt->accept(*this);
+}
+
+void Compiler::compileFunction(FunctionExpr& func) {
+    // Note: the body is compiled once, even whether the function is declared in a loop
+    if (func.m_chunk != nullptr) return;
+    auto chunk = std::make_shared<Chunk>();
+    func.m_chunk = chunk;
+
+    // saving the state of the enclosing chunk
+    Chunk* enclosing = p_chunk;
+    auto loops = std::move(m_loops);
+    int envDepth = m_envDepth;
+    p_chunk = chunk.get();
+    m_loops.clear();
+    m_envDepth =0;
+
+    for (auto& stmt: func.m_body) {
+        if (stmt) compile(stmt);
+    }
+    emit(OpCode::Nil);
+    emit(OpCode::Return);
+
+    p_chunk = enclosing;
+    m_loops = std::move(loops);
+    m_envDepth = envDepth;
+}
+
+void Compiler::compileClosure(const std::string& name, std::shared_ptr<FunctionExpr> func) {
+    compileFunction(*func);
+    emit(OpCode::Closure);
+    emitShort(p_chunk->addFunction(FunctionProto{name, func}));
+}
+
+void Compiler::emitShort(size_t val) {
+    if (val > 0xffff) {
+        error("Too many entries in one chunk.");
+        val =0;
+    }
+    p_chunk->writeShort(uint16_t(val));
+}
+
+void Compiler::emitConstant(const LukObject& val) {
+    emit(OpCode::Constant);
+    emitShort(p_chunk->addConstant(val));
+}
+
+size_t Compiler::emitJump(OpCode op) {
+    emit(op);
+    p_chunk->writeShort(0xffff);
+    return p_chunk->size() -2;
+}
+
+void Compiler::patchJump(size_t offset) {
+    // -2 to skip the jump operand itself
+    size_t jump = p_chunk->size() - offset -2;
+    if (jump > 0xffff) {
+        error("Too much code to jump over.");
+        return;
+    }
+    p_chunk->m_code[offset] = uint8_t(jump >> 8);
+    p_chunk->m_code[offset +1] = uint8_t(jump & 0xff);
+}
+
+void Compiler::emitLoop(size_t start) {
+    emit(OpCode::Loop);
+    // +2 for the operand of the loop instruction
+    size_t offset = p_chunk->size() - start +2;
+    if (offset > 0xffff) error("Loop body too large.");
+    p_chunk->writeShort(uint16_t(offset));
+}
+
+/// Note: break and continue leave the blocks opened inside the loop,
+/// like executeBlock, the last result is reset.
+void Compiler::emitEnvPops(int depth) {
+    for (int i = m_envDepth; i > depth; --i) {
+        emit(OpCode::EndBlock);
+    }
+}
+
+void Compiler::emitGetVariable(TokPtr& name, Expr& expr) {
+    if (expr.m_depth >= 0) {
+        emit(OpCode::GetLocal);
+        emitByte(uint8_t(expr.m_depth));
+        emitShort(expr.m_slot);
+    } else {
+        emit(OpCode::GetGlobal);
+        emitToken(name);
+    }
+}
+
+void Compiler::emitSetVariable(TokPtr& name, Expr& expr) {
+    if (expr.m_depth >= 0) {
+        emit(OpCode::SetLocal);
+        emitByte(uint8_t(expr.m_depth));
+        emitShort(expr.m_slot);
+    } else {
+        emit(OpCode::SetGlobal);
+        emitToken(name);
+    }
+}
+
+void Compiler::emitDefineVariable(TokPtr& name, int slot) {
+    if (slot >= 0) {
+        emit(OpCode::DefineLocal);
+        emitShort(slot);
+    } else {
+        emit(OpCode::DefineGlobal);
+        emitToken(name);
+    }
+}
+
+void Compiler::error(const std::string& msg) {
+    m_lukErr.error(m_errTitle, msg);
+}
+
+// expressions
+LukObject Compiler::visitAssignExpr(AssignExpr& expr) {
+    if (expr.m_depth > 0xff) error("Too many nested scopes.");
+    compile(expr.m_value);
+    if (expr.m_equals->type != TokenType::EQUAL) {
+        // Note: compound assignment replaces the value by the result, like the interpreter,
+        // a string owned only by the variable is appended in place.
+        if (expr.m_depth >= 0) {
+            emit(OpCode::CompoundLocal);
+            emitByte(uint8_t(expr.m_depth));
+            emitShort(expr.m_slot);
+        } else {
+            emit(OpCode::CompoundGlobal);
+            emitToken(expr.m_name);
+        }
+        emitToken(expr.m_equals);
+        return LukObject();
+    }
+    emitSetVariable(expr.m_name, expr);
+
+    return LukObject();
+}
+
+LukObject Compiler::visitBinaryExpr(BinaryExpr& expr) {
+    compile(expr.m_left);
+    // comma operator
+    if (expr.m_op->type == TokenType::COMMA) {
+        emit(OpCode::Pop);
+        compile(expr.m_right);
+        return LukObject();
+    }
+    compile(expr.m_right);
+
+    switch(expr.m_op->type) {
+        case TokenType::PLUS: emit(OpCode::Add); break;
+        case TokenType::MINUS: emit(OpCode::Subtract); break;
+        case TokenType::STAR: emit(OpCode::Multiply); break;
+        case TokenType::SLASH: emit(OpCode::Divide); break;
+        case TokenType::LESSER: emit(OpCode::Less); break;
+        case TokenType::LESSER_EQUAL: emit(OpCode::LessEqual); break;
+        case TokenType::GREATER: emit(OpCode::Greater); break;
+        case TokenType::GREATER_EQUAL: emit(OpCode::GreaterEqual); break;
+        case TokenType::EQUAL_EQUAL: emit(OpCode::Equal); break;
+        case TokenType::BANG_EQUAL: emit(OpCode::NotEqual); break;
+        default: emit(OpCode::Binary); break;
+    }
+    emitToken(expr.m_op);
+
+    return LukObject();
+}
+
+LukObject Compiler::visitCallExpr(CallExpr& expr) {
+    compile(expr.m_callee);
+    // Note: like the interpreter, the callee is checked before evaluating the arguments
+    if (!expr.m_args.empty() || !expr.m_keywords.empty()) {
+        emit(OpCode::CheckCallable);
+        emitToken(expr.m_paren);
+    }
+    for (auto& arg: expr.m_args) {
+        compile(arg);
+    }
+    if (expr.m_args.size() > 0xff) error("Cannot have more than 255 arguments.");
+
+    if (expr.m_keywords.empty()) {
+        emit(OpCode::Call);
+        emitByte(uint8_t(expr.m_args.size()));
+        emitToken(expr.m_paren);
+        return LukObject();
+    }
+
+    KeywordsProto keywords;
+    for (auto& iter: expr.m_keywords) {
+        compile(iter.second);
+        keywords.m_names.push_back(iter.first);
+    }
+    emit(OpCode::CallKeywords);
+    emitByte(uint8_t(expr.m_args.size()));
+    emitToken(expr.m_paren);
+    emitShort(p_chunk->addKeywords(keywords));
+
+    return LukObject();
+}
+
+LukObject Compiler::visitFunctionExpr(FunctionExpr& expr) {
+    // Note: lambdas are compiled by compile(ExprPtr), with their shared declaration,
+    // this copy is only used whether the expression is visited directly.
+    compileClosure("", std::make_shared<FunctionExpr>(expr));
+
+    return LukObject();
+}
+
+LukObject Compiler::visitGetExpr(GetExpr& expr) {
+    compile(expr.m_object);
+    emit(OpCode::GetProperty);
+    emitToken(expr.m_name);
+    emitCache(expr.m_cache);
+
+    return LukObject();
+}
+
+LukObject Compiler::visitGroupingExpr(GroupingExpr& expr) {
+    compile(expr.m_expression);
+    return LukObject();
+}
+
+LukObject Compiler::visitIndexExpr(IndexExpr& expr) {
+    compile(expr.m_object);
+    if (expr.m_isSlice) {
+        // Note: an omitted bound is nil
+        if (expr.m_index) compile(expr.m_index);
+        else emit(OpCode::Nil);
+        if (expr.m_end) compile(expr.m_end);
+        else emit(OpCode::Nil);
+        emit(OpCode::Slice);
+        return LukObject();
+    }
+    compile(expr.m_index);
+    emit(OpCode::GetItem);
+
+    return LukObject();
+}
+
+LukObject Compiler::visitInterpolateExpr(InterpolateExpr& expr) {
+    for (auto& arg: expr.m_args) {
+        compile(arg);
+    }
+    emit(OpCode::Interpolate);
+    emitShort(expr.m_args.size());
+
+    return LukObject();
+}
+
+LukObject Compiler::visitInvokeExpr(InvokeExpr& expr) {
+    compile(expr.m_object);
+    if (expr.m_args.size() > 0xff) error("Cannot have more than 255 arguments.");
+    // Note: keywords are set on a callable, so the method is bound like a get expression
+    if (!expr.m_keywords.empty()) {
+        emit(OpCode::GetProperty);
+        emitToken(expr.m_name);
+        emitCache(expr.m_cache);
+        emit(OpCode::CheckCallable);
+        emitToken(expr.m_paren);
+        KeywordsProto keywords;
+        for (auto& arg: expr.m_args) {
+            compile(arg);
+        }
+        for (auto& iter: expr.m_keywords) {
+            compile(iter.second);
+            keywords.m_names.push_back(iter.first);
+        }
+        emit(OpCode::CallKeywords);
+        emitByte(uint8_t(expr.m_args.size()));
+        emitToken(expr.m_paren);
+        emitShort(p_chunk->addKeywords(keywords));
+        return LukObject();
+    }
+
+    emit(OpCode::GetMethod);
+    emitToken(expr.m_name);
+    emitToken(expr.m_paren);
+    emitCache(expr.m_cache);
+    for (auto& arg: expr.m_args) {
+        compile(arg);
+    }
+    emit(OpCode::Invoke);
+    emitByte(uint8_t(expr.m_args.size()));
+
+    return LukObject();
+}
+
+LukObject Compiler::visitListExpr(ListExpr& expr) {
+    for (auto& item: expr.m_items) {
+        compile(item);
+    }
+    emit(OpCode::BuildList);
+    emitShort(expr.m_items.size());
+
+    return LukObject();
+}
+
+LukObject Compiler::visitLiteralExpr(LiteralExpr& expr) {
+    const LukObject& val = expr.m_value;
+    if (val.isNil()) emit(OpCode::Nil);
+    else if (val.isBool()) emit(val.getBool() ? OpCode::True : OpCode::False);
+    else emitConstant(val);
+
+    return LukObject();
+}
+
+LukObject Compiler::visitLogicalExpr(LogicalExpr& expr) {
+    compile(expr.m_left);
+    // Note: the left operand is kept whether it decides the result
+    size_t endJump = emitJump(expr.m_op->type == TokenType::OR ?
+            OpCode::JumpIfTrue : OpCode::JumpIfFalse);
+    emit(OpCode::Pop);
+    compile(expr.m_right);
+    patchJump(endJump);
+
+    return LukObject();
+}
+
+LukObject Compiler::visitMapExpr(MapExpr& expr) {
+    for (auto& entry: expr.m_entries) {
+        compile(entry.first);
+        compile(entry.second);
+    }
+    emit(OpCode::BuildMap);
+    emitShort(expr.m_entries.size());
+    emitToken(expr.m_brace);
+
+    return LukObject();
+}
+
+LukObject Compiler::visitSetExpr(SetExpr& expr) {
+    compile(expr.m_object);
+    compile(expr.m_value);
+    emit(OpCode::SetProperty);
+    emitToken(expr.m_name);
+    emitCache(expr.m_cache);
+
+    return LukObject();
+}
+
+LukObject Compiler::visitSetIndexExpr(SetIndexExpr& expr) {
+    compile(expr.m_object);
+    compile(expr.m_index);
+    compile(expr.m_value);
+    emit(OpCode::SetItem);
+    emitToken(expr.m_equals);
+
+    return LukObject();
+}
+
+LukObject Compiler::visitSuperExpr(SuperExpr& expr) {
+    if (expr.m_depth < 0) {
+        emit(OpCode::Nil);
+        return LukObject();
+    }
+    emit(OpCode::GetSuper);
+    emitByte(uint8_t(expr.m_depth));
+    emitShort(expr.m_slot);
+    emitByte(uint8_t(expr.m_thisDepth));
+    emitToken(expr.m_method);
+    emitCache(expr.m_cache);
+
+    return LukObject();
+}
+
+LukObject Compiler::visitTernaryExpr(TernaryExpr& expr) {
+    compile(expr.m_condition);
+    size_t elseJump = emitJump(OpCode::PopJumpIfFalse);
+    compile(expr.m_thenBranch);
+    size_t endJump = emitJump(OpCode::Jump);
+    patchJump(elseJump);
+    compile(expr.m_elseBranch);
+    patchJump(endJump);
+
+    return LukObject();
+}
+
+LukObject Compiler::visitThisExpr(ThisExpr& expr) {
+    emitGetVariable(expr.m_keyword, expr);
+    return LukObject();
+}
+
+LukObject Compiler::visitUnaryExpr(UnaryExpr& expr) {
+    compile(expr.m_right);
+    auto type = expr.m_op->type;
+    if (type == TokenType::MINUS_MINUS || type == TokenType::PLUS_PLUS) {
+        if (!expr.m_right->isVariableExpr()) {
+            emit(OpCode::Error);
+            emitToken(expr.m_op);
+            emitShort(p_chunk->addConstant(LukObject(type == TokenType::MINUS_MINUS ?
+                    "Operand of a decrement operator must be a variable." :
+                    "Operand of a increment operator must be a variable.")));
+            return LukObject();
+        }
+        // Note: postfix operator keeps the old value as result
+        if (expr.m_isPostfix) emit(OpCode::Dup);
+        emit(OpCode::Unary);
+        emitToken(expr.m_op);
+        auto name = expr.m_right->getName();
+        emitSetVariable(name, *expr.m_right);
+        if (expr.m_isPostfix) emit(OpCode::Pop);
+        return LukObject();
+    }
+
+    if (type == TokenType::BANG) {
+        emit(OpCode::Not);
+    } else {
+        emit(OpCode::Unary);
+        emitToken(expr.m_op);
+    }
+
+    return LukObject();
+}
+
+LukObject Compiler::visitVariableExpr(VariableExpr& expr) {
+    emitGetVariable(expr.m_name, expr);
+    return LukObject();
+}
+
+// statements
+void Compiler::visitBlockStmt(BlockStmt& stmt) {
+    emit(OpCode::PushEnv);
+    m_envDepth++;
+    for (auto& st: stmt.m_statements) {
+        if (st) compile(st);
+    }
+    m_envDepth--;
+    emit(OpCode::EndBlock);
+}
+
+void Compiler::visitBreakStmt(BreakStmt& stmt) {
+    // Note: the resolver has already checked that the statement is inside a loop
+    if (m_loops.empty()) return;
+    auto& loop = m_loops.back();
+    emitEnvPops(loop.m_envDepth);
+    if (stmt.m_keyword->type == TokenType::BREAK) {
+        loop.m_breakJumps.push_back(emitJump(OpCode::Jump));
+    } else if (loop.m_continue >= 0) {
+        emitLoop(loop.m_continue);
+    } else {
+        loop.m_continueJumps.push_back(emitJump(OpCode::Jump));
+    }
+}
+
+void Compiler::visitClassStmt(ClassStmt& stmt) {
+    size_t index = p_chunk->addClass(&stmt);
+    if (stmt.m_superclass != nullptr) {
+        compile(stmt.m_superclass);
+        emit(OpCode::Inherit);
+        emitShort(index);
+    }
+
+    emit(OpCode::Nil);
+    emitDefineVariable(stmt.m_name, stmt.m_slot);
+
+    if (stmt.m_superclass != nullptr) {
+        // "super" is the first slot of the environment enclosing the methods
+        emit(OpCode::PushEnv);
+        emit(OpCode::DefineLocal);
+        emitShort(0);
+    }
+
+    // static variables initializers are pushed in order
+    for (auto& it: stmt.m_vars) {
+        if (it.second != nullptr) compile(it.second);
+        else emit(OpCode::Nil);
+    }
+    for (auto& meth: stmt.m_classMethods) {
+        compileFunction(*meth->m_function);
+    }
+    for (auto& meth: stmt.m_methods) {
+        compileFunction(*meth->m_function);
+    }
+    emit(OpCode::Class);
+    emitShort(index);
+
+    if (stmt.m_superclass != nullptr) {
+        emit(OpCode::PopEnv);
+    }
+    emitDefineVariable(stmt.m_name, stmt.m_slot);
+}
+
+void Compiler::visitExpressionStmt(ExpressionStmt& stmt) {
+    compile(stmt.m_expression);
+    emit(OpCode::ExprResult);
+}
+
+void Compiler::visitFunctionStmt(FunctionStmt& stmt) {
+    compileClosure(std::string(stmt.m_name->lexeme), stmt.m_function);
+    emitDefineVariable(stmt.m_name, stmt.m_slot);
+}
+
+void Compiler::visitIfStmt(IfStmt& stmt) {
+    compile(stmt.m_condition);
+    size_t elseJump = emitJump(OpCode::PopJumpIfFalse);
+    compile(stmt.m_thenBranch);
+    if (stmt.m_elseBranch == nullptr) {
+        patchJump(elseJump);
+        return;
+    }
+    size_t endJump = emitJump(OpCode::Jump);
+    patchJump(elseJump);
+    compile(stmt.m_elseBranch);
+    patchJump(endJump);
+}
+
+void Compiler::visitPrintStmt(PrintStmt& stmt) {
+    for (auto& arg: stmt.m_args) {
+        compile(arg);
+    }
+    emit(OpCode::Print);
+    emitShort(stmt.m_args.size());
+}
+
+void Compiler::visitReturnStmt(ReturnStmt& stmt) {
+    if (stmt.m_value != nullptr) compile(stmt.m_value);
+    else emit(OpCode::Nil);
+    emit(OpCode::Return);
+}
+
+void Compiler::visitVarStmt(VarStmt& stmt) {
+    for (size_t i=0; i < stmt.m_vars.size(); ++i) {
+        auto& name = stmt.m_vars[i].first;
+        auto& initializer = stmt.m_vars[i].second;
+        if (initializer != nullptr) compile(initializer);
+        else emit(OpCode::Nil);
+        emitDefineVariable(name, i < stmt.m_slots.size() ? stmt.m_slots[i] : -1);
+    }
+}
+
+/// Note: the iterable and the position stay on the stack during the loop,
+/// the ForIn instruction updates the position in place and stores the value in the loop variable.
+void Compiler::visitForInStmt(ForInStmt& stmt) {
+    compile(stmt.m_iterable);
+    emit(OpCode::ForPrep);
+    emitToken(stmt.m_keyword);
+    emit(OpCode::PushEnv);
+    m_envDepth++;
+    emit(OpCode::Nil);
+    emitDefineVariable(stmt.m_name, stmt.m_slot);
+
+    LoopState loop;
+    loop.m_start = p_chunk->size();
+    loop.m_envDepth = m_envDepth;
+    loop.m_continue = int(loop.m_start);
+    m_loops.push_back(loop);
+
+    emit(OpCode::ForIn);
+    emitShort(stmt.m_slot);
+    p_chunk->writeShort(0xffff);
+    size_t exitJump = p_chunk->size() -2;
+    compile(stmt.m_body);
+    emitLoop(loop.m_start);
+    patchJump(exitJump);
+
+    for (auto offset: m_loops.back().m_breakJumps) {
+        patchJump(offset);
+    }
+    m_loops.pop_back();
+    m_envDepth--;
+    emit(OpCode::EndBlock);
+    // the position and the iterable
+    emit(OpCode::Pop);
+    emit(OpCode::Pop);
+}
+
+void Compiler::visitWhileStmt(WhileStmt& stmt) {
+    LoopState loop;
+    loop.m_start = p_chunk->size();
+    loop.m_envDepth = m_envDepth;
+    // Note: the do-while loop executes its body before testing the condition,
+    // so its continue target is known only after the body.
+    loop.m_continue = stmt.m_isWhile ? int(loop.m_start) : -1;
+    m_loops.push_back(loop);
+
+    size_t exitJump =0;
+    if (stmt.m_isWhile) {
+        if (stmt.m_condition != nullptr) compile(stmt.m_condition);
+        else emit(OpCode::True);
+        exitJump = emitJump(OpCode::PopJumpIfFalse);
+        compile(stmt.m_body);
+        emitLoop(loop.m_start);
+    } else {
+        compile(stmt.m_body);
+        for (auto offset: m_loops.back().m_continueJumps) {
+            patchJump(offset);
+        }
+        if (stmt.m_condition != nullptr) compile(stmt.m_condition);
+        else emit(OpCode::True);
+        exitJump = emitJump(OpCode::PopJumpIfFalse);
+        emitLoop(loop.m_start);
+    }
+    patchJump(exitJump);
+
+    for (auto offset: m_loops.back().m_breakJumps) {
+        patchJump(offset);
+    }
+    m_loops.pop_back();
+}
@@ -0,0 +1,107 @@
+#ifndef COMPILER_HPP
+#define COMPILER_HPP
+
+#include "common.hpp"
+#include "expr.hpp"
+#include "stmt.hpp"
+#include "chunk.hpp"
+#include "lukerror.hpp"
+#include "logger.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace luky {
+    /// Note: the compiler walks the resolved AST once, and emits the bytecode for the VM.
+    /// Variables keep the (depth, slot) locations assigned by the resolver,
+    /// so the VM uses the same environments as the tree-walking interpreter.
+    /// Function bodies are compiled in their own chunk, stored on their declaration.
+    class Compiler : public ExprVisitor,  public StmtVisitor {
+    public:
+        explicit Compiler(LukError& lukErr);
+        ~Compiler() {
+          LOG_MSG(cat_INTERP, "\n~Compiler destructor");
+        }
+
+        std::shared_ptr<Chunk> compile(std::vector<StmtPtr>& statements);
+
+        // expressions
+        LukObject visitAssignExpr(AssignExpr& expr) override;
+        LukObject visitBinaryExpr(BinaryExpr& expr) override;
+        LukObject visitCallExpr(CallExpr& expr) override;
+        LukObject visitFunctionExpr(FunctionExpr& expr) override;
+        LukObject visitGetExpr(GetExpr& expr) override;
+        LukObject visitGroupingExpr(GroupingExpr& expr) override;
+        LukObject visitIndexExpr(IndexExpr& expr) override;
+        LukObject visitInterpolateExpr(InterpolateExpr& expr) override;
+        LukObject visitInvokeExpr(InvokeExpr& expr) override;
+        LukObject visitListExpr(ListExpr& expr) override;
+        LukObject visitLiteralExpr(LiteralExpr& expr) override;
+        LukObject visitLogicalExpr(LogicalExpr& expr) override;
+        LukObject visitMapExpr(MapExpr& expr) override;
+        LukObject visitSetExpr(SetExpr& expr) override;
+        LukObject visitSetIndexExpr(SetIndexExpr& expr) override;
+        LukObject visitSuperExpr(SuperExpr& expr) override;
+        LukObject visitTernaryExpr(TernaryExpr& expr) override;
+        LukObject visitThisExpr(ThisExpr& expr) override;
+        LukObject visitUnaryExpr(UnaryExpr& expr) override;
+        LukObject visitVariableExpr(VariableExpr& expr) override;
+
+        // statements
+        void visitBlockStmt(BlockStmt& stmt) override;
+        void visitBreakStmt(BreakStmt& stmt) override;
+        void visitClassStmt(ClassStmt& stmt) override;
+        void visitExpressionStmt(ExpressionStmt& stmt) override;
+        void visitForInStmt(ForInStmt& stmt) override;
+        void visitFunctionStmt(FunctionStmt& stmt) override;
+        void visitIfStmt(IfStmt& stmt) override;
+        void visitPrintStmt(PrintStmt& stmt) override;
+        void visitReturnStmt(ReturnStmt& stmt) override;
+        void visitVarStmt(VarStmt& stmt) override;
+        void visitWhileStmt(WhileStmt& stmt) override;
+
+    private:
+        // jumps of a loop, patched when the loop is finished
+        struct LoopState {
+            size_t m_start;
+            // -1 whether the continue target is not yet known (do-while loop)
+            int m_continue;
+            // number of environments pushed at the start of the loop
+            int m_envDepth;
+            std::vector<size_t> m_breakJumps;
+            std::vector<size_t> m_continueJumps;
+        };
+
+        LukError& m_lukErr;
+        Chunk* p_chunk = nullptr;
+        std::vector<LoopState> m_loops;
+        // number of block environments pushed in the current chunk
+        int m_envDepth =0;
+        const std::string m_errTitle = "CompileError: ";
+
+        void compile(ExprPtr expr);
+        void compile(StmtPtr& stmt);
+        void compileFunction(FunctionExpr& func);
+        void compileClosure(const std::string& name, std::shared_ptr<FunctionExpr> func);
+
+        // emitters
+        void emit(OpCode op) { p_chunk->write(op); }
+        void emitByte(uint8_t byte) { p_chunk->write(byte); }
+        void emitShort(size_t val);
+        void emitToken(const TokPtr& tok) { emitShort(p_chunk->addToken(tok)); }
+        void emitCache(InlineCache& cache) { emitShort(p_chunk->addCache(&cache)); }
+        void emitConstant(const LukObject& val);
+        size_t emitJump(OpCode op);
+        void patchJump(size_t offset);
+        void emitLoop(size_t start);
+        void emitEnvPops(int depth);
+        void emitGetVariable(TokPtr& name, Expr& expr);
+        void emitSetVariable(TokPtr& name, Expr& expr);
+        void emitDefineVariable(TokPtr& name, int slot);
+        void error(const std::string& msg);
+
+    };
+}
+
+#endif // COMPILER_HPP
@@ -9,8 +9,8 @@ using namespace luky;
 
 // static variable must be initialized
 int Environment::next_id;
-ObjPtr& Environment::get(TokPtr& name) {
-    auto iter = m_values.find(name->lexeme);
+LukObject& Environment::get(TokPtr& name) {
+    auto iter = m_values.find(name->symbol);
     if (iter != m_values.end()) {
         return iter->second;
     }
@@ -20,12 +20,13 @@ ObjPtr& Environment::get(TokPtr& name) {
     }
 
     throw RuntimeError(name, 
-            "Undefined variable '" + name->lexeme + "'");
+            "Undefined variable '" + std::string(name->lexeme) + "'");
 }
 
-void Environment::assign(TokPtr& name, ObjPtr& val) {
-    if ( m_values.find(name->lexeme) != m_values.end() ) {
-        m_values[name->lexeme] = val; // std::make_shared<TObject>(val;
+void Environment::assign(TokPtr& name, const LukObject& val) {
+    auto iter = m_values.find(name->symbol);
+    if (iter != m_values.end()) {
+        iter->second = val;
         return;
     }
 
@@ -35,23 +36,22 @@ void Environment::assign(TokPtr& name, ObjPtr& val) {
     }
 
     throw RuntimeError(name, 
-            "Undefined variable '" + name->lexeme + "'");
+            "Undefined variable '" + std::string(name->lexeme) + "'");
 
 }
 
-void Environment::assign(TokPtr& name, std::shared_ptr<LukCallable> callable) {
-  ObjPtr objP = std::make_shared<LukObject>(callable);
-  assign(name, objP); // LukObject(callable));
+void Environment::assign(TokPtr& name, LukRef<LukCallable> callable) {
+  assign(name, LukObject(callable));
 
 }
 
-void Environment::define(const std::string& name, ObjPtr val) {
+void Environment::define(Symbol name, const LukObject& val) {
     m_values[name] =  val;
 }
 
-ObjPtr Environment::getAt(int distance, const std::string& name) {
+LukObject& Environment::getAt(int distance, const std::string& name) {
   auto& values = ancestor(distance)->m_values;
-  auto iter = values.find(name);
+  auto iter = values.find(intern(name));
   if (iter == values.end()) {
     std::ostringstream msg;
     msg << "Undefined variable '" << name << "' at distance: " << distance;
@@ -71,7 +71,36 @@ Environment* Environment::ancestor(int distance) {
   return env;
 }
 
-void Environment::assignAt(int distance, TokPtr& name, ObjPtr& val) {
-  ancestor(distance)->m_values[name->lexeme] = val;
+void Environment::assignAt(int distance, TokPtr& name, const LukObject& val) {
+  ancestor(distance)->m_values[name->symbol] = val;
+
+}
+
+void Environment::traverse(GcVisitor& visitor) {
+    visitor.visit(m_enclosing);
+    for (auto& iter: m_values) visitor.visit(iter.second);
+    for (auto& val: m_slots) visitor.visit(val);
+}
+
+void Environment::clearRefs() {
+    m_enclosing.reset();
+    m_values.clear();
+    m_slots.clear();
+}
+
+void Environment::defineSlot(int slot, const LukObject& val) {
+  // Note: slots can be defined out of order, whether a declaration has been skipped
+  if (slot >= (int)m_slots.size()) m_slots.resize(slot +1);
+  m_slots[slot] = val;
+}
+
+LukObject& Environment::getAt(int distance, int slot) {
+  auto env = ancestor(distance);
+  if (slot >= (int)env->m_slots.size()) {
+    std::ostringstream msg;
+    msg << "Undefined variable at distance: " << distance << ", slot: " << slot;
+    throw RuntimeError(msg.str());
+  }
 
+  return env->m_slots[slot];
 }
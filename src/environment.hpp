@@ -4,10 +4,12 @@
 #include "common.hpp"
 #include "token.hpp"
 #include "lukobject.hpp"
+#include "lukgc.hpp"
 #include "logger.hpp"
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <memory> // smart pointers
 
 namespace luky {
@@ -17,7 +19,9 @@ namespace luky {
     // class CTracer;
 
 
-    class Environment {
+    /// Note: environments are tracked by the cycle collector,
+    /// a closure stored in a variable of the environment it captures is a cycle.
+    class Environment : public GcObject, public std::enable_shared_from_this<Environment> {
     protected:
         static int next_id;
     public:
@@ -28,22 +32,23 @@ namespace luky {
         Environment() 
         : m_id(++next_id) { 
             m_enclosing = nullptr;
-            setName();
+            // Note: the name is only used for logging, building it on each function call is expensive
+            if (LOG_ENABLED(cat_ENV)) setName();
             // DEBUG_MSG("Ceci est un debug message.");
             // std::cerr << "Env: ctor, " << m_name << "\n"; 
-            logMsg("\nIn Environment constructor, name: ", m_name);
+            LOG_MSG(cat_ENV, "\nIn Environment constructor, name: ", m_name);
         }
         
         explicit Environment(EnvPtr encl)
             : m_id(++next_id), m_enclosing(encl) {
-                setName();
+                if (LOG_ENABLED(cat_ENV)) setName();
                 // std::cerr << "Env: copy ctor: " << m_name << "\n"; 
-                logMsg("\nIn Environment copy constructor, name: ", m_name);
+                LOG_MSG(cat_ENV, "\nIn Environment copy constructor, name: ", m_name);
                 // DEBUG_PRINT("Env: copy ctor: %s", m_name.c_str());
         }
         
         ~Environment() {
-          logMsg("\n~Environment destructor, name: ", m_name, ", size: ", size());
+          LOG_MSG(cat_ENV, "\n~Environment destructor, name: ", m_name, ", size: ", size());
         }
 
          // get the address of object
@@ -58,21 +63,35 @@ namespace luky {
             return m_name = "id: " + std::to_string(m_id) + ", (" + addressOf() + ")";
         }
 
-        size_t size() {  return m_values.size(); }
+        size_t size() {  return m_values.size() + m_slots.size(); }
+
+        // cycle collector
+        void traverse(GcVisitor& visitor) override;
+        void clearRefs() override;
+        size_t gcOwners() const override { return weak_from_this().use_count(); }
         auto& getValues() { return m_values; }
 
-        ObjPtr& get(TokPtr& name);
+        LukObject& get(TokPtr& name);
         
-        void assign(TokPtr& name, ObjPtr& val);
-        void assign(TokPtr& name, std::shared_ptr<LukCallable> callable);
+        void assign(TokPtr& name, const LukObject& val);
+        void assign(TokPtr& name, LukRef<LukCallable> callable);
 
-        void define(const std::string& name, ObjPtr val);
-        ObjPtr getAt(int distance, const std::string& name);
+        void define(Symbol name, const LukObject& val);
+        void define(const std::string& name, const LukObject& val) { define(intern(name), val); }
+        LukObject& getAt(int distance, const std::string& name);
         Environment* ancestor(int distance);
-        void assignAt(int distance, TokPtr& name, ObjPtr& val);
+        void assignAt(int distance, TokPtr& name, const LukObject& val);
+
+        // local variables, accessed by the slot assigned by the resolver
+        void defineSlot(int slot, const LukObject& val);
+        LukObject& getAt(int distance, int slot);
+        void assignAt(int distance, int slot, const LukObject& val) { getAt(distance, slot) = val; }
 
     private:
-        std::unordered_map<std::string, ObjPtr> m_values = {};
+        // Note: only globals variables are stored by name, keyed by their symbol,
+        // locals variables are stored in a flat array, without hashing.
+        std::unordered_map<Symbol, LukObject> m_values = {};
+        std::vector<LukObject> m_slots = {};
 
     };
 }
@@ -2,8 +2,11 @@
 #define EXPR_HPP
 #include "common.hpp"
 #include "lukobject.hpp"
+#include "inlinecache.hpp"
 #include "token.hpp"
+#include <cstdint> // uint8_t
 #include <memory>
+#include <utility> // pair
 #include <vector>
 #include <map>
 
@@ -15,15 +18,21 @@ namespace luky {
     class FunctionExpr;
     class GetExpr;
     class GroupingExpr;
+    class IndexExpr;
     class InterpolateExpr;
+    class InvokeExpr;
+    class ListExpr;
     class LiteralExpr;
     class LogicalExpr;
+    class MapExpr;
     class SetExpr;
+    class SetIndexExpr;
     class SuperExpr;
     class TernaryExpr;
     class ThisExpr;
     class UnaryExpr;
     class VariableExpr;
+    class Chunk;
 
     // using ExprPtr = std::shared_ptr<Expr>;
     // using StmtPtr = std::shared_ptr<Stmt>;
@@ -31,21 +40,26 @@ namespace luky {
     // create visitor object
     class ExprVisitor {
         public:
-            virtual ObjPtr visitAssignExpr(AssignExpr&) =0;
-            virtual ObjPtr visitBinaryExpr(BinaryExpr&) =0;
-            virtual ObjPtr visitCallExpr(CallExpr&) =0;
-            virtual ObjPtr visitFunctionExpr(FunctionExpr&) =0;
-            virtual ObjPtr visitGetExpr(GetExpr&) =0;
-            virtual ObjPtr visitGroupingExpr(GroupingExpr&) =0;
-            virtual ObjPtr visitInterpolateExpr(InterpolateExpr&) =0;
-            virtual ObjPtr visitLiteralExpr(LiteralExpr&) =0;
-            virtual ObjPtr visitLogicalExpr(LogicalExpr&) =0;
-            virtual ObjPtr visitSetExpr(SetExpr&) =0;
-            virtual ObjPtr visitSuperExpr(SuperExpr&) =0;
-            virtual ObjPtr visitTernaryExpr(TernaryExpr&) =0;
-            virtual ObjPtr visitThisExpr(ThisExpr&) =0;
-            virtual ObjPtr visitUnaryExpr(UnaryExpr&) =0;
-            virtual ObjPtr visitVariableExpr(VariableExpr&) =0;
+            virtual LukObject visitAssignExpr(AssignExpr&) =0;
+            virtual LukObject visitBinaryExpr(BinaryExpr&) =0;
+            virtual LukObject visitCallExpr(CallExpr&) =0;
+            virtual LukObject visitFunctionExpr(FunctionExpr&) =0;
+            virtual LukObject visitGetExpr(GetExpr&) =0;
+            virtual LukObject visitGroupingExpr(GroupingExpr&) =0;
+            virtual LukObject visitIndexExpr(IndexExpr&) =0;
+            virtual LukObject visitInterpolateExpr(InterpolateExpr&) =0;
+            virtual LukObject visitInvokeExpr(InvokeExpr&) =0;
+            virtual LukObject visitListExpr(ListExpr&) =0;
+            virtual LukObject visitLiteralExpr(LiteralExpr&) =0;
+            virtual LukObject visitLogicalExpr(LogicalExpr&) =0;
+            virtual LukObject visitMapExpr(MapExpr&) =0;
+            virtual LukObject visitSetExpr(SetExpr&) =0;
+            virtual LukObject visitSetIndexExpr(SetIndexExpr&) =0;
+            virtual LukObject visitSuperExpr(SuperExpr&) =0;
+            virtual LukObject visitTernaryExpr(TernaryExpr&) =0;
+            virtual LukObject visitThisExpr(ThisExpr&) =0;
+            virtual LukObject visitUnaryExpr(UnaryExpr&) =0;
+            virtual LukObject visitVariableExpr(VariableExpr&) =0;
     };
 
     // Base class for different objects
@@ -57,22 +71,30 @@ namespace luky {
           m_id = next_id;
         }
         
-        virtual ObjPtr accept(ExprVisitor &v) =0;
+        virtual LukObject accept(ExprVisitor &v) =0;
         virtual bool isAssignExpr() const { return false; }
         virtual bool isCallExpr() const { return false; }
         virtual bool isFunctionExpr() const { return false; }
         virtual bool isGetExpr() const { return false; }
+        virtual bool isIndexExpr() const { return false; }
+        virtual bool isLiteralExpr() const { return false; }
         virtual bool isSetExpr() const { return false; }
         virtual bool isVariableExpr() const { return false; }
         // Note: the two folowing virtual func must be implemented
         // in callexpr, variableexpr, getexpr, setexpr objects.
         virtual std::string typeName() const { return "Expr"; }
         // TODO: will better to returns static TokPtr
-        virtual TokPtr getName() const { return std::make_shared<Token>(); }
+        virtual TokPtr getName() const { static Token none; return &none; }
         virtual ExprPtr getObject() const { return nullptr; }
 
         virtual unsigned id() const { return m_id; }
 
+        // Note: location of the variable assigned by the resolver,
+        // depth is the number of environments to walk, and slot is the index in this environment.
+        // depth -1 means the variable is global, and must be searched by name.
+        int m_depth = -1;
+        int m_slot = -1;
+
     private:
       unsigned m_id;
 
@@ -88,7 +110,7 @@ namespace luky {
             m_value(std::move(value))
             {}
         
-        ObjPtr accept(ExprVisitor &v) override {
+        LukObject accept(ExprVisitor &v) override {
             return v.visitAssignExpr(*this); 
         }
         bool isAssignExpr() const override { return true; }
@@ -103,6 +125,22 @@ namespace luky {
     };
 
 
+    /// Note: specialization of a binary or unary node for the operand types it has seen,
+    /// the interpreter rewrites the node at its first evaluation.
+    /// A specialized operation runs while its guard on the operand types holds,
+    /// otherwise the node goes back to the generic operation, and is specialized again,
+    /// after MaxQuickMisses failed guards, the node stays generic.
+    enum class QuickOp : uint8_t {
+        Uninit, Generic,
+        IntAdd, IntSub, IntMul, IntMod,
+        IntLess, IntLessEqual, IntGreater, IntGreaterEqual, IntEqual, IntNotEqual,
+        DoubleAdd, DoubleSub, DoubleMul, DoubleDiv,
+        DoubleLess, DoubleLessEqual, DoubleGreater, DoubleGreaterEqual,
+        StrConcat, StrEqual,
+        IntNeg, DoubleNeg, BoolNot
+    };
+    constexpr uint8_t MaxQuickMisses = 4;
+
     class BinaryExpr : public Expr {
     public:
         BinaryExpr(ExprPtr& left, TokPtr& op, ExprPtr& right) :
@@ -111,13 +149,15 @@ namespace luky {
             m_right(std::move(right))
         {}
         
-        ObjPtr accept(ExprVisitor &v) override {
+        LukObject accept(ExprVisitor &v) override {
             return v.visitBinaryExpr(*this); 
         }
 
         ExprPtr m_left;
         TokPtr m_op;
         ExprPtr m_right;
+        QuickOp m_quick = QuickOp::Uninit;
+        uint8_t m_misses =0;
     };
 
     class CallExpr : public Expr {
@@ -129,7 +169,7 @@ namespace luky {
             m_keywords(std::move(m_keywords))
         {}
         
-        ObjPtr accept(ExprVisitor &v) override {
+        LukObject accept(ExprVisitor &v) override {
             return v.visitCallExpr(*this); 
         }
 
@@ -145,18 +185,27 @@ namespace luky {
 
     class FunctionExpr : public Expr {
     public:
-        FunctionExpr(std::vector<TokPtr>& params, std::vector<StmtPtr>& body) :
+        FunctionExpr(std::vector<TokPtr>& params, std::vector<StmtPtr>& body, SourcePtr source) :
             m_params(std::move(params)),
-            m_body(std::move(body))
+            m_body(std::move(body)),
+            p_source(std::move(source))
         {}
         
 
-        ObjPtr accept(ExprVisitor& v) override {
+        LukObject accept(ExprVisitor& v) override {
             return v.visitFunctionExpr(*this);
         }
+        bool isFunctionExpr() const override { return true; }
         
         std::vector<TokPtr> m_params;
         std::vector<StmtPtr> m_body;
+        // bytecode of the body, set by the compiler in VM mode
+        std::shared_ptr<Chunk> m_chunk;
+        // Note: set by the resolver, "this" is the first slot of a method's frame,
+        // before the parameters.
+        bool m_isMethod = false;
+        // Note: the source of the tokens, kept while the function lives
+        SourcePtr p_source;
 
     };
 
@@ -174,12 +223,13 @@ namespace luky {
         ExprPtr getObject() const override { return m_object; }
 
 
-        ObjPtr accept(ExprVisitor &v) override {
+        LukObject accept(ExprVisitor &v) override {
             return v.visitGetExpr(*this); 
         }
 
         ExprPtr m_object;
         TokPtr m_name;
+        InlineCache m_cache;
     };
 
     class GroupingExpr : public Expr {
@@ -188,20 +238,48 @@ namespace luky {
             m_expression(std::move(expr))
         {}
         
-        ObjPtr accept(ExprVisitor &v) override {
+        LukObject accept(ExprVisitor &v) override {
             return v.visitGroupingExpr(*this); 
         }
 
         ExprPtr m_expression;
     };
 
+    /// Note: item "object[index]", or the slice "object[index:end]" whether m_isSlice,
+    /// the bounds of a slice can be omitted, they are nullptr.
+    class IndexExpr : public Expr {
+    public:
+        IndexExpr(ExprPtr object, TokPtr& bracket, ExprPtr index, ExprPtr end, bool isSlice) :
+          m_object(std::move(object)),
+          m_bracket(bracket),
+          m_index(std::move(index)),
+          m_end(std::move(end)),
+          m_isSlice(isSlice)
+        {}
+
+        bool isIndexExpr() const override { return true; }
+        std::string typeName() const override { return "IndexExpr"; }
+        TokPtr getName() const override { return m_bracket; }
+        ExprPtr getObject() const override { return m_object; }
+
+        LukObject accept(ExprVisitor &v) override {
+            return v.visitIndexExpr(*this); 
+        }
+
+        ExprPtr m_object;
+        TokPtr m_bracket;
+        ExprPtr m_index;
+        ExprPtr m_end;
+        bool m_isSlice;
+    };
+
     class InterpolateExpr : public Expr {
     public:
         InterpolateExpr(std::vector<ExprPtr> args) :
             m_args(std::move(args))
         {}
         
-        ObjPtr accept(ExprVisitor &v) override {
+        LukObject accept(ExprVisitor &v) override {
             return v.visitInterpolateExpr(*this); 
         }
 
@@ -210,23 +288,70 @@ namespace luky {
     };
 
 
+    /// Note: method call "object.name(args)", emitted by the parser for a get followed by a call,
+    /// so the method is called with "this" in its frame, without creating a bound method.
+    class InvokeExpr : public Expr {
+    public:
+        InvokeExpr(ExprPtr object, TokPtr& name, TokPtr& paren, 
+                std::vector<ExprPtr> args, std::map<TokPtr, ExprPtr> keywords) :
+            m_object(std::move(object)),
+            m_name(name),
+            m_paren(paren),
+            m_args(std::move(args)),
+            m_keywords(std::move(keywords))
+        {}
+
+        LukObject accept(ExprVisitor &v) override {
+            return v.visitInvokeExpr(*this); 
+        }
+
+        bool isCallExpr() const override { return true; }
+        std::string typeName() const override { return "InvokeExpr"; }
+        TokPtr getName() const override { return m_paren; }
+        ExprPtr getObject() const override { return m_object; }
+
+        ExprPtr m_object;
+        TokPtr m_name;
+        TokPtr m_paren;
+        std::vector<ExprPtr> m_args;
+        std::map<TokPtr, ExprPtr> m_keywords;
+        InlineCache m_cache;
+    };
+
+    /// Note: list literal "[a, b]"
+    class ListExpr : public Expr {
+    public:
+        ListExpr(TokPtr& bracket, std::vector<ExprPtr> items) :
+            m_bracket(bracket),
+            m_items(std::move(items))
+        {}
+        
+        LukObject accept(ExprVisitor &v) override {
+            return v.visitListExpr(*this); 
+        }
+
+        TokPtr m_bracket;
+        std::vector<ExprPtr> m_items;
+    };
+
     class LiteralExpr: public Expr {
     public:
-        LiteralExpr(ObjPtr& value) :
+        LiteralExpr(const LukObject& value) :
             m_value(value) {
-            logMsg("\nLiteralExpr constructor");
-            logMsg("value->id: ", value->id);
+            LOG_MSG(cat_PARSER, "\nLiteralExpr constructor");
+            LOG_MSG(cat_PARSER, "value: ", value);
         }
 
         ~LiteralExpr() {
-            logMsg("~LiteralExpr destructor");
+            LOG_MSG(cat_PARSER, "~LiteralExpr destructor");
         }
 
-        ObjPtr accept(ExprVisitor &v) override {
+        LukObject accept(ExprVisitor &v) override {
             return v.visitLiteralExpr(*this); 
         }
+        bool isLiteralExpr() const override { return true; }
 
-        ObjPtr m_value;
+        LukObject m_value;
     };
 
     class LogicalExpr : public Expr {
@@ -237,7 +362,7 @@ namespace luky {
             m_right(std::move(right))
         {}
         
-        ObjPtr accept(ExprVisitor &v) override {
+        LukObject accept(ExprVisitor &v) override {
             return v.visitLogicalExpr(*this); 
         }
 
@@ -246,6 +371,22 @@ namespace luky {
         ExprPtr m_right;
     };
 
+    /// Note: map literal "{k: v}", the entries are in source order
+    class MapExpr : public Expr {
+    public:
+        MapExpr(TokPtr& brace, std::vector<std::pair<ExprPtr, ExprPtr>> entries) :
+            m_brace(brace),
+            m_entries(std::move(entries))
+        {}
+        
+        LukObject accept(ExprVisitor &v) override {
+            return v.visitMapExpr(*this); 
+        }
+
+        TokPtr m_brace;
+        std::vector<std::pair<ExprPtr, ExprPtr>> m_entries;
+    };
+
     class SetExpr : public Expr {
     public:
         SetExpr(ExprPtr object, TokPtr name, ExprPtr value) :
@@ -260,13 +401,41 @@ namespace luky {
         // Fix: can now an instance of shared_ptr instead unique_ptr
         ExprPtr getObject() const override { return m_object; }
 
-        ObjPtr accept(ExprVisitor &v) override {
+        LukObject accept(ExprVisitor &v) override {
             return v.visitSetExpr(*this); 
         }
 
         ExprPtr m_object;
         TokPtr m_name;
         ExprPtr m_value;
+        InlineCache m_cache;
+    };
+
+    /// Note: assignment of an item "object[index] = value",
+    /// a compound assignment updates the item in place, like a variable.
+    class SetIndexExpr : public Expr {
+    public:
+        SetIndexExpr(ExprPtr object, TokPtr bracket, ExprPtr index, TokPtr& equals, ExprPtr value) :
+          m_object(std::move(object)),
+          m_bracket(bracket),
+          m_index(std::move(index)),
+          m_equals(equals),
+          m_value(std::move(value))
+        {}
+
+        std::string typeName() const override { return "SetIndexExpr"; }
+        TokPtr getName() const override { return m_bracket; }
+        ExprPtr getObject() const override { return m_object; }
+
+        LukObject accept(ExprVisitor &v) override {
+            return v.visitSetIndexExpr(*this); 
+        }
+
+        ExprPtr m_object;
+        TokPtr m_bracket;
+        ExprPtr m_index;
+        TokPtr m_equals;
+        ExprPtr m_value;
     };
 
     class SuperExpr : public Expr {
@@ -276,12 +445,15 @@ namespace luky {
           m_method(method) 
         {}
 
-        ObjPtr accept(ExprVisitor &v) override {
+        LukObject accept(ExprVisitor &v) override {
             return v.visitSuperExpr(*this); 
         }
 
         TokPtr m_keyword;
         TokPtr m_method;
+        // depth of the method's frame holding "this"
+        int m_thisDepth = -1;
+        InlineCache m_cache;
     };
 
     class TernaryExpr : public Expr {
@@ -292,7 +464,7 @@ namespace luky {
             m_elseBranch(std::move(elseBranch))
         {}
         
-        ObjPtr accept(ExprVisitor& v) override {
+        LukObject accept(ExprVisitor& v) override {
             return v.visitTernaryExpr(*this); 
         }
 
@@ -308,7 +480,7 @@ namespace luky {
           m_keyword(keyword) 
         {}
         
-        ObjPtr accept(ExprVisitor &v) override {
+        LukObject accept(ExprVisitor &v) override {
             return v.visitThisExpr(*this); 
         }
 
@@ -322,13 +494,15 @@ namespace luky {
             m_right(std::move(right)),
             m_isPostfix(isPostfix) {}
         
-        ObjPtr accept(ExprVisitor &v) override {
+        LukObject accept(ExprVisitor &v) override {
             return v.visitUnaryExpr(*this); 
         }
 
         TokPtr m_op;
         ExprPtr m_right;
         bool m_isPostfix;
+        QuickOp m_quick = QuickOp::Uninit;
+        uint8_t m_misses =0;
     };
 
     class VariableExpr : public Expr {
@@ -337,7 +511,7 @@ namespace luky {
             m_name(name)
         {}
         
-        ObjPtr accept(ExprVisitor &v) override {
+        LukObject accept(ExprVisitor &v) override {
             return v.visitVariableExpr(*this); 
         }
         
@@ -0,0 +1,66 @@
+#include "inlinecache.hpp"
+#include "lukclass.hpp"
+
+#include <algorithm> // sort
+#include <iomanip> // setprecision
+#include <unordered_set>
+#include <vector>
+
+using namespace luky;
+
+// Note: sites registered for the statistics, a cache is registered at its first entry
+static std::unordered_set<InlineCache*>& registry() {
+    static std::unordered_set<InlineCache*> caches;
+    return caches;
+}
+
+InlineCache::~InlineCache() {
+    if (p_site != nullptr) registry().erase(this);
+}
+
+void InlineCache::add(const TokPtr& site, CacheEntry&& entry) {
+    if (p_site == nullptr) {
+        p_site = site;
+        registry().insert(this);
+    }
+    // Note: an entry invalidated by a new class version is replaced in place
+    for (int i=0; i < m_count; ++i) {
+        if (m_entries[i].p_shape == entry.p_shape && m_entries[i].m_classId == entry.m_classId) {
+            m_entries[i] = entry;
+            return;
+        }
+    }
+    if (m_count == MaxEntries) {
+        m_megamorphic = true;
+        return;
+    }
+    m_entries[m_count++] = entry;
+}
+
+std::string InlineCache::state() const {
+    if (m_megamorphic) return "megamorphic";
+    if (m_count > 1) return "polymorphic";
+    if (m_count == 1) return "monomorphic";
+    return "uninitialized";
+}
+
+void InlineCache::printStats(std::ostream& ost) {
+    std::vector<InlineCache*> caches(registry().begin(), registry().end());
+    std::sort(caches.begin(), caches.end(), [](InlineCache* a, InlineCache* b) {
+        if (a->p_site->line != b->p_site->line) return a->p_site->line < b->p_site->line;
+        return a->p_site->col < b->p_site->col;
+    });
+    auto flags = ost.flags();
+    auto precision = ost.precision();
+    ost << "Inline caches: " << caches.size() << " sites\n";
+    for (auto cache: caches) {
+        size_t total = cache->m_hits + cache->m_misses;
+        double rate = total ? 100.0 * cache->m_hits / total : 0.0;
+        ost << "  line " << cache->p_site->line << ", " << cache->p_site->lexeme
+            << ", hits: " << cache->m_hits << ", misses: " << cache->m_misses
+            << ", rate: " << std::fixed << std::setprecision(1) << rate << "%"
+            << ", " << cache->state() << "\n";
+    }
+    ost.flags(flags);
+    ost.precision(precision);
+}
@@ -0,0 +1,84 @@
+#ifndef INLINECACHE_HPP
+#define INLINECACHE_HPP
+
+#include "common.hpp"
+#include "lukheap.hpp"
+#include "lukobject.hpp"
+#include "token.hpp"
+
+#include <cstdint> // uint32_t, uint64_t
+#include <iostream>
+
+namespace luky {
+    class LukClass;
+    class LukShape;
+
+    /// Note: result of a property lookup, for a given shape and class.
+    /// The entry keeps the id of the class, not a reference to it,
+    /// so a call site does not keep alive the classes it has seen, nor their methods.
+    /// Ids are never reused, so an entry cannot match another class allocated at the same address.
+    struct CacheEntry {
+        LukShape* p_shape = nullptr;
+        // id of the class, 0 whether the lookup does not depend on a class
+        uint64_t m_classId =0;
+        // version of the class when the entry was filled
+        uint32_t m_version =0;
+        // slot of the field, -1 whether the member is a method of the class
+        int m_slot = -1;
+        // whether the method must be called with the instance as "this"
+        bool m_isMethod = false;
+        // for a set, the shape after adding the field, nullptr whether the field exists
+        LukShape* p_next = nullptr;
+        // Note: the method, owned by the class or one of its superclasses,
+        // valid while the class id and its version match, nullptr for a member not found
+        const LukObject* p_method = nullptr;
+    };
+
+    /// Note: inline cache attached to a property access site in the AST,
+    /// the tree-walking interpreter and the VM share the cache of the same site.
+    /// It remembers up to MaxEntries (shape, class) pairs,
+    /// after that, the site is megamorphic, and the lookup is no longer cached.
+    /// An entry is valid while the version of its class is unchanged.
+    class InlineCache {
+    public:
+        static constexpr int MaxEntries = 4;
+
+        InlineCache() {}
+        // Note: a copied expression gets its own empty cache
+        InlineCache(const InlineCache&) {}
+        InlineCache& operator=(const InlineCache&) { return *this; }
+        ~InlineCache();
+
+        CacheEntry* find(const LukShape* shape, uint64_t classId, uint32_t version) {
+            for (int i=0; i < m_count; ++i) {
+                auto& entry = m_entries[i];
+                if (entry.p_shape == shape && entry.m_classId == classId
+                        && entry.m_version == version) {
+                    ++m_hits;
+                    return &entry;
+                }
+            }
+            ++m_misses;
+            return nullptr;
+        }
+
+        // Note: site is the token reported by the statistics
+        void add(const TokPtr& site, CacheEntry&& entry);
+        bool isMegamorphic() const { return m_megamorphic; }
+        std::string state() const;
+
+        // prints the hit rate of each site used
+        static void printStats(std::ostream& ost);
+
+    private:
+        CacheEntry m_entries[MaxEntries];
+        int m_count =0;
+        bool m_megamorphic = false;
+        size_t m_hits =0;
+        size_t m_misses =0;
+        // Note: set when the site is registered for the statistics
+        TokPtr p_site = nullptr;
+    };
+}
+
+#endif // INLINECACHE_HPP
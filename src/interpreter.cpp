@@ -1,13 +1,19 @@
 #include "interpreter.hpp"
 #include "lukerror.hpp"
 #include "runtimeerror.hpp"
-#include "jump.hpp"
 #include "lukcallable.hpp"
 #include "builtin_func.hpp"
 #include "lukfunction.hpp"
-#include "return.hpp"
 #include "logger.hpp"
 #include "lukclass.hpp"
+#include "compiler.hpp"
+#include "lukvm.hpp"
+#include "lukgc.hpp"
+#include "lukstring.hpp"
+#include "luklist.hpp"
+#include "lukmap.hpp"
+#include "lukarray.hpp"
+#include "lukrange.hpp"
 
 #include <iostream>
 #include <string>
@@ -19,510 +25,679 @@
 using namespace luky;
 
 Interpreter::Interpreter(LukError& lukErr) : m_lukErr(lukErr) {
-    logMsg("\nIn Interpreter constructor");
-    LogConf.headers = true;
-    LogConf.level = log_DEBUG;
-    CLog(log_WARN) << "log_WARN: Test on log warning.";
-    
-    logMsg("\n--- Starts Interpreter");
-    logTest();
+    LOG_MSG(cat_INTERP, "\nIn Interpreter constructor");
+    LOG_MSG(cat_INTERP, "\n--- Starts Interpreter");
 
     m_globals = std::make_shared<Environment>();
     m_env = m_globals;
     m_globals->m_name = "Globals, " + m_globals->m_name;
-    m_result = nilptr;
+    m_result = LukObject();
+    p_vm = std::make_shared<LukVM>(*this);
 
     // TRACE_ALL;
     // TRACE_MSG("Env globals tracer: ");
     // builtins functions 
     // native clock function
     // auto clock_func = std::make_shared<ClockFunc>();
-    // m_globals->define("clock", std::make_shared<LukObject>(clock_func));
+    // m_globals->define("clock", LukObject(clock_func));
     auto blt = BuiltinFunc(m_globals);
     blt.initNative();
 
-    logMsg("\nExit out Interpreter constructor");
+    LOG_MSG(cat_INTERP, "\nExit out Interpreter constructor");
 
 }
 
 void Interpreter::interpret(std::vector<std::shared_ptr<Stmt>> statements) {
-    logMsg("\nIn Interpret, starts loop");
+    LOG_MSG(cat_INTERP, "\nIn Interpret, starts loop");
 
     if (statements.empty()) { 
         std::cerr << "Interp: vector is empty.\n";
     }
     logState();
     try {
-         for (auto& stmt : statements) {
-            if (stmt) {
-                execute((stmt));
+        if (m_vmMode) {
+            Compiler compiler(m_lukErr);
+            auto chunk = compiler.compile(statements);
+            if (m_lukErr.hadError) return;
+            runChunk(*chunk, m_globals);
+        } else {
+            for (auto& stmt : statements) {
+                if (stmt) {
+                    execute((stmt));
+                }
             }
         }
         
     // Note: passing exception by reference to avoid copy
     } catch (RuntimeError& err) {
         std::cerr << m_errTitle << err.what() << "\n";
+        // the error can occur while unwinding
+        m_completion = Completion::Normal;
     }
 
-    assert(m_result != nullptr);
-    if (m_result != nullptr && !m_result->isNil()) {
+    if (!m_result.isNil()) {
         printResult();
     }
 
     logState();
 
-  logMsg("\nExit out  Interpret");
+  LOG_MSG(cat_INTERP, "\nExit out  Interpret");
+
+}
 
+LukObject Interpreter::runChunk(Chunk& chunk, EnvPtr env) {
+    return p_vm->run(chunk, env);
 }
 
 void Interpreter::printResult() {
     // CLog(log_DEBUG) << "printResult avant \n";
     std::cout << stringify(m_result) << "\n";
     // reinitialize m_result to nil
-    m_result = nilptr;
+    m_result = LukObject();
     
 }
 
 
 void Interpreter::logState() {
-#ifdef DEBUG
-  logMsg("\nEnvironment state");
+  if (!LOG_ENABLED(cat_INTERP)) return;
+  LOG_MSG(cat_INTERP, "\nEnvironment state");
   // Note: workaround to make an alias for a variable in c++ 
   // int a; 
   // int* const b = &a;
   // b is an alias or pointer to a
   // but not work for a map
-  logMsg("Globals state");
+  LOG_MSG(cat_INTERP, "Globals state");
   auto& values = m_globals->getValues();
   // Note: Pattern: looping over map
   if (values.empty()) {
-      logMsg("m_globals env is empty");
+      LOG_MSG(cat_INTERP, "m_globals env is empty");
   } else {
       for (auto& iter: values)  {
-        logMsg(iter.first, ":", iter.second->toString());
+        LOG_MSG(cat_INTERP, symbolName(iter.first), ":", iter.second.toString());
       }
   }
 
-  logMsg("\nLocals state");
-  if (m_locals.empty()) {
-      logMsg("m_locals env is empty");
-  } else {
-      for (auto& iter: m_locals)  {
-          logMsg(iter.first, ":", iter.second);
-      }
-  
-  }
-#endif
-
 }
 
-
-void Interpreter::logTest() {
-#ifdef DEBUG
-  logMsg("\nIn logTest");
-  
-  /*
-  // ObjPtr p_obj = std::make_shared<LukObject>();
-  // ObjPtr p_obj = TObject::getNilPtr();
-  ObjPtr p_obj = nilptr;
-  // Note: cannot overloading operator= with nullptr
-  // p_obj = nullptr;
-  logMsg("p_obj: ", p_obj);
-  logMsg("p_obj->toString: ", p_obj->toString());
-  */
-
-
-
-  logMsg("\nExit out logTest");
-#endif
-}
-
-ObjPtr Interpreter::evaluate(ExprPtr expr) { 
-    logMsg("\nIn evaluate, expr: ", typeid(*expr).name());
+LukObject Interpreter::evaluate(ExprPtr expr) { 
+    LOG_MSG(cat_INTERP, "\nIn evaluate, expr: ", typeid(*expr).name());
      auto obj = expr->accept(*this);
-     if (obj == nullptr) {
-       std::cerr << "Evaluated expr " << expr->typeName() << " to nullptr \n";
-       return nilptr;
-     }
+    LOG_MSG(cat_INTERP, "Evaluating obj result after accept: ", obj.toString());
 
-    logMsg("Evaluating obj result after accept: ", obj->toString());
     return obj;
 }
 
 void Interpreter::execute(StmtPtr& stmt) {
-    logMsg("\nIn execute top level, *stmt: ", typeid(*stmt).name());
+    LOG_MSG(cat_INTERP, "\nIn execute top level, *stmt: ", typeid(*stmt).name());
+    LukGC::get().safePoint();
     stmt->accept(*this);
 }
 
-ObjPtr Interpreter::visitAssignExpr(AssignExpr& expr) {
-    logMsg("\nIn visitAssignExpr Interpreter, name:  ", expr.m_name);
-    ObjPtr value = evaluate(expr.m_value);
-    ObjPtr cur = m_env->get(expr.m_name);
-    // std::cerr << "cur: " << cur << ", value: " << value << "\n";
-    auto op = expr.m_equals;
-    /// Note: In C++, switch statement is fallthrough by default, so, you should put a
-    /// [break] keyword to indicate that statement not fallthrough.
-    switch(expr.m_equals->type) {
-      case TokenType::EQUAL: break;
-      case TokenType::PLUS_EQUAL:
-          if (cur->isNumber() && value->isNumber()) {
-              value = std::make_shared<LukObject>(*cur + *value);
-          } else if ( (value->isString() && cur->isString())  ||
-              (value->isString() && cur->isNumeric()) || 
-              (value->isNumeric() && cur->isString()) ) {
-              // Note: temporary can concatenate string with number before having number to string convertion function
-              *value = format(cur) + format(value);
-              // *value = *cur + *value;
-          }
-          else throw RuntimeError(op, 
-                  "Operands must be string and number.");
-          break;
-      
-      case TokenType::MINUS_EQUAL:
-          checkNumberOperands(op, cur, value);
-          value = std::make_shared<LukObject>(*cur - *value);
-          break;
-
-      case TokenType::STAR_EQUAL:
-          if ( (cur->isNumber()) && (value->isNumber()) ) {
-              value = std::make_shared<LukObject>(*cur * *value);
-          } else if ( cur->isString() && value->isNumber() ) { 
-              /// Note: can multiply string by number
-              if ( not value->isInt()) {
-                  throw RuntimeError(op, "String multiplier must be an integer");
-              }
-              auto str = cur->getString();
-              auto num = value->getNumber();
-               
-              *value = multiplyString(str, num);
-          } else if ( cur->isNumber() && value->isString() ) { 
-              if ( not cur->isInt()) {
-                  throw RuntimeError(op, "String multiplier must be an integer");
-              }
-              auto str = value->getString();
-              auto num = cur->getNumber();
-              
-              *value = multiplyString(str, num);
-          }
-          else throw RuntimeError(op, "Operands must be strings or numbers.");
-          break;
-
-      case TokenType::SLASH_EQUAL:
-          checkNumberOperands(op, cur, value);
-          value = std::make_shared<LukObject>(*cur / *value);
-          break;
-
-      case TokenType::MOD_EQUAL:
-          checkNumberOperands(op, cur, value);
-          value = std::make_shared<LukObject>(*cur % *value);
-          break;
-
-      case TokenType::EXP_EQUAL:
-          // Note: pow function returns double
-          // so, you must convert it to Int ingegral operands
-          checkNumberOperands(op, cur, value);
-          if ( cur->isInt() && value->isInt() &&
-                  value->getInt() >= 0 ) {
-              value = std::make_shared<LukObject>( TLukInt( std::pow( cur->getNumber(), value->getNumber())) );
-          } 
-          else value = std::make_shared<LukObject>( std::pow( cur->getNumber(), value->getNumber()) );
-          break;
-
-       // bitwise operators compound assignment
-       case TokenType::BIT_OR_EQUAL:
-            if (cur->isBoolInt() && value->isBoolInt() )
-                value = std::make_shared<LukObject>(*cur | *value);
-            else throw RuntimeError(op, "operands must be bools or integers.");
-            break;
+LukObject Interpreter::visitAssignExpr(AssignExpr& expr) {
+    LOG_MSG(cat_INTERP, "\nIn visitAssignExpr Interpreter, name:  ", expr.m_name);
+    LukObject value = evaluate(expr.m_value);
+    if (expr.m_equals->type != TokenType::EQUAL) {
+        // Note: the current value is taken at the depth resolved, not by searching the name in each environment.
+        LukObject& var = variableRef(expr.m_name, expr);
+        // compound assignment
+        compoundAssign(var, expr.m_equals, value);
+        return var;
+    }
 
-       case TokenType::BIT_AND_EQUAL:
-            if (cur->isBoolInt() && value->isBoolInt() )
-                value = std::make_shared<LukObject>(*cur & *value);
-            else throw RuntimeError(op, "operands must be bools or integers.");
-            break;
+    assignVariable(expr.m_name, expr, value);
+    
+    return value;
+}
 
-       case TokenType::BIT_XOR_EQUAL:
-            if (cur->isBoolInt() && value->isBoolInt() )
-                value = std::make_shared<LukObject>(*cur ^ *value);
-            else throw RuntimeError(op, "operands must be bools or integers.");
-            break;
+/// Note: compound assignment of a variable in place, it's used too by the bytecode VM.
+/// A string owned only by the variable is appended without copying it,
+/// so building a string with += in a loop is linear.
+void Interpreter::compoundAssign(LukObject& var, TokPtr& op, const LukObject& value) {
+    if (op->type == TokenType::PLUS_EQUAL && var.isString() && 
+            (value.isString() || value.isNumeric())) {
+        // Note: the result of the previous expression statement is replaced by this one,
+        // so it does not need to share the string.
+        if (m_result.isString() && m_result.p_heap == var.p_heap) m_result = LukObject();
+        if (var.p_heap->refCount() == 1) {
+            auto str = static_cast<LukString*>(var.p_heap);
+            if (value.isString()) str->append(value.getView());
+            else str->append(format(value));
+            return;
+        }
+    }
 
-       case TokenType::BIT_LEFT_EQUAL:
-            if (cur->isBoolInt() && value->isBoolInt() )
-                value = std::make_shared<LukObject>(*cur << *value);
-            else throw RuntimeError(op, "operands must be bools or integers.");
-            break;
+    var = binaryOp(op, var, value);
+}
 
-       case TokenType::BIT_RIGHT_EQUAL:
-            if (cur->isBoolInt() && value->isBoolInt() )
-                value = std::make_shared<LukObject>(*cur >> *value);
-            else throw RuntimeError(op, "operands must be bools or integers.");
+LukObject Interpreter::visitBinaryExpr(BinaryExpr& expr) {
+    // Note: the method .get allow to convert smart pointer to raw pointer
+    LukObject left = evaluate(expr.m_left);
+    LukObject right = evaluate(expr.m_right);
+
+    // Note: the specialized operations compute the result in place,
+    // they are the same as the generic operations for these types.
+#define QUICK_CASE(quick, guard, result) \
+        case QuickOp::quick: \
+            if (guard) return LukObject(result); \
             break;
-
-      default: break;
+    switch(expr.m_quick) {
+        QUICK_CASE(IntAdd, left.isInt() && right.isInt(), left.m_int + right.m_int)
+        QUICK_CASE(IntSub, left.isInt() && right.isInt(), left.m_int - right.m_int)
+        QUICK_CASE(IntMul, left.isInt() && right.isInt(), left.m_int * right.m_int)
+        QUICK_CASE(IntMod, left.isInt() && right.isInt() && right.m_int != 0, left.m_int % right.m_int)
+        QUICK_CASE(IntLess, left.isInt() && right.isInt(), left.m_int < right.m_int)
+        QUICK_CASE(IntLessEqual, left.isInt() && right.isInt(), left.m_int <= right.m_int)
+        QUICK_CASE(IntGreater, left.isInt() && right.isInt(), left.m_int > right.m_int)
+        QUICK_CASE(IntGreaterEqual, left.isInt() && right.isInt(), left.m_int >= right.m_int)
+        QUICK_CASE(IntEqual, left.isInt() && right.isInt(), left.m_int == right.m_int)
+        QUICK_CASE(IntNotEqual, left.isInt() && right.isInt(), left.m_int != right.m_int)
+        QUICK_CASE(DoubleAdd, left.isDouble() && right.isDouble(), left.m_double + right.m_double)
+        QUICK_CASE(DoubleSub, left.isDouble() && right.isDouble(), left.m_double - right.m_double)
+        QUICK_CASE(DoubleMul, left.isDouble() && right.isDouble(), left.m_double * right.m_double)
+        QUICK_CASE(DoubleDiv, left.isDouble() && right.isDouble(), left.m_double / right.m_double)
+        QUICK_CASE(DoubleLess, left.isDouble() && right.isDouble(), left.m_double < right.m_double)
+        // Note: like the LukObject operators, <= is "< or ==", and > is "not <=", also for NaN
+        QUICK_CASE(DoubleLessEqual, left.isDouble() && right.isDouble(), 
+                left.m_double < right.m_double || left.m_double == right.m_double)
+        QUICK_CASE(DoubleGreater, left.isDouble() && right.isDouble(), 
+                !(left.m_double < right.m_double || left.m_double == right.m_double))
+        QUICK_CASE(DoubleGreaterEqual, left.isDouble() && right.isDouble(), 
+                !(left.m_double < right.m_double))
+        QUICK_CASE(StrConcat, left.isString() && right.isString(), concatStrings(left, right))
+        QUICK_CASE(StrEqual, left.isString() && right.isString(), left == right)
+        case QuickOp::Generic:
+            return binaryOp(expr.m_op, left, right);
+        default: break;
     }
-
-    // search the variable in locals map, if not, search in the globals map.
-    auto iter = m_locals.find(expr.id());
-    if (iter != m_locals.end()) {
-      m_env->assignAt(iter->second, expr.m_name, value);
+#undef QUICK_CASE
+
+    LOG_MSG(cat_INTERP, "\nIn visitBinary, left: ", left.toString(), ", operator: ", expr.m_op->lexeme, ", right: ", right.toString());
+    // comma operator
+    if (expr.m_op->type == TokenType::COMMA) return right;
+    // Note: the first evaluation, or a failed guard, specializes the node for the current types
+    if (expr.m_quick != QuickOp::Uninit && ++expr.m_misses >= MaxQuickMisses) {
+        expr.m_quick = QuickOp::Generic;
     } else {
-      m_globals->assign(expr.m_name, value);
+        expr.m_quick = quickenBinary(expr.m_op->type, left, right);
     }
-    
-    return value;
+
+    return binaryOp(expr.m_op, left, right);
 }
 
-ObjPtr Interpreter::visitBinaryExpr(BinaryExpr& expr) {
-    // Note: the method .get allow to convert smart pointer to raw pointer
-    logMsg("\nIn visitBinary: "); 
-    ObjPtr left = evaluate(expr.m_left);
-    ObjPtr right = evaluate(expr.m_right);
-    logMsg("left: ", left->toString(), ", operator: ", expr.m_op->lexeme, ", right: ", right->toString());
-    switch(expr.m_op->type) {
+/// Note: concatenation of two strings, their bytes are copied once in the new string
+std::string Interpreter::concatStrings(const LukObject& left, const LukObject& right) {
+    auto a = left.getView();
+    auto b = right.getView();
+    std::string result;
+    result.reserve(a.size() + b.size());
+    result.append(a).append(b);
+
+    return result;
+}
+
+/// Note: returns the specialized operation for the operator and the types of its operands,
+/// Generic whether there is none.
+QuickOp Interpreter::quickenBinary(TokenType op, const LukObject& left, const LukObject& right) {
+    if (left.isInt() && right.isInt()) {
+        switch(op) {
+            case TokenType::PLUS: return QuickOp::IntAdd;
+            case TokenType::MINUS: return QuickOp::IntSub;
+            case TokenType::STAR: return QuickOp::IntMul;
+            case TokenType::MOD: return QuickOp::IntMod;
+            case TokenType::LESSER: return QuickOp::IntLess;
+            case TokenType::LESSER_EQUAL: return QuickOp::IntLessEqual;
+            case TokenType::GREATER: return QuickOp::IntGreater;
+            case TokenType::GREATER_EQUAL: return QuickOp::IntGreaterEqual;
+            case TokenType::EQUAL_EQUAL: return QuickOp::IntEqual;
+            case TokenType::BANG_EQUAL: return QuickOp::IntNotEqual;
+            default: break;
+        }
+    } else if (left.isDouble() && right.isDouble()) {
+        switch(op) {
+            case TokenType::PLUS: return QuickOp::DoubleAdd;
+            case TokenType::MINUS: return QuickOp::DoubleSub;
+            case TokenType::STAR: return QuickOp::DoubleMul;
+            case TokenType::SLASH: return QuickOp::DoubleDiv;
+            case TokenType::LESSER: return QuickOp::DoubleLess;
+            case TokenType::LESSER_EQUAL: return QuickOp::DoubleLessEqual;
+            case TokenType::GREATER: return QuickOp::DoubleGreater;
+            case TokenType::GREATER_EQUAL: return QuickOp::DoubleGreaterEqual;
+            default: break;
+        }
+    } else if (left.isString() && right.isString()) {
+        switch(op) {
+            case TokenType::PLUS: return QuickOp::StrConcat;
+            case TokenType::EQUAL_EQUAL: return QuickOp::StrEqual;
+            default: break;
+        }
+    }
+
+    return QuickOp::Generic;
+}
+
+/// Note: binary operators and compound assignment operators share the same operation,
+/// it's used too by the bytecode VM.
+LukObject Interpreter::binaryOp(TokPtr& op, const LukObject& left, const LukObject& right) {
+    switch(op->type) {
         case TokenType::PLUS:
-            if (left->isNumber() && right->isNumber()) {
-                return std::make_shared<LukObject>( *left + *right );
+        case TokenType::PLUS_EQUAL:
+            if (left.isNumber() && right.isNumber()) {
+                return LukObject( left + right );
             }
             
             // Note: temporary can concatenate string with number before having number to string convertion function
-            if ( (left->isString() && right->isString())  ||
-                (left->isString() && right->isNumeric()) || 
-                (left->isNumeric() && right->isString()) )
-                return std::make_shared<LukObject>( format(left) + format(right) );
-            throw RuntimeError(expr.m_op, 
+            if ( (left.isString() && right.isString())  ||
+                (left.isString() && right.isNumeric()) || 
+                (left.isNumeric() && right.isString()) )
+                return LukObject( format(left) + format(right) );
+            throw RuntimeError(op, 
                     "Operands must be string and number.");
         
         case TokenType::MINUS:
-            checkNumberOperands(expr.m_op, left, right);
-            return std::make_shared<LukObject>(*left - *right);
+        case TokenType::MINUS_EQUAL:
+            checkNumberOperands(op, left, right);
+            return LukObject(left - right);
  
         case TokenType::STAR:
-            if (left->isNumber() && right->isNumber())
-              return std::make_shared<LukObject>(*left * *right);
+        case TokenType::STAR_EQUAL:
+            if (left.isNumber() && right.isNumber())
+              return LukObject(left * right);
 
             // Note: can multiply string by number
-            if ( left->isString() && right->isNumber() ) { 
-                if ( not right->isInt()) {
+            if ( left.isString() && right.isNumber() ) { 
+                if ( not right.isInt()) {
                     // if (std::fmod(nb, 1) != 0) 
-                    throw RuntimeError(expr.m_op,
+                    throw RuntimeError(op,
                         "String multiplier must be an integer");
                 }
-                auto str = left->getString();
-                auto num = right->getNumber();
+                auto str = left.getString();
+                auto num = right.getNumber();
                  
-                return std::make_shared<LukObject>( multiplyString(str, num) );
-            } else if ( left->isNumber() && right->isString() ) { 
-                if ( not left->isInt()) {
-                    throw RuntimeError(expr.m_op,
+                return LukObject( multiplyString(str, num) );
+            } else if ( left.isNumber() && right.isString() ) { 
+                if ( not left.isInt()) {
+                    throw RuntimeError(op,
                         "String multiplier must be an integer");
                 }
-                auto str = right->getString();
-                auto num = left->getNumber();
+                auto str = right.getString();
+                auto num = left.getNumber();
                 
-                return std::make_shared<LukObject>( multiplyString(str, num) );
+                return LukObject( multiplyString(str, num) );
             }
             
-            throw RuntimeError(expr.m_op, "Operands must be strings or numbers.");
+            throw RuntimeError(op, "Operands must be strings or numbers.");
 
         case TokenType::SLASH:
-            checkNumberOperands(expr.m_op, left, right);
-            return std::make_shared<LukObject>(*left / *right);
+        case TokenType::SLASH_EQUAL:
+            checkNumberOperands(op, left, right);
+            return LukObject(left / right);
        
         case TokenType::MOD:
-            checkNumberOperands(expr.m_op, left, right);
+        case TokenType::MOD_EQUAL:
+            checkNumberOperands(op, left, right);
             // Note: cannot use modulus % on double
             // use instead fmod function for modulus between double
-            return std::make_shared<LukObject>( *left %  *right);
+            return LukObject( left %  right);
 
         case TokenType::EXP:
-            checkNumberOperands(expr.m_op, left, right);
+        case TokenType::EXP_EQUAL:
+            checkNumberOperands(op, left, right);
             // Note: pow function returns double
             // so, you must convert it to Int ingegral operands
-            if ( left->isInt() && right->isInt() &&
-                    right->getInt() >= 0 )
-                return std::make_shared<LukObject>( TLukInt(std::pow( left->getNumber(), right->getNumber()) ));
-            return std::make_shared<LukObject>(std::pow( left->getNumber(), right->getNumber() ));
+            if ( left.isInt() && right.isInt() &&
+                    right.getInt() >= 0 )
+                return LukObject( TLukInt(std::pow( left.getNumber(), right.getNumber()) ));
+            return LukObject(std::pow( left.getNumber(), right.getNumber() ));
   
         case TokenType::GREATER:
-            // checkNumberOperands(expr.m_op, left, right);
-            return std::make_shared<LukObject>(*left > *right);
+            // checkNumberOperands(op, left, right);
+            return LukObject(left > right);
         
         case TokenType::GREATER_EQUAL:
-            // checkNumberOperands(expr.m_op, left, right);
-            return std::make_shared<LukObject>(*left >= *right);
+            // checkNumberOperands(op, left, right);
+            return LukObject(left >= right);
 
         case TokenType::LESSER:
-            // checkNumberOperands(expr.m_op, left, right);
-            return std::make_shared<LukObject>(*left < *right);
+            // checkNumberOperands(op, left, right);
+            return LukObject(left < right);
 
         case TokenType::LESSER_EQUAL:
-            // checkNumberOperands(expr.m_op, left, right);
-            return std::make_shared<LukObject>(*left <= *right);
+            // checkNumberOperands(op, left, right);
+            return LukObject(left <= right);
             
    
-        case TokenType::BANG_EQUAL: return std::make_shared<LukObject>(*left != *right);
-        case TokenType::EQUAL_EQUAL: return std::make_shared<LukObject>(*left == *right);
+        case TokenType::BANG_EQUAL: return LukObject(left != right);
+        case TokenType::EQUAL_EQUAL: return LukObject(left == right);
 
          // Adding: bitwise operators
         case TokenType::BIT_OR:
-            if (left->isBoolInt() && right->isBoolInt() )
-                return std::make_shared<LukObject>(*left | *right);
-            throw RuntimeError(expr.m_op, "operands must be bools or integers.");
+        case TokenType::BIT_OR_EQUAL:
+            if (left.isBoolInt() && right.isBoolInt() )
+                return LukObject(left | right);
+            throw RuntimeError(op, "operands must be bools or integers.");
 
         case TokenType::BIT_AND:
-            if (left->isBoolInt() && right->isBoolInt() )
-                return std::make_shared<LukObject>(*left & *right);
-            throw RuntimeError(expr.m_op, "operands must be bools or integers.");
+        case TokenType::BIT_AND_EQUAL:
+            if (left.isBoolInt() && right.isBoolInt() )
+                return LukObject(left & right);
+            throw RuntimeError(op, "operands must be bools or integers.");
 
         case TokenType::BIT_XOR:
-            if (left->isBoolInt() && right->isBoolInt() )
-                return std::make_shared<LukObject>(*left ^ *right);
-            throw RuntimeError(expr.m_op, "operands must be bools or integers.");
+        case TokenType::BIT_XOR_EQUAL:
+            if (left.isBoolInt() && right.isBoolInt() )
+                return LukObject(left ^ right);
+            throw RuntimeError(op, "operands must be bools or integers.");
 
         case TokenType::BIT_LEFT:
-            if (left->isBoolInt() && right->isBoolInt() )
-                return std::make_shared<LukObject>(*left << *right);
-            throw RuntimeError(expr.m_op, "operands must be bools or integers.");
+        case TokenType::BIT_LEFT_EQUAL:
+            if (left.isBoolInt() && right.isBoolInt() )
+                return LukObject(left << right);
+            throw RuntimeError(op, "operands must be bools or integers.");
 
         case TokenType::BIT_RIGHT:
-            if (left->isBoolInt() && right->isBoolInt() )
-                return std::make_shared<LukObject>(*left >> *right);
-            throw RuntimeError(expr.m_op, "operands must be bools or integers.");
+        case TokenType::BIT_RIGHT_EQUAL:
+            if (left.isBoolInt() && right.isBoolInt() )
+                return LukObject(left >> right);
+            throw RuntimeError(op, "operands must be bools or integers.");
          
-        // comma operator
-        case TokenType::COMMA:
-            return right;
-
         default: break;
     }
 
 
     // unrichable
-    return nilptr;
+    return LukObject();
 }
 
-ObjPtr Interpreter::visitCallExpr(CallExpr& expr) {
-    logMsg("\nIn visitcallExpr: ", typeid(expr).name()); 
+LukObject Interpreter::visitCallExpr(CallExpr& expr) {
+    LOG_MSG(cat_INTERP, "\nIn visitcallExpr: ", typeid(expr).name()); 
     auto callee = evaluate(expr.m_callee);
-    logMsg("Still In visitCallExpr, callee: ", callee);
-    if (! callee->isCallable()) {
-      logMsg("voici calle: id", callee->id, ", string: ", callee->toString());
-      throw RuntimeError(expr.m_paren, "Can only call function and class.");
+    LOG_MSG(cat_INTERP, "Still In visitCallExpr, callee: ", callee);
+
+    return callArguments(callee, expr.m_paren, expr.m_args, expr.m_keywords, nullptr);
+}
+
+/// Note: evaluates the arguments and calls the callee,
+/// whether thisObj is not null, the callee is a method called with this object.
+LukObject Interpreter::callArguments(const LukObject& callee, TokPtr& paren, 
+        std::vector<ExprPtr>& args, std::map<TokPtr, ExprPtr>& keywords, 
+        const LukObject* thisObj) {
+    if (! callee.isCallable()) {
+      LOG_MSG(cat_INTERP, "voici calle: ", callee.toString());
+      throw RuntimeError(paren, "Can only call function and class.");
     }
 
-    std::vector<ObjPtr> v_args;
-    for (auto& arg: expr.m_args) {
+    std::vector<LukObject> v_args;
+    for (auto& arg: args) {
         v_args.push_back(evaluate(arg));
     }
-    const auto& func = callee->getCallable();
-    
+    const auto& func = callee.getCallable();
+    checkArity(callee, v_args.size());
+    if (!keywords.empty()  && func->getKeywords().empty() ) {
+          throw RuntimeError(paren, "No default keyword for this function.");
+    } else if (!keywords.empty() ) {
+        for (auto& iter: keywords)  {
+            auto obj = evaluate(iter.second);
+            LOG_MSG(cat_INTERP, iter.first, ":", obj.toString());
+            setKeyword(func, iter.first, obj);
+        } // End For loop
+    }
+ 
+    LOG_MSG(cat_INTERP, "func->toString : ",func->toString());
+    LOG_MSG(cat_INTERP, "func.refCount: ", func->refCount());
+
+    LOG_MSG(cat_INTERP, "\nExit out visitcallExpr, before returns func->call:  "); 
+    if (thisObj != nullptr) {
+        return static_cast<LukFunction*>(func)->callWith(*this, *thisObj, v_args);
+    }
+    return func->call(*this, v_args);
+}
+
+LukObject Interpreter::visitInvokeExpr(InvokeExpr& expr) {
+    LOG_MSG(cat_INTERP, "\nIn visitInvokeExpr, name: ", expr.m_name);
+    auto obj = evaluate(expr.m_object);
+    bool isMethod = false;
+    auto callee = getMethod(obj, expr.m_name, isMethod, &expr.m_cache);
+
+    return callArguments(callee, expr.m_paren, expr.m_args, expr.m_keywords, 
+            isMethod ? &obj : nullptr);
+}
+
+/// Note: like getProperty, but a method of an instance is returned without binding it,
+/// isMethod is set whether it must be called with the object as "this".
+LukObject Interpreter::getMethod(const LukObject& obj, TokPtr& name, bool& isMethod, 
+        InlineCache* cache) {
+    if (obj.isInstance()) {
+        return obj.getInstance()->getMember(name, isMethod, cache);
+    }
+    isMethod = false;
+
+    return getProperty(obj, name, cache);
+}
+
+void Interpreter::checkArity(const LukObject& callee, size_t argCount) {
+    auto func = callee.getCallable();
     /// Note: 255 arguments means variadic function
-    if (func->arity() != 255 && v_args.size() != func->arity()) {
+    if (func->arity() != 255 && argCount != func->arity()) {
         std::ostringstream msg;
-        msg << callee->toString() << ", " << "Expected " << func->arity() 
+        msg << callee.toString() << ", " << "Expected " << func->arity() 
            << " arguments but got " 
-           << v_args.size() << ".";
+           << argCount << ".";
         throw RuntimeError(msg.str());
     }
+}
+
+void Interpreter::setKeyword(LukCallable* func, const TokPtr& keyword, const LukObject& value) {
     auto& funcKeywords = func->getKeywords();
-    if (!expr.m_keywords.empty()  && funcKeywords.empty() ) {
-          throw RuntimeError(expr.m_paren, "No default keyword for this function.");
-    } else if (!expr.m_keywords.empty() ) {
-        for (auto& iter: expr.m_keywords)  {
-            auto strVal = iter.first->lexeme;
-            auto obj = evaluate(iter.second);
-            logMsg(iter.first, ":", obj->toString());
-            // std::cerr << iter.first->lexeme <<  ": " << obj->toString() << "\n";
-            // searching the calling keyword in funcKeyword map
-            auto elem = funcKeywords.find(strVal);
-            if (elem != funcKeywords.end()) {
-                func->setKeywords(strVal, obj->toString());
-            } else {
-                  throw RuntimeError(strVal +  std::string(", No such  keyword for this function."));
-            
-            }
-        } // End For loop
+    const std::string strVal(keyword->lexeme);
+    // searching the calling keyword in funcKeyword map
+    auto elem = funcKeywords.find(strVal);
+    if (elem != funcKeywords.end()) {
+        func->setKeywords(strVal, value.toString());
+    } else {
+          throw RuntimeError(strVal +  std::string(", No such  keyword for this function."));
+    
     }
- 
-    logMsg("func->toString : ",func->toString());
-    logMsg("func.use_count: ", func.use_count());
-
-    logMsg("\nExit out visitcallExpr, before returns func->call:  "); 
-    return func->call(*this, v_args);
 }
 
-ObjPtr Interpreter::visitFunctionExpr(FunctionExpr& expr) {
-  logMsg("\nIn visitFunctionExpr, id: ", expr.id());
+LukObject Interpreter::visitFunctionExpr(FunctionExpr& expr) {
+  LOG_MSG(cat_INTERP, "\nIn visitFunctionExpr, id: ", expr.id());
   // Note: lambda function not need to be in the environment stack
   auto exprP = std::make_shared<FunctionExpr>(expr);
-  auto funcPtr = std::make_shared<LukFunction>("", exprP, m_env, false);
-  ObjPtr objP = std::make_shared<LukObject>(funcPtr);
+  auto funcPtr = makeRef<LukFunction>("", exprP, m_env, false);
+  LukObject objP = LukObject(funcPtr);
 
   return objP; 
 }
 
 
-ObjPtr Interpreter::visitGetExpr(GetExpr& expr) {
-  logMsg("\nIn visitGetExpr, name: ", expr.m_name);
+LukObject Interpreter::visitGetExpr(GetExpr& expr) {
+  LOG_MSG(cat_INTERP, "\nIn visitGetExpr, name: ", expr.m_name);
   auto obj = evaluate(expr.m_object);
-  logMsg("obj: ", obj, ", type: ", obj->getType(), ", id: ", obj->getId());
+
+  return getProperty(obj, expr.m_name, &expr.m_cache);
+}
+
+LukObject Interpreter::getProperty(const LukObject& obj, TokPtr& name, InlineCache* cache) {
+  LOG_MSG(cat_INTERP, "obj: ", obj, ", type: ", obj.getType());
   /// Note: now, LukClass object is derived from LukInstance, and LukCallable objects
-  if (obj->isInstance()) {
-    logMsg("obj is an instance");
+  if (obj.isInstance()) {
+    LOG_MSG(cat_INTERP, "obj is an instance");
     // obj_ptr is the method
-    auto obj_ptr = obj->getInstance()->get(expr.m_name);
+    auto obj_ptr = obj.getInstance()->get(name, cache);
     // Note: shared_ptr.get() returns the stored pointer, not the managed pointer.
     // *shared_ptr dereference the smart pointer
     // so, after *shared_ptr, you cannot use it again.
     // so, dont use *shared_ptr
-    logMsg("In visitGetExpr, obj_ptr: ", obj_ptr->toString());
-    logMsg("\nExit out visitGetExpr, name, before returning obj_ptr");
+    LOG_MSG(cat_INTERP, "In visitGetExpr, obj_ptr: ", obj_ptr.toString());
+    LOG_MSG(cat_INTERP, "\nExit out visitGetExpr, name, before returning obj_ptr");
     return obj_ptr;
   }
   // searching in instance m_klass::fields, then in instance m_klass::m_methods
   // then in klass::m_methods
-  logMsg("obj is not instance: ", obj->toString(), ", type: ", obj->toString());
-  logMsg("obj is: ", obj->toString(), ", type: ", obj->getType());
-  auto klass = obj->getDynCast<LukClass>();
+  LOG_MSG(cat_INTERP, "obj is not instance: ", obj.toString(), ", type: ", obj.toString());
+  LOG_MSG(cat_INTERP, "obj is: ", obj.toString(), ", type: ", obj.getType());
+  auto klass = obj.getDynCast<LukClass>();
   if (klass != nullptr) { 
-      auto instMeth = klass->get(expr.m_name);
-      if (instMeth != nullptr && instMeth != nilptr) return instMeth;
-      logMsg("Method instance not found: ", expr.m_name->lexeme);
-      auto objMeth = klass->findMethod(expr.m_name->lexeme);
-      if (objMeth != nullptr && objMeth != nilptr) return objMeth;
-      throw RuntimeError(expr.m_name,
+      auto objMeth = klass->getProperty(name, cache);
+      if (!objMeth.isNil()) return objMeth;
+      throw RuntimeError(name,
       "property not found.");
    }
-  throw RuntimeError(expr.m_name,
+  throw RuntimeError(name,
     "Only instances have properties.");
   
-  return nilptr;
+  return LukObject();
 }
 
-ObjPtr Interpreter::visitGroupingExpr(GroupingExpr& expr) {
+LukObject Interpreter::visitGroupingExpr(GroupingExpr& expr) {
     return evaluate(expr.m_expression);
 }
 
-ObjPtr Interpreter::visitInterpolateExpr(InterpolateExpr& expr) {
-    logMsg("\nIn visitInterpolateExpr: ", typeid(expr).name()); 
-    std::ostringstream msg;
+LukObject Interpreter::visitIndexExpr(IndexExpr& expr) {
+    LukObject obj = evaluate(expr.m_object);
+    if (expr.m_isSlice) {
+        LukObject start = expr.m_index ? evaluate(expr.m_index) : LukObject();
+        LukObject end = expr.m_end ? evaluate(expr.m_end) : LukObject();
+        return sliceList(obj, start, end);
+    }
+    LukObject index = evaluate(expr.m_index);
+
+    return getItem(obj, index);
+}
+
+// Note: the index errors are reported without the bracket token, like the errors of substr()
+LukObject Interpreter::getItem(const LukObject& obj, const LukObject& index) {
+    if (!obj.isArray() && !obj.isRange()) return itemRef(obj, index);
+    if (!index.isInt()) {
+        throw RuntimeError(obj.isArray() ? "Array index must be an integer." :
+                "Range index must be an integer.");
+    }
+    if (obj.isRange()) return LukObject(obj.getRange()->at(index.getInt()));
+
+    return obj.getArray()->get(index.getInt());
+}
+
+LukObject& Interpreter::itemRef(const LukObject& obj, const LukObject& index) {
+    if (obj.isMap()) {
+        if (!LukMap::isKey(index)) throw RuntimeError("Map key must be a string, a number or a bool.");
+        LukObject* val = obj.getMap()->find(index);
+        if (val == nullptr) throw RuntimeError("Key not found in map: " + index.toString());
+        return *val;
+    }
+    if (!obj.isList()) {
+        throw RuntimeError("Object of type '" + obj.typeOf() + "' is not indexable.");
+    }
+    if (!index.isInt()) throw RuntimeError("List index must be an integer.");
+
+    return obj.getList()->at(index.getInt());
+}
+
+LukObject Interpreter::setItem(const LukObject& obj, const LukObject& index,
+        TokPtr& equals, const LukObject& value) {
+    if (obj.isMap() && equals->type == TokenType::EQUAL) {
+        if (!LukMap::isKey(index)) throw RuntimeError("Map key must be a string, a number or a bool.");
+        obj.getMap()->set(index, value);
+        return value;
+    }
+    if (obj.isArray()) {
+        // Note: the values are unboxed, so a compound assignment works on a copy of the value
+        LukObject item = getItem(obj, index);
+        if (equals->type == TokenType::EQUAL) item = value;
+        else compoundAssign(item, equals, value);
+        obj.getArray()->set(index.getInt(), item);
+        return item;
+    }
+    LukObject& item = itemRef(obj, index);
+    if (equals->type == TokenType::EQUAL) {
+        item = value;
+        return value;
+    }
+    // Note: like a variable, a string owned only by the list is appended in place
+    compoundAssign(item, equals, value);
+
+    return item;
+}
+
+TLukInt Interpreter::iterStart(const LukObject& iterable, TokPtr& keyword) {
+    if (iterable.isRange()) return iterable.getRange()->start();
+    if (iterable.isList() || iterable.isArray()) return 0;
+
+    throw RuntimeError(keyword, "Object of type '" + iterable.typeOf() + "' is not iterable.");
+}
+
+bool Interpreter::iterNext(const LukObject& iterable, TLukInt& position, LukObject& out) {
+    if (iterable.isRange()) {
+        const LukRange* range = iterable.getRange();
+        if (!range->before(position)) return false;
+        out.setInt(position);
+        // Note: on overflow, the next position is the stop, which ends the loop
+        if (__builtin_add_overflow(position, range->step(), &position)) position = range->stop();
+        return true;
+    }
+    // Note: the size is checked at each step, the body can modify the list
+    if (iterable.isList()) {
+        auto& items = iterable.getList()->getItems();
+        if (position >= TLukInt(items.size())) return false;
+        out = items[position++];
+        return true;
+    }
+    const LukArray* array = iterable.getArray();
+    if (position >= TLukInt(array->size())) return false;
+    if (array->isFloat()) out = LukObject(array->doubles()[position]);
+    else out.setInt(array->ints()[position]);
+    ++position;
+
+    return true;
+}
+
+LukObject Interpreter::sliceList(const LukObject& obj, const LukObject& start, const LukObject& end) {
+    if (!obj.isList() && !obj.isArray()) {
+        throw RuntimeError("Object of type '" + obj.typeOf() + "' cannot be sliced.");
+    }
+    if ((!start.isNil() && !start.isInt()) || (!end.isNil() && !end.isInt())) {
+        throw RuntimeError("Slice bounds must be integers.");
+    }
+    TLukInt first = start.isNil() ? 0 : start.getInt();
+    if (obj.isArray()) {
+        auto array = obj.getArray();
+        TLukInt last = end.isNil() ? TLukInt(array->size()) : end.getInt();
+        return LukObject(array->slice(first, last));
+    }
+    auto list = obj.getList();
+    TLukInt last = end.isNil() ? TLukInt(list->size()) : end.getInt();
+
+    return LukObject(list->slice(first, last));
+}
+
+LukObject Interpreter::visitInterpolateExpr(InterpolateExpr& expr) {
+    LOG_MSG(cat_INTERP, "\nIn visitInterpolateExpr: ", typeid(expr).name()); 
+    std::string msg;
     for (auto& arg: expr.m_args) {
-        msg << evaluate(arg)->toString();
+        evaluate(arg).appendTo(msg);
     }
-    logMsg("\nExit out visitInterpolateExpr, before returns func->call:  "); 
+    LOG_MSG(cat_INTERP, "\nExit out visitInterpolateExpr, before returns func->call:  "); 
 
-    return std::make_shared<LukObject>(msg.str());
+    return LukObject(std::move(msg));
 }
 
-ObjPtr Interpreter::visitLiteralExpr(LiteralExpr& expr) {
-    logMsg("\nIn visitLiteralExpr Interpreter, value: ", expr.m_value->toString());
+LukObject Interpreter::visitListExpr(ListExpr& expr) {
+    std::vector<LukObject> items;
+    items.reserve(expr.m_items.size());
+    for (auto& item: expr.m_items) {
+        items.push_back(evaluate(item));
+    }
+
+    return LukObject(makeRef<LukList>(std::move(items)));
+}
+
+LukObject Interpreter::visitLiteralExpr(LiteralExpr& expr) {
+    LOG_MSG(cat_INTERP, "\nIn visitLiteralExpr Interpreter, value: ", expr.m_value.toString());
     return expr.m_value;
 }
 
 
-ObjPtr Interpreter::visitLogicalExpr(LogicalExpr& expr) {
-    ObjPtr left = evaluate(expr.m_left);
+LukObject Interpreter::visitLogicalExpr(LogicalExpr& expr) {
+    LukObject left = evaluate(expr.m_left);
     if (expr.m_op->type == TokenType::OR) {
         if (isTruthy(left)) return left;
 
@@ -533,70 +708,119 @@ ObjPtr Interpreter::visitLogicalExpr(LogicalExpr& expr) {
     return evaluate(expr.m_right);
 }
 
-ObjPtr Interpreter::visitSetExpr(SetExpr& expr) {
-    logMsg("\nIn visitSet: ");
-    logMsg("name: ", expr.m_name);
+LukObject Interpreter::visitMapExpr(MapExpr& expr) {
+    std::vector<LukObject> items;
+    items.reserve(expr.m_entries.size() * 2);
+    for (auto& entry: expr.m_entries) {
+        items.push_back(evaluate(entry.first));
+        items.push_back(evaluate(entry.second));
+    }
+
+    return buildMap(expr.m_brace, items.data(), expr.m_entries.size());
+}
+
+LukObject Interpreter::buildMap(TokPtr& brace, const LukObject* items, size_t count) {
+    auto map = makeRef<LukMap>();
+    for (size_t i=0; i < count; ++i) {
+        const LukObject& key = items[2*i];
+        if (!LukMap::isKey(key)) throw RuntimeError(brace, "Map key must be a string, a number or a bool.");
+        map->set(key, items[2*i +1]);
+    }
+
+    return LukObject(map);
+}
+
+LukObject Interpreter::visitSetIndexExpr(SetIndexExpr& expr) {
+    LukObject obj = evaluate(expr.m_object);
+    LukObject index = evaluate(expr.m_index);
+    LukObject value = evaluate(expr.m_value);
+
+    return setItem(obj, index, expr.m_equals, value);
+}
+
+LukObject Interpreter::visitSetExpr(SetExpr& expr) {
+    LOG_MSG(cat_INTERP, "\nIn visitSet: ");
+    LOG_MSG(cat_INTERP, "name: ", expr.m_name);
     auto objP = evaluate(expr.m_object);
     auto value = evaluate(expr.m_value);
+
+    return setProperty(objP, expr.m_name, value, &expr.m_cache);
+}
+
+LukObject Interpreter::setProperty(const LukObject& objP, TokPtr& name, const LukObject& value,
+        InlineCache* cache) {
     // Now, LukClass object is derived from LukInstance  and LukCallable objects.
-    if (objP->isInstance()) {
-        logMsg("value: ", value);
-        logMsg("obj: ", objP, ", type: ", objP->getType());
-        logMsg("obj->getId: ", objP->getId());
-        auto instPtr = objP->getInstance();
-        logMsg("instptr tostring: ", instPtr->toString());
-        logMsg("Set instance, name: ", expr.m_name, ", value: ", value);
-        instPtr->set(expr.m_name, value);
-        logMsg("m_fields size from visitSet: protected");
+    if (objP.isInstance()) {
+        LOG_MSG(cat_INTERP, "value: ", value);
+        LOG_MSG(cat_INTERP, "obj: ", objP, ", type: ", objP.getType());
+        auto instPtr = objP.getInstance();
+        LOG_MSG(cat_INTERP, "instptr tostring: ", instPtr->toString());
+        LOG_MSG(cat_INTERP, "Set instance, name: ", name, ", value: ", value);
+        instPtr->set(name, value, cache);
+        LOG_MSG(cat_INTERP, "m_fields size from visitSet: protected");
         return value;
     }
 
     // using klass instead instance
-    auto klass = objP->getDynCast<LukClass>();
+    auto klass = objP.getDynCast<LukClass>();
     if (klass != nullptr) { 
-        klass->set(expr.m_name, value);
+        klass->set(name, value);
         return value;
     }
 
-    logMsg("Exit out visitSet: \n");
-    throw RuntimeError(expr.m_name,
+    LOG_MSG(cat_INTERP, "Exit out visitSet: \n");
+    throw RuntimeError(name,
         "Only instances have fields.");
  
-    return nilptr;
-}
-
-ObjPtr Interpreter::visitSuperExpr(SuperExpr& expr) {
-  logMsg("\nIn visitSuperExpr: ");
-  logMsg("expr.m_method: ", expr.m_method, ", expr.id: ", expr.id());
-  auto iter = m_locals.find(expr.id());
-  if (iter != m_locals.end()) {
-    // iter->second is the depth
-    int distance = iter->second;
-    auto objClass = m_env->getAt(distance, "super");
-    // TODO: it will better to test whether is classable
-    auto superclass = objClass->getDynCast<LukClass>();
-    
-    // "this" is always one level nearer than "super"'s environment.
-    auto objInst = m_env->getAt(
-      distance - 1, "this");
-    auto instPtr = objInst->getInstance();
-    ObjPtr method = superclass->findMethod(expr.m_method->lexeme);
-    if (method == nullptr) {
-      throw RuntimeError(expr.m_method,
-          "Undefined property '" + expr.m_method->lexeme + "'.");
+    return LukObject();
+}
 
-    }
+LukObject Interpreter::visitSuperExpr(SuperExpr& expr) {
+  LOG_MSG(cat_INTERP, "\nIn visitSuperExpr: ");
+  LOG_MSG(cat_INTERP, "expr.m_method: ", expr.m_method, ", expr.id: ", expr.id());
+  if (expr.m_depth >= 0) {
+    return superMethod(*m_env, expr.m_depth, expr.m_slot, expr.m_thisDepth, expr.m_method,
+            &expr.m_cache);
+  }
 
-    std::shared_ptr<LukFunction> funcPtr = method->getDynCast<LukFunction>();
-    logMsg("\nExit out visitSuperExpr before return  funtcPtr->bind");
-    return funcPtr->bind(instPtr);
+  return LukObject();
+}
 
-  }
+LukObject Interpreter::superMethod(Environment& env, int distance, int slot, int thisDistance, TokPtr& name,
+        InlineCache* cache) {
+    auto& objClass = env.getAt(distance, slot);
+    // Note: the superclass slot holds always a class, set by the class declaration
+    auto superclass = static_cast<LukClass*>(objClass.getCallable());
+    
+    // "this" is the first slot of the method's frame
+    auto& objInst = env.getAt(thisDistance, 0);
+    auto instPtr = objInst.getInstance();
+    // Note: the method does not depend on the instance, only on the superclass
+    CacheEntry* entry = cache != nullptr ? cache->find(nullptr, superclass->id(), superclass->version()) : nullptr;
+    const LukObject* method;
+    if (entry != nullptr) {
+      method = entry->p_method;
+    } else {
+      method = superclass->methodRef(name->symbol);
+      if (method == nullptr) {
+        throw RuntimeError(name,
+            "Undefined property '" + std::string(name->lexeme) + "'.");
+      }
+      if (cache != nullptr) {
+        CacheEntry newEntry;
+        newEntry.m_classId = superclass->id();
+        newEntry.m_version = superclass->version();
+        newEntry.p_method = method;
+        cache->add(name, std::move(newEntry));
+      }
+    }
 
-  return nilptr;
+    auto funcPtr = static_cast<LukFunction*>(method->getCallable());
+    LOG_MSG(cat_INTERP, "\nExit out superMethod before return  funtcPtr->bind");
+    return funcPtr->bind(LukRef<LukInstance>(instPtr));
 }
 
-ObjPtr Interpreter::visitTernaryExpr(TernaryExpr& expr) {
+LukObject Interpreter::visitTernaryExpr(TernaryExpr& expr) {
     auto val = evaluate(expr.m_condition);
     if (isTruthy(val)) {
       return evaluate(expr.m_thenBranch);
@@ -606,134 +830,179 @@ ObjPtr Interpreter::visitTernaryExpr(TernaryExpr& expr) {
 }
 
 
-ObjPtr Interpreter::visitThisExpr(ThisExpr& expr) {
-  logMsg("\nIn visitThis");
-  logMsg("keyword: ", expr.m_keyword);
+LukObject Interpreter::visitThisExpr(ThisExpr& expr) {
+  LOG_MSG(cat_INTERP, "\nIn visitThis");
+  LOG_MSG(cat_INTERP, "keyword: ", expr.m_keyword);
   auto obj = lookUpVariable(expr.m_keyword, expr);
 
-  logMsg("Exit out visitThis\n");
+  LOG_MSG(cat_INTERP, "Exit out visitThis\n");
   return obj;
 }
 
-ObjPtr Interpreter::visitUnaryExpr(UnaryExpr& expr) {
-    ObjPtr right = evaluate(expr.m_right);
-    switch(expr.m_op->type) {
-        case TokenType::BANG:
-            return std::make_shared<LukObject>(!isTruthy(right));
-        
-        case TokenType::MINUS:
-            checkNumberOperand(expr.m_op, right);
-            return std::make_shared<LukObject>(-*right);
+LukObject Interpreter::visitUnaryExpr(UnaryExpr& expr) {
+    LukObject right = evaluate(expr.m_right);
+    switch(expr.m_quick) {
+        case QuickOp::IntNeg:
+            if (right.isInt()) return LukObject(-right.m_int);
+            break;
+        case QuickOp::DoubleNeg:
+            if (right.isDouble()) return LukObject(-right.m_double);
+            break;
+        case QuickOp::BoolNot:
+            if (right.isBool()) return LukObject(!right.m_bool);
+            break;
+        case QuickOp::Generic:
+            return unaryExpr(expr, right);
+        default: break;
+    }
 
-        case TokenType::PLUS:
-            checkNumberOperand(expr.m_op, right);
-            return right; // std::make_shared<LukObject>(*right);
-        
-        // bitwise NOT operator
-        case TokenType::BIT_NOT:
-            checkNumberOperand(expr.m_op, right);
-            return std::make_shared<LukObject>(~*right);
+    if (expr.m_quick != QuickOp::Uninit && ++expr.m_misses >= MaxQuickMisses) {
+        expr.m_quick = QuickOp::Generic;
+    } else if (expr.m_op->type == TokenType::MINUS && right.isInt()) {
+        expr.m_quick = QuickOp::IntNeg;
+    } else if (expr.m_op->type == TokenType::MINUS && right.isDouble()) {
+        expr.m_quick = QuickOp::DoubleNeg;
+    } else if (expr.m_op->type == TokenType::BANG && right.isBool()) {
+        expr.m_quick = QuickOp::BoolNot;
+    } else {
+        expr.m_quick = QuickOp::Generic;
+    }
+
+    return unaryExpr(expr, right);
+}
 
+/// Note: generic unary operation of the node, the increment and decrement operators assign their variable
+LukObject Interpreter::unaryExpr(UnaryExpr& expr, const LukObject& right) {
+    switch(expr.m_op->type) {
         // prefix, postfix operators
         /// Note: prefix operator assign the new value to the variable, and returning it after.
         /// but postfix operator, returns the variable, and assign the new value after.
         case TokenType::MINUS_MINUS:
-            if (expr.m_right->isVariableExpr()) {
-                checkNumberOperand(expr.m_op, right);
-                /// Note: creating an object with value 1, to be able to make operations between objects
-                TLukInt val=1;
-                auto objVal = LukObject(val);
-                auto var = expr.m_right;
-                auto name = var->getName(); 
-                auto objP = std::make_shared<LukObject>(*right - objVal);
-                m_env->assign(name, objP);
-                if (expr.m_isPostfix) return right;
-                else return std::make_shared<LukObject>(*right - objVal);
-            }
-            throw RuntimeError(expr.m_op,
-                "Operand of a decrement operator must be a variable.");
-
         case TokenType::PLUS_PLUS:
             if (expr.m_right->isVariableExpr()) {
-                checkNumberOperand(expr.m_op, right);
-                TLukInt val=1;
-                auto objVal = LukObject(val);
                 auto var = expr.m_right;
                 auto name = var->getName(); 
-                auto objP = std::make_shared<LukObject>(*right + objVal);
-                m_env->assign(name, objP);
+                auto objP = unaryOp(expr.m_op, right);
+                // Note: assigning at the depth resolved, like visitAssignExpr
+                assignVariable(name, *var, objP);
                 if (expr.m_isPostfix) return right;
-                else return std::make_shared<LukObject>(*right + objVal);
+                else return objP;
             }
+            if (expr.m_op->type == TokenType::MINUS_MINUS) 
+                throw RuntimeError(expr.m_op,
+                    "Operand of a decrement operator must be a variable.");
             throw RuntimeError(expr.m_op,
                 "Operand of a increment operator must be a variable.");
 
         default: break;
     }
 
-    return nilptr;
+    return unaryOp(expr.m_op, right);
+}
+
+/// Note: for increment and decrement operators, returns the new value of the variable.
+LukObject Interpreter::unaryOp(TokPtr& op, const LukObject& right) {
+    switch(op->type) {
+        case TokenType::BANG:
+            return LukObject(!isTruthy(right));
+        
+        case TokenType::MINUS:
+            checkNumberOperand(op, right);
+            return LukObject(-right);
+
+        case TokenType::PLUS:
+            checkNumberOperand(op, right);
+            return right; // LukObject(right);
+        
+        // bitwise NOT operator
+        case TokenType::BIT_NOT:
+            checkNumberOperand(op, right);
+            return LukObject(~right);
+
+        case TokenType::MINUS_MINUS:
+            checkNumberOperand(op, right);
+            return right - LukObject(TLukInt(1));
+
+        case TokenType::PLUS_PLUS:
+            checkNumberOperand(op, right);
+            return right + LukObject(TLukInt(1));
+
+        default: break;
+    }
+
+    return LukObject();
 }
 
-ObjPtr Interpreter::visitVariableExpr(VariableExpr& expr) {
-  logMsg("\nIn visitVariableExpr, name:   ", expr.m_name);
+LukObject Interpreter::visitVariableExpr(VariableExpr& expr) {
+  LOG_MSG(cat_INTERP, "\nIn visitVariableExpr, name:   ", expr.m_name);
   return lookUpVariable(expr.m_name, expr);
 }
 
-ObjPtr Interpreter::lookUpVariable(TokPtr& name, Expr& expr) {
-  logMsg("\nIn lookUpVariable name: ", name->lexeme, ", expr id: ", expr.id());
-  // searching the depth in locals map
+LukObject Interpreter::lookUpVariable(TokPtr& name, Expr& expr) {
+  LOG_MSG(cat_INTERP, "\nIn lookUpVariable name: ", name->lexeme, ", depth: ", expr.m_depth, ", slot: ", expr.m_slot);
+  // local variable, resolved by the resolver
   // whether not, get the variable in globals map
-  auto iter = m_locals.find(expr.id());
-  if (iter != m_locals.end()) {
-    // iter->second is the depth
-    logMsg("Find in m_locals depth: ", iter->second);
-    return m_env->getAt(iter->second, name->lexeme);
+  return variableRef(name, expr);
+}
+
+LukObject& Interpreter::variableRef(TokPtr& name, Expr& expr) {
+  if (expr.m_depth >= 0) {
+    return m_env->getAt(expr.m_depth, expr.m_slot);
   }
 
-    logMsg("Not found in m_locals, search in m_globals, name: ", name->lexeme);
+    LOG_MSG(cat_INTERP, "Not resolved, search in m_globals, name: ", name->lexeme);
   return m_globals->get(name);
 }
 
-bool Interpreter::isTruthy(ObjPtr& obj) {
-    if (obj->isNil()) return false;
-    if (obj->isBool()) return obj->getBool();
-    if (obj->isInt() && obj->getInt() == 0) return false;
-    if (obj->isNumber() && obj->getNumber() == 0) return false;
-    if (obj->isString() && obj->getString() == "") return false;
+void Interpreter::assignVariable(TokPtr& name, Expr& expr, const LukObject& value) {
+  if (expr.m_depth >= 0) {
+    m_env->assignAt(expr.m_depth, expr.m_slot, value);
+  } else {
+    m_globals->assign(name, value);
+  }
+}
+
+void Interpreter::defineVariable(TokPtr& name, int slot, const LukObject& value) {
+  if (slot >= 0) m_env->defineSlot(slot, value);
+  else m_env->define(name->symbol, value);
+}
+
+bool Interpreter::isTruthy(const LukObject& obj) {
+    if (obj.isNil()) return false;
+    if (obj.isBool()) return obj.getBool();
+    if (obj.isInt() && obj.getInt() == 0) return false;
+    if (obj.isNumber() && obj.getNumber() == 0) return false;
+    if (obj.isString() && obj.getView().empty()) return false;
+    if (obj.isList() && obj.getList()->size() == 0) return false;
+    if (obj.isMap() && obj.getMap()->size() == 0) return false;
+    if (obj.isArray() && obj.getArray()->size() == 0) return false;
+    if (obj.isRange() && obj.getRange()->size() == 0) return false;
     
     return true;
 }
 
-bool Interpreter::isEqual(ObjPtr& a, ObjPtr& b) {
+bool Interpreter::isEqual(const LukObject& a, const LukObject& b) {
     // nil is only equal to nil
-    if (a->isNil() && b->isNil()) return true;
-    if (a->isNil()) return false;
+    if (a.isNil() && b.isNil()) return true;
+    if (a.isNil()) return false;
 
-    return *a == *b;
+    return a == b;
 }
 
-void Interpreter::checkNumberOperand(TokPtr& op, ObjPtr& operand) {
-    if (operand->isBool() || operand->isNumber()) return;
+void Interpreter::checkNumberOperand(TokPtr& op, const LukObject& operand) {
+    if (operand.isBool() || operand.isNumber()) return;
     throw RuntimeError(op, "Operand must be bool or number.");
 }
 
-void Interpreter::checkNumberOperands(TokPtr& op, ObjPtr& left, ObjPtr& right) {
-    if (left->isNumber() && right->isNumber()) return;
+void Interpreter::checkNumberOperands(TokPtr& op, const LukObject& left, const LukObject& right) {
+    if (left.isNumber() && right.isNumber()) return;
     throw RuntimeError(op, "Operands must be numbers.");
 }
 
 
-void Interpreter::resolve(Expr& expr, int depth) {
-  logMsg("\nIn Resolve expr, Interpreter");
-  logMsg("assign to m_locals, expr id: ", expr.id(), "depth: ", depth);
-  // Note: FIX: abstract class Expr cannot be in map
-  // so, we store its uniq id in the map
-  m_locals[expr.id()] = depth;
-}
-
 
 void Interpreter::executeBlock(std::vector<StmtPtr>& statements, EnvPtr env) {
-    logMsg("\nIn ExecuteBlock: ");
+    LOG_MSG(cat_INTERP, "\nIn ExecuteBlock: ");
     auto previous = m_env;
     try {
         m_env = env;
@@ -742,10 +1011,13 @@ void Interpreter::executeBlock(std::vector<StmtPtr>& statements, EnvPtr env) {
                 // not use move because for reuse of the block
                 // stmt->accept(*this);
                 execute(stmt);
+            // Note: return, break and continue statements set the completion status,
+            // so the remaining statements are skipped without throwing any exception.
+            if (m_completion != Completion::Normal) break;
 
         }
 
-    // Note: must catch all exceptions, even the Return exception.
+    // Note: must catch all exceptions, to restore the environment on runtime errors.
     } catch(...) {
         m_env = previous;
         // throw up the exception
@@ -754,9 +1026,9 @@ void Interpreter::executeBlock(std::vector<StmtPtr>& statements, EnvPtr env) {
     // finally, whether no exception
     m_env = previous;
     // reset global variable m_result
-    m_result = nilptr;
+    m_result = LukObject();
     
-    logMsg("\nExit out  ExecuteBlock: ");
+    LOG_MSG(cat_INTERP, "\nExit out  ExecuteBlock: ");
 }
 
 void Interpreter::visitBlockStmt(BlockStmt& stmt) {
@@ -764,92 +1036,91 @@ void Interpreter::visitBlockStmt(BlockStmt& stmt) {
 }
 
 void Interpreter::visitBreakStmt(BreakStmt& stmt) {
-    std::string msg;
-    if (stmt.m_keyword->lexeme == "break") {
-        msg = "Error: 'break' must with while loop";
-        throw Jump(stmt.m_keyword, msg);
-    } else if (stmt.m_keyword->lexeme == "continue") {
-        msg = "Error: 'continue' must with while loop";
-        throw Jump(stmt.m_keyword, msg);
+    // Note: the resolver has already checked that the statement is inside a loop
+    if (stmt.m_keyword->type == TokenType::BREAK) {
+        m_completion = Completion::Break;
+    } else {
+        m_completion = Completion::Continue;
     }
          
 }
 
 void Interpreter::visitClassStmt(ClassStmt& stmt) {
-  logMsg("In visitClassStmt: name: ", stmt.m_name->lexeme);
-  ObjPtr superclass = nilptr;
-  std::shared_ptr<LukClass> supKlass = nullptr;
+  LOG_MSG(cat_INTERP, "In visitClassStmt: name: ", stmt.m_name->lexeme);
+  LukObject superclass = LukObject();
+  LukRef<LukClass> supKlass = nullptr;
   if (stmt.m_superclass != nullptr) {
     // Note: changing evaluate(ExprPtr&) to evaluate(ExprPtr) to passing VariableExpr object
     superclass = evaluate(stmt.m_superclass);
-    logMsg("superclass: ", superclass);
+    LOG_MSG(cat_INTERP, "superclass: ", superclass);
     // TODO: It will better to test whether superclass is classable instead callable
-    if (!superclass->isCallable()) { //  instanceof LoxClass)) {
+    if (!superclass.isCallable()) { //  instanceof LoxClass)) {
       throw RuntimeError(stmt.m_superclass->m_name,
             "Superclass must be a class.");
     } else {
-      supKlass = superclass->getDynCast<LukClass>();
+      supKlass = superclass.getDynCast<LukClass>();
     }
 
   }
 
-  m_env->define(stmt.m_name->lexeme, nilptr);
+  defineVariable(stmt.m_name, stmt.m_slot, LukObject());
 
   if (stmt.m_superclass != nullptr) {
     m_env = std::make_shared<Environment>(m_env);
-    m_env->define("super", superclass);
+    m_env->defineSlot(0, superclass);
 
   }
 
-  std::unordered_map<std::string, ObjPtr> methods;
+  std::unordered_map<Symbol, LukObject> methods;
   // Adding variables fields into the class map
-  ObjPtr value = nilptr;
+  LukObject value = LukObject();
   TokPtr name;
   ExprPtr initializer;
   for (auto& it: stmt.m_vars) {
-      value = nilptr;
+      value = LukObject();
       name = it.first;
       initializer = it.second;
       if (initializer != nullptr) {
           value = evaluate(initializer);
       }
-      methods[name->lexeme] = value;
+      methods[name->symbol] = value;
   }
   
-  std::unordered_map<std::string, ObjPtr> classMethods;
+  std::unordered_map<Symbol, LukObject> classMethods;
   // Adding classmethods into the class map
   for (auto meth: stmt.m_classMethods) {
-    auto func = std::make_shared<LukFunction>(meth->m_name->lexeme, 
+    auto func = makeRef<LukFunction>(std::string(meth->m_name->lexeme), 
         meth->m_function, m_env, false);
-    auto obj_ptr = std::make_shared<LukObject>(func);
-    classMethods[meth->m_name->lexeme] = obj_ptr;
+    auto obj_ptr = LukObject(func);
+    classMethods[meth->m_name->symbol] = obj_ptr;
   }
   // in this klass, metaklass and superklass are null
-  auto metaKlass = std::make_shared<LukClass>(nullptr, 
-      stmt.m_name->lexeme + " metaclass", 
+  auto metaKlass = makeRef<LukClass>(nullptr, 
+      std::string(stmt.m_name->lexeme) + " metaclass", 
       nullptr, classMethods);
 
   // Adding methods into the class map
   for (auto meth: stmt.m_methods) {
-    auto func = std::make_shared<LukFunction>(meth->m_name->lexeme, 
+    auto func = makeRef<LukFunction>(std::string(meth->m_name->lexeme), 
         meth->m_function, m_env,
-        meth->m_name->lexeme == "init");
-    logMsg("func name: ", func->toString());
-    auto obj_ptr = std::make_shared<LukObject>(func);
-    logMsg("obj_ptr type: ", obj_ptr->getType());
-    logMsg("ObjPtr callable: ", obj_ptr->getCallable()->toString());
-    logMsg("Adding meth to methods map: ", meth->m_name->lexeme);
-    methods[meth->m_name->lexeme] = obj_ptr;
+        meth->m_name->symbol == SymbolTable::Init);
+    LOG_MSG(cat_INTERP, "func name: ", func->toString());
+    auto obj_ptr = LukObject(func);
+    LOG_MSG(cat_INTERP, "obj_ptr type: ", obj_ptr.getType());
+    LOG_MSG(cat_INTERP, "LukObject callable: ", obj_ptr.getCallable()->toString());
+    LOG_MSG(cat_INTERP, "Adding meth to methods map: ", meth->m_name->lexeme);
+    methods[meth->m_name->symbol] = obj_ptr;
   }
-  auto klass = std::make_shared<LukClass>(metaKlass, stmt.m_name->lexeme, 
+  auto klass = makeRef<LukClass>(metaKlass, std::string(stmt.m_name->lexeme), 
       supKlass, methods);
   if (stmt.m_superclass != nullptr) {
     // Note: moving m_enclosing from private to public in Environment object
     m_env = m_env->m_enclosing;
   }
-  logMsg("Assign klass: ", stmt.m_name, ", to m_env");
-  m_env->assign(stmt.m_name, klass);
-logMsg("Exit out visitClassStmt\n");
+  LOG_MSG(cat_INTERP, "Assign klass: ", stmt.m_name, ", to m_env");
+  if (stmt.m_slot >= 0) m_env->defineSlot(stmt.m_slot, LukObject(klass));
+  else m_env->assign(stmt.m_name, klass);
+LOG_MSG(cat_INTERP, "Exit out visitClassStmt\n");
 }
 
 void Interpreter::visitExpressionStmt(ExpressionStmt& stmt) {
@@ -857,12 +1128,12 @@ void Interpreter::visitExpressionStmt(ExpressionStmt& stmt) {
 }
 
 void Interpreter::visitFunctionStmt(FunctionStmt& stmt) {
-    auto func = std::make_shared<LukFunction>(stmt.m_name->lexeme, 
+    auto func = makeRef<LukFunction>(std::string(stmt.m_name->lexeme), 
         stmt.m_function, 
         m_env, false);
-    ObjPtr objP = std::make_shared<LukObject>(func);
-    m_env->define(stmt.m_name->lexeme, objP);
-    logMsg("FunctionExpr use_count: ", stmt.m_function.use_count());
+    LukObject objP = LukObject(func);
+    defineVariable(stmt.m_name, stmt.m_slot, objP);
+    LOG_MSG(cat_INTERP, "FunctionExpr use_count: ", stmt.m_function.use_count());
     
 }
 
@@ -879,82 +1150,105 @@ void Interpreter::visitIfStmt(IfStmt& stmt) {
 }
 
 void Interpreter::visitPrintStmt(PrintStmt& stmt) {
-    // ObjPtr value = evaluate(stmt.m_expression);
+    // LukObject value = evaluate(stmt.m_expression);
     std::string msg;
     for (auto& arg: stmt.m_args) {
-        msg += evaluate(arg)->toString();
+        evaluate(arg).appendTo(msg);
     }
-    ObjPtr value = std::make_shared<LukObject>(msg);
-    // Note: printing obj->toString instead *obj pointer
-    // to avoid multiple object's destructors 
-    logMsg("\nIn visitprint: id: ", value->getId(), ", value: ", value->toString());
-    std::cout << stringify(value) << std::endl;
-    m_result = nilptr;
+    // Note: an empty message is printed with its quotes, like an empty string value
+    if (msg.empty()) msg = "''";
+    LOG_MSG(cat_INTERP, "\nIn visitprint: msg: ", msg);
+    std::cout << msg << std::endl;
+    m_result = LukObject();
 
 }
 
 void Interpreter::visitReturnStmt(ReturnStmt& stmt) {
-    ObjPtr value = nilptr;
+    LukObject value = LukObject();
     if (stmt.m_value != nullptr) { 
         value = evaluate(stmt.m_value);
     }
        
-    throw Return(value);
+    m_retValue = value;
+    m_completion = Completion::Return;
 }
 
 
 void Interpreter::visitVarStmt(VarStmt& stmt) {
-    // Note: new ObjPtr needs to be initialized to nilptr to avoid crash
-    ObjPtr value = nilptr;
+    LukObject value = LukObject();
     TokPtr name;
     ExprPtr initializer;
-    for (auto& it: stmt.m_vars) {
-        value = nilptr;
-        name = it.first;
-        initializer = it.second;
+    for (size_t i=0; i < stmt.m_vars.size(); ++i) {
+        value = LukObject();
+        name = stmt.m_vars[i].first;
+        initializer = stmt.m_vars[i].second;
         if (initializer != nullptr) {
             value = evaluate(initializer);
         }
-        m_env->define(name->lexeme, value);
+        defineVariable(name, i < stmt.m_slots.size() ? stmt.m_slots[i] : -1, value);
     }
 
     // log environment state for debugging
     logState();
 }
 
-void Interpreter::visitWhileStmt(WhileStmt& stmt) {
-    auto val  = evaluate(stmt.m_condition);
-    // isWhile variable indicates whether is an while loop or a do-while loop
-    if (stmt.m_isWhile) {
-        while (isTruthy(val)) {
-            try {
-                execute(stmt.m_body);
-                val  = evaluate(stmt.m_condition);
-                // Note: catching must be by reference, not by value
-            } catch(Jump& jmp) {
-                if (jmp.m_keyword->lexeme == "break") break;
-                if (jmp.m_keyword->lexeme == "continue") continue;
+void Interpreter::visitForInStmt(ForInStmt& stmt) {
+    LukObject iterable = evaluate(stmt.m_iterable);
+    TLukInt position = iterStart(iterable, stmt.m_keyword);
+    auto previous = m_env;
+    // Note: a single environment for the whole loop, the value is written in the slot
+    // of the loop variable at each step, so a range counter is never boxed
+    m_env = std::make_shared<Environment>(previous);
+    try {
+        m_env->defineSlot(stmt.m_slot, LukObject());
+        LukObject& var = m_env->getAt(0, stmt.m_slot);
+        while (iterNext(iterable, position, var)) {
+            execute(stmt.m_body);
+            if (m_completion == Completion::Normal) continue;
+            if (m_completion == Completion::Break) {
+                m_completion = Completion::Normal;
+                break;
             }
-        
-        }
-    } else {
-        do {
-            try {
-                execute(stmt.m_body);
-                val  = evaluate(stmt.m_condition);
-                // Note: catching must be by reference, not by value
-            } catch(Jump& jmp) {
-                if (jmp.m_keyword->lexeme == "break") break;
-                if (jmp.m_keyword->lexeme == "continue") continue;
+            if (m_completion == Completion::Continue) {
+                m_completion = Completion::Normal;
+                continue;
             }
+            // returning from a function, the status is handled by the function call
+            break;
+        }
+    } catch(...) {
+        m_env = previous;
+        throw;
+    }
+    m_env = previous;
+    m_result = LukObject();
+}
 
-        } while (isTruthy(val));
+void Interpreter::visitWhileStmt(WhileStmt& stmt) {
+    // isWhile variable indicates whether is an while loop or a do-while loop
+    // Note: the do-while loop executes its body before testing the condition
+    bool isFirst = !stmt.m_isWhile;
+    while (isFirst || isTruthy(evaluate(stmt.m_condition))) {
+        isFirst = false;
+        execute(stmt.m_body);
+        if (m_completion == Completion::Normal) continue;
+        if (m_completion == Completion::Break) {
+            m_completion = Completion::Normal;
+            break;
+        }
+        if (m_completion == Completion::Continue) {
+            m_completion = Completion::Normal;
+            continue;
+        }
+        // returning from a function, the status is handled by the function call
+        break;
     }
 
 }
 
 std::string Interpreter::multiplyString(const std::string& str, const int num) {
     std::string result = "";
+    if (num > 0) result.reserve(str.size() * num);
     for (int i=0; i < num; i++) {
         result += str;
     }
@@ -962,15 +1256,15 @@ std::string Interpreter::multiplyString(const std::string& str, const int num) {
     return result;
 }
 
-std::string Interpreter::format(ObjPtr& obj) { 
+std::string Interpreter::format(const LukObject& obj) { 
   return stringify(obj);
 }
 
-std::string Interpreter::stringify(ObjPtr& obj) { 
-    logMsg("\nIn stringify, obj id: ", obj->getId(), ", val: ", obj->toString());
-    // if (obj->isNil() || obj->isBool()) return obj->toString();
-    if (obj->isDouble()) {
-        std::string str = obj->toString(); 
+std::string Interpreter::stringify(const LukObject& obj) { 
+    LOG_MSG(cat_INTERP, "\nIn stringify, val: ", obj.toString());
+    // if (obj.isNil() || obj.isBool()) return obj.toString();
+    if (obj.isDouble()) {
+        std::string str = obj.toString(); 
         // erasing trailing zeros
         auto pos = str.find_last_not_of('0');
         // keeping the first zero whether they are only zeros after the dot
@@ -981,7 +1275,7 @@ std::string Interpreter::stringify(ObjPtr& obj) {
      } 
     
    
-    logMsg("\nExit out stringify \n");
-    return obj->toString();
+    LOG_MSG(cat_INTERP, "\nExit out stringify \n");
+    return obj.toString();
 }
 
@@ -7,53 +7,109 @@
 #include "environment.hpp"
 #include "lukerror.hpp"
 
+#include <memory>
 #include <string>
 #include <vector>
 #include <unordered_map>
 namespace luky {
+    /// Note: completion status of the last executed statement,
+    /// return, break and continue statements are propagated by this status instead of exceptions.
+    enum class Completion {
+        Normal, Return, Break, Continue
+    };
+
+    class Chunk;
+    class LukVM;
+
     class Interpreter : public ExprVisitor,  public StmtVisitor {
+        // Note: the VM sets the last expression result
+        friend class LukVM;
     public:
         EnvPtr m_globals;
         LukError& m_lukErr;
+        Completion m_completion = Completion::Normal;
+        // value of the last return statement
+        LukObject m_retValue;
 
         Interpreter(LukError& lukErr);
         ~Interpreter() { 
-          logMsg("\n~Interpreter destructor\n");
+          LOG_MSG(cat_INTERP, "\n~Interpreter destructor\n");
         }
 
         void interpret(std::vector<std::shared_ptr<Stmt>> statements);
+        // Note: in VM mode, statements are compiled to bytecode and run by the VM
+        void setVMMode(bool vmMode) { m_vmMode = vmMode; }
+        bool isVMMode() const { return m_vmMode; }
+        LukObject runChunk(Chunk& chunk, EnvPtr env);
         void printResult();
         void logState();
-        void logTest();
 
-        ObjPtr evaluate(ExprPtr expr);
+        LukObject evaluate(ExprPtr expr);
         void execute(StmtPtr& stmt);
        
         // expressions
-        ObjPtr visitAssignExpr(AssignExpr& expr) override;
-        ObjPtr visitBinaryExpr(BinaryExpr& expr) override;
-        ObjPtr visitCallExpr(CallExpr& expr) override;
-        ObjPtr visitFunctionExpr(FunctionExpr& expr);
-        ObjPtr visitGetExpr(GetExpr& expr);
-        ObjPtr visitGroupingExpr(GroupingExpr& expr) override;
-        ObjPtr visitInterpolateExpr(InterpolateExpr& expr);
-        ObjPtr visitLiteralExpr(LiteralExpr& expr) override; 
-        ObjPtr visitLogicalExpr(LogicalExpr& expr) override;
-        ObjPtr visitSetExpr(SetExpr& expr);
-        ObjPtr visitSuperExpr(SuperExpr& expr);
-        ObjPtr visitTernaryExpr(TernaryExpr& expr);
-        ObjPtr visitThisExpr(ThisExpr& expr);
-        ObjPtr visitUnaryExpr(UnaryExpr& expr) override;
-        ObjPtr visitVariableExpr(VariableExpr& expr) override;
+        LukObject visitAssignExpr(AssignExpr& expr) override;
+        LukObject visitBinaryExpr(BinaryExpr& expr) override;
+        LukObject visitCallExpr(CallExpr& expr) override;
+        LukObject visitFunctionExpr(FunctionExpr& expr);
+        LukObject visitGetExpr(GetExpr& expr);
+        LukObject visitGroupingExpr(GroupingExpr& expr) override;
+        LukObject visitIndexExpr(IndexExpr& expr) override;
+        LukObject visitInterpolateExpr(InterpolateExpr& expr);
+        LukObject visitInvokeExpr(InvokeExpr& expr) override;
+        LukObject visitListExpr(ListExpr& expr) override;
+        LukObject visitLiteralExpr(LiteralExpr& expr) override; 
+        LukObject visitLogicalExpr(LogicalExpr& expr) override;
+        LukObject visitMapExpr(MapExpr& expr) override;
+        LukObject visitSetExpr(SetExpr& expr);
+        LukObject visitSetIndexExpr(SetIndexExpr& expr) override;
+        LukObject visitSuperExpr(SuperExpr& expr);
+        LukObject visitTernaryExpr(TernaryExpr& expr);
+        LukObject visitThisExpr(ThisExpr& expr);
+        LukObject visitUnaryExpr(UnaryExpr& expr) override;
+        LukObject visitVariableExpr(VariableExpr& expr) override;
 
-        void resolve(Expr& expr, int depth);
         void executeBlock(std::vector<StmtPtr>& statements, EnvPtr env);
+
+        // operations shared with the bytecode VM
+        LukObject binaryOp(TokPtr& op, const LukObject& left, const LukObject& right);
+        LukObject unaryOp(TokPtr& op, const LukObject& right);
+        void compoundAssign(LukObject& var, TokPtr& op, const LukObject& value);
+        // Note: cache is the inline cache of the access site, nullptr to search without cache
+        LukObject getProperty(const LukObject& obj, TokPtr& name, InlineCache* cache=nullptr);
+        LukObject setProperty(const LukObject& obj, TokPtr& name, const LukObject& value, 
+                InlineCache* cache=nullptr);
+        LukObject superMethod(Environment& env, int distance, int slot, int thisDistance, TokPtr& name,
+                InlineCache* cache=nullptr);
+        LukObject getMethod(const LukObject& obj, TokPtr& name, bool& isMethod, 
+                InlineCache* cache=nullptr);
+        // Note: reference to the item of a list or the value of a map key, 
+        // valid until the list is resized or the map gets a new key
+        LukObject& itemRef(const LukObject& obj, const LukObject& index);
+        // Note: value of an item, the typed arrays have no reference to their unboxed values
+        LukObject getItem(const LukObject& obj, const LukObject& index);
+        LukObject setItem(const LukObject& obj, const LukObject& index,
+                TokPtr& equals, const LukObject& value);
+        // Note: new map from count keys and values, stored alternately in items
+        LukObject buildMap(TokPtr& brace, const LukObject* items, size_t count);
+        // Note: iteration of the for-in loop, without building an iterator object.
+        // The position is the current value of a range, or the index in a list or an array.
+        TLukInt iterStart(const LukObject& iterable, TokPtr& keyword);
+        // stores the current value in out and advances the position, returns false at the end
+        bool iterNext(const LukObject& iterable, TLukInt& position, LukObject& out);
+        // Note: a nil bound is omitted
+        LukObject sliceList(const LukObject& obj, const LukObject& start, const LukObject& end);
+        void checkArity(const LukObject& callee, size_t argCount);
+        void setKeyword(LukCallable* func, const TokPtr& keyword, const LukObject& value);
+        bool isTruthy(const LukObject& obj);
+        std::string stringify(const LukObject& obj);
         //
         // statements    
         void visitBlockStmt(BlockStmt& stmt) override;
         void visitBreakStmt(BreakStmt& stmt) override;
         void visitClassStmt(ClassStmt& stmt) override;
         void visitExpressionStmt(ExpressionStmt&) override;
+        void visitForInStmt(ForInStmt& stmt) override;
         void visitFunctionStmt(FunctionStmt& stmt) override;
         void visitIfStmt(IfStmt& stmt) override;
         void visitPrintStmt(PrintStmt&) override;
@@ -63,15 +119,25 @@ namespace luky {
      
     private:
         EnvPtr m_env;
-        ObjPtr m_result;
+        LukObject m_result;
+        bool m_vmMode = false;
+        std::shared_ptr<LukVM> p_vm;
         const std::string m_errTitle = "InterpretError: ";
-        std::unordered_map<unsigned, int> m_locals;
 
-        bool isTruthy(ObjPtr& obj);
-        bool isEqual(ObjPtr& a, ObjPtr& b);
-        void checkNumberOperand(TokPtr& op, ObjPtr& operand);
-        void checkNumberOperands(TokPtr& op, ObjPtr& left, ObjPtr& right);
-        ObjPtr lookUpVariable(TokPtr& name, Expr& expr);
+        bool isEqual(const LukObject& a, const LukObject& b);
+        void checkNumberOperand(TokPtr& op, const LukObject& operand);
+        void checkNumberOperands(TokPtr& op, const LukObject& left, const LukObject& right);
+        // specialization of the binary and unary nodes
+        static QuickOp quickenBinary(TokenType op, const LukObject& left, const LukObject& right);
+        static std::string concatStrings(const LukObject& left, const LukObject& right);
+        LukObject unaryExpr(UnaryExpr& expr, const LukObject& right);
+        LukObject lookUpVariable(TokPtr& name, Expr& expr);
+        LukObject& variableRef(TokPtr& name, Expr& expr);
+        void assignVariable(TokPtr& name, Expr& expr, const LukObject& value);
+        void defineVariable(TokPtr& name, int slot, const LukObject& value);
+        LukObject callArguments(const LukObject& callee, TokPtr& paren, 
+                std::vector<ExprPtr>& args, std::map<TokPtr, ExprPtr>& keywords, 
+                const LukObject* thisObj);
 
         // starts and ends for string
         inline bool startsWith(const std::string& str, const std::string& start) {
@@ -85,9 +151,8 @@ namespace luky {
         }
 
         
-        std::string format(ObjPtr& obj);
+        std::string format(const LukObject& obj);
         std::string multiplyString(const std::string& str, const int num);
-        std::string stringify(ObjPtr& obj);
 
     };
 }
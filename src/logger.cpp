@@ -1,3 +1,22 @@
 #include "logger.hpp"
 TLog LogConf = TLog();
 
+bool setLogCategories(const std::string& names) {
+  unsigned categories = cat_NONE;
+  std::istringstream iss(names);
+  std::string name;
+  while (std::getline(iss, name, ',')) {
+    if (name == "scanner") categories |= cat_SCANNER;
+    else if (name == "parser") categories |= cat_PARSER;
+    else if (name == "resolver") categories |= cat_RESOLVER;
+    else if (name == "interp") categories |= cat_INTERP;
+    else if (name == "env") categories |= cat_ENV;
+    else if (name == "object") categories |= cat_OBJECT;
+    else if (name == "all") categories |= cat_ALL;
+    else return false;
+  }
+  LogConf.categories = categories;
+  LogConf.level = log_DEBUG;
+
+  return true;
+}
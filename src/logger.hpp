@@ -9,23 +9,46 @@
 
 // #define DEBUG  1 
 // Simple object logging
+// Note: a message is printed whether its level is at least the configured level,
+// log_OFF prints nothing
 enum TLogLevel { 
-  log_OFF, log_DEBUG, log_INFO, log_WARN, log_ERROR 
+  log_DEBUG, log_INFO, log_WARN, log_ERROR, log_OFF
+};
+
+// Note: subsystems of the debug messages, one bit each, selected from the command line
+enum TLogCat : unsigned {
+  cat_NONE =0,
+  cat_SCANNER = 1u << 0,
+  cat_PARSER = 1u << 1,
+  cat_RESOLVER = 1u << 2,
+  cat_INTERP = 1u << 3,
+  cat_ENV = 1u << 4,
+  cat_OBJECT = 1u << 5,
+  cat_ALL = (1u << 6) -1
 };
 
 struct TLog {
   bool headers = false;
   TLogLevel level = log_OFF;
+  unsigned categories = cat_ALL;
 };
 
 extern TLog LogConf;
 
+inline bool logEnabled(TLogCat cat, TLogLevel level=log_DEBUG) {
+  return LogConf.level != log_OFF && level >= LogConf.level && (LogConf.categories & cat) != 0;
+}
+
+// Note: parses a list of categories separated by commas, like "scanner,parser" or "all",
+// enables the debug messages of these categories, returns false on an unknown name
+bool setLogCategories(const std::string& names);
+
 class CLog {
 public:
   CLog() : m_level(log_DEBUG) {} // { CLog(log_DEBUG); }
   CLog(TLogLevel level) {
     m_level = level;
-    if (m_level > log_OFF && m_level <= LogConf.level && LogConf.headers) {
+    if (m_level != log_OFF && m_level >= LogConf.level && LogConf.headers) {
       dateNow();
       operator << (" [" + getLabel(level) + "] ");
     }
@@ -38,14 +61,11 @@ public:
     m_opened = false;
   }
 
-  static void initLog() {
-    LogConf.level = log_DEBUG;
-  }
 
   
   template <class T>
   CLog &operator <<(const T &msg) {
-    if (m_level > log_OFF && m_level <= LogConf.level) {
+    if (m_level != log_OFF && LogConf.level != log_OFF && m_level >= LogConf.level) {
         std::cerr << msg;
         m_opened = true;
     }
@@ -115,37 +135,32 @@ private:
 // std::string CTracer::m_in {"Enter "};
 // std::string CTracer::m_out {"Exit "};
 
-// inused function for inused variables specially for the macros
-template <typename... T> 
-void inused(T&&...) {}
-// variadic template
+// variadic template, prints the arguments separated by spaces
+// Note: called only by the LOG_MSG macro, after checking the category
 // base case
 template <typename T>
-void logMsg(T val) {
-  // if (LogConf.level >= log_DEBUG) {
-#ifndef DEBUG
-  inused(val);
-#endif
-#ifdef DEBUG // {
+void logArgs(const T& val) {
     std::cerr << val << "\n";
-  // }
-#endif
 }
 
 // recursive case
 template <typename T, typename... TArgs>
-void logMsg(T first, TArgs... args) {
-  // if (LogConf.level >= log_DEBUG) {
-#ifndef DEBUG
-  inused(first, args...);
-#endif
-#ifdef DEBUG // {
+void logArgs(const T& first, const TArgs&... args) {
     std::cerr << first << " ";
-    logMsg(args...);
-  // }
-#endif
+    logArgs(args...);
 }
 
+// Note: debug message of a category, like: LOG_MSG(cat_SCANNER, "token: ", tok->lexeme);
+// The arguments are evaluated only whether the category is enabled at runtime,
+// without DEBUG the condition is false at compile time, so the call compiles to nothing,
+// the arguments are still type checked, so the variables used only for logging stay used.
+#ifdef DEBUG
+    #define LOG_ENABLED(cat) logEnabled(cat)
+#else
+    #define LOG_ENABLED(cat) false
+#endif
+#define LOG_MSG(cat, ...) do { if (LOG_ENABLED(cat)) logArgs(__VA_ARGS__); } while (false)
+
 // print type name
 template <typename T>
 void logType(const std::string& msg, T val) {
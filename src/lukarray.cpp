@@ -0,0 +1,265 @@
+#include "lukarray.hpp"
+#include "luklist.hpp"
+#include "runtimeerror.hpp"
+
+#include <algorithm> // fill, min, max
+#include <cmath> // ceil
+#include <cstring> // memcpy, memset
+#include <new> // align_val_t
+
+using namespace luky;
+
+LukArray::LukArray(ArrayKind kind, size_t size)
+        : m_kind(kind), m_size(size) {
+    if (size > (SIZE_MAX - Alignment) / sizeof(double)) throw RuntimeError("Array size is too large.");
+    // Note: the buffer is rounded up to whole registers
+    size_t bytes = (size * sizeof(double) + Alignment -1) / Alignment * Alignment;
+    if (bytes == 0) bytes = Alignment;
+    p_data = ::operator new(bytes, std::align_val_t(Alignment));
+    std::memset(p_data, 0, bytes);
+}
+
+LukArray::~LukArray() {
+    ::operator delete(p_data, std::align_val_t(Alignment));
+}
+
+const char* LukArray::kindName() const noexcept {
+    return isFloat() ? "Float64Array" : "Int64Array";
+}
+
+LukObject LukArray::get(TLukInt index) const {
+    TLukInt size = static_cast<TLukInt>(m_size);
+    if (index < 0) index += size;
+    if (index < 0 || index >= size) throw RuntimeError("Array index out of range.");
+    if (isFloat()) return LukObject(doubles()[index]);
+
+    return LukObject(TLukInt(ints()[index]));
+}
+
+void LukArray::set(TLukInt index, const LukObject& val) {
+    TLukInt size = static_cast<TLukInt>(m_size);
+    if (index < 0) index += size;
+    if (index < 0 || index >= size) throw RuntimeError("Array index out of range.");
+    if (isFloat()) {
+        if (!val.isNumber()) throw RuntimeError("Float64Array value must be a number.");
+        doubles()[index] = val.getNumber();
+    } else {
+        if (!val.isInt()) throw RuntimeError("Int64Array value must be an integer.");
+        ints()[index] = val.getInt();
+    }
+}
+
+void LukArray::fill(const LukObject& val) {
+    if (isFloat()) {
+        if (!val.isNumber()) throw RuntimeError("Float64Array value must be a number.");
+        std::fill(doubles(), doubles() + m_size, val.getNumber());
+    } else {
+        if (!val.isInt()) throw RuntimeError("Int64Array value must be an integer.");
+        std::fill(ints(), ints() + m_size, val.getInt());
+    }
+}
+
+LukRef<LukArray> LukArray::slice(TLukInt start, TLukInt end) const {
+    TLukInt size = static_cast<TLukInt>(m_size);
+    if (start < 0) start = std::max(start + size, TLukInt(0));
+    if (end < 0) end = std::max(end + size, TLukInt(0));
+    start = std::min(start, size);
+    end = std::min(end, size);
+    size_t count = start < end ? static_cast<size_t>(end - start) : 0;
+    auto result = makeRef<LukArray>(m_kind, count);
+    if (count > 0) {
+        std::memcpy(result->p_data, static_cast<const char*>(p_data) + start * sizeof(double),
+                count * sizeof(double));
+    }
+
+    return result;
+}
+
+LukRef<LukArray> LukArray::fromList(ArrayKind kind, LukList& list) {
+    auto& items = list.getItems();
+    auto result = makeRef<LukArray>(kind, items.size());
+    for (size_t i=0; i < items.size(); ++i) {
+        result->set(static_cast<TLukInt>(i), items[i]);
+    }
+
+    return result;
+}
+
+// Note: a Float64Array converted to an Int64Array is truncated, like int()
+LukRef<LukArray> LukArray::fromArray(ArrayKind kind, const LukArray& other) {
+    auto result = makeRef<LukArray>(kind, other.m_size);
+    if (kind == other.m_kind) {
+        std::memcpy(result->p_data, other.p_data, other.m_size * sizeof(double));
+    } else if (kind == ArrayKind::Float64) {
+        for (size_t i=0; i < other.m_size; ++i) result->doubles()[i] = double(other.ints()[i]);
+    } else {
+        for (size_t i=0; i < other.m_size; ++i) result->ints()[i] = int64_t(other.doubles()[i]);
+    }
+
+    return result;
+}
+
+LukRef<LukArray> LukArray::range(ArrayKind kind, const LukObject& start,
+        const LukObject& stop, const LukObject& step) {
+    if (kind == ArrayKind::Int64) {
+        if (!start.isInt() || !stop.isInt() || !step.isInt())
+            throw RuntimeError("Int64Array range bounds must be integers.");
+        TLukInt first = start.getInt();
+        TLukInt last = stop.getInt();
+        TLukInt by = step.getInt();
+        if (by == 0) throw RuntimeError("Range step cannot be zero.");
+        size_t count =0;
+        if (by > 0 && first < last) count = static_cast<size_t>((last - first + by -1) / by);
+        else if (by < 0 && first > last) count = static_cast<size_t>((first - last - by -1) / -by);
+        auto result = makeRef<LukArray>(kind, count);
+        int64_t* values = result->ints();
+        for (size_t i=0; i < count; ++i) values[i] = first + static_cast<TLukInt>(i) * by;
+
+        return result;
+    }
+
+    if (!start.isNumber() || !stop.isNumber() || !step.isNumber())
+        throw RuntimeError("Float64Array range bounds must be numbers.");
+    double first = start.getNumber();
+    double by = step.getNumber();
+    if (by == 0) throw RuntimeError("Range step cannot be zero.");
+    double steps = std::ceil((stop.getNumber() - first) / by);
+    size_t count = steps > 0 ? static_cast<size_t>(steps) : 0;
+    auto result = makeRef<LukArray>(kind, count);
+    double* values = result->doubles();
+    // Note: each value is computed from the start, so the errors of the step do not add up
+    for (size_t i=0; i < count; ++i) values[i] = first + double(i) * by;
+
+    return result;
+}
+
+const double* LukArray::asDoubles(std::vector<double>& tmp) const {
+    if (isFloat()) return doubles();
+    tmp.resize(m_size);
+    for (size_t i=0; i < m_size; ++i) tmp[i] = double(ints()[i]);
+
+    return tmp.data();
+}
+
+// Note: checks the second operand of the array functions
+static const LukArray* arrayOperand(const LukArray& a, const LukObject& b) {
+    if (b.isArray()) {
+        const LukArray* other = b.getArray();
+        if (other->size() != a.size()) throw RuntimeError("Arrays must have the same size.");
+        return other;
+    }
+    if (!b.isNumber()) throw RuntimeError("Operand must be a number or an array.");
+
+    return nullptr;
+}
+
+LukRef<LukArray> LukArray::binary(simd::Op op, const LukArray& a, const LukObject& b) {
+    const LukArray* other = arrayOperand(a, b);
+    bool intResult = !a.isFloat() && op != simd::Op::Div &&
+        (other ? !other->isFloat() : b.isInt());
+    auto result = makeRef<LukArray>(intResult ? ArrayKind::Int64 : ArrayKind::Float64, a.m_size);
+    if (intResult) {
+        if (other) {
+            simd::binary(op, a.ints(), other->ints(), false, result->ints(), a.m_size);
+        } else {
+            int64_t val = b.getInt();
+            simd::binary(op, a.ints(), &val, true, result->ints(), a.m_size);
+        }
+        return result;
+    }
+
+    std::vector<double> tmpA, tmpB;
+    const double* values = a.asDoubles(tmpA);
+    if (other) {
+        simd::binary(op, values, other->asDoubles(tmpB), false, result->doubles(), a.m_size);
+    } else {
+        double val = b.getNumber();
+        simd::binary(op, values, &val, true, result->doubles(), a.m_size);
+    }
+
+    return result;
+}
+
+LukRef<LukArray> LukArray::compare(const LukArray& a, const LukObject& b) {
+    const LukArray* other = arrayOperand(a, b);
+    auto result = makeRef<LukArray>(ArrayKind::Int64, a.m_size);
+    if (!a.isFloat() && (other ? !other->isFloat() : b.isInt())) {
+        if (other) {
+            simd::compare(a.ints(), other->ints(), false, result->ints(), a.m_size);
+        } else {
+            int64_t val = b.getInt();
+            simd::compare(a.ints(), &val, true, result->ints(), a.m_size);
+        }
+        return result;
+    }
+
+    std::vector<double> tmpA, tmpB;
+    const double* values = a.asDoubles(tmpA);
+    if (other) {
+        simd::compare(values, other->asDoubles(tmpB), false, result->ints(), a.m_size);
+    } else {
+        double val = b.getNumber();
+        simd::compare(values, &val, true, result->ints(), a.m_size);
+    }
+
+    return result;
+}
+
+LukObject LukArray::sum() const {
+    if (isFloat()) return LukObject(simd::sum(doubles(), m_size));
+
+    return LukObject(TLukInt(simd::sum(ints(), m_size)));
+}
+
+LukObject LukArray::min() const {
+    if (m_size == 0) throw RuntimeError("min() of empty array.");
+    if (isFloat()) return LukObject(simd::min(doubles(), m_size));
+
+    return LukObject(TLukInt(simd::min(ints(), m_size)));
+}
+
+LukObject LukArray::max() const {
+    if (m_size == 0) throw RuntimeError("max() of empty array.");
+    if (isFloat()) return LukObject(simd::max(doubles(), m_size));
+
+    return LukObject(TLukInt(simd::max(ints(), m_size)));
+}
+
+LukObject LukArray::dot(const LukArray& a, const LukArray& b) {
+    if (a.m_size != b.m_size) throw RuntimeError("Arrays must have the same size.");
+    if (!a.isFloat() && !b.isFloat()) return LukObject(TLukInt(simd::dot(a.ints(), b.ints(), a.m_size)));
+    std::vector<double> tmpA, tmpB;
+
+    return LukObject(simd::dot(a.asDoubles(tmpA), b.asDoubles(tmpB), a.m_size));
+}
+
+void LukArray::scale(const LukObject& factor) {
+    if (isFloat()) {
+        if (!factor.isNumber()) throw RuntimeError("Float64Array can only be scaled by a number.");
+        double val = factor.getNumber();
+        simd::binary(simd::Op::Mul, doubles(), &val, true, doubles(), m_size);
+    } else {
+        if (!factor.isInt()) throw RuntimeError("Int64Array can only be scaled by an integer.");
+        int64_t val = factor.getInt();
+        simd::binary(simd::Op::Mul, ints(), &val, true, ints(), m_size);
+    }
+}
+
+bool LukArray::equals(const LukArray& other) const {
+    if (this == &other) return true;
+    if (m_kind != other.m_kind || m_size != other.m_size) return false;
+    if (isFloat()) return std::equal(doubles(), doubles() + m_size, other.doubles());
+
+    return std::equal(ints(), ints() + m_size, other.ints());
+}
+
+std::string LukArray::toString() const {
+    std::string result = "[";
+    for (size_t i=0; i < m_size; ++i) {
+        if (i > 0) result += ", ";
+        get(static_cast<TLukInt>(i)).appendTo(result);
+    }
+    result += "]";
+
+    return result;
+}
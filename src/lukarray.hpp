@@ -0,0 +1,81 @@
+#ifndef LUKARRAY_HPP
+#define LUKARRAY_HPP
+
+#include "common.hpp"
+#include "lukheap.hpp"
+#include "lukobject.hpp"
+#include "simd.hpp"
+
+#include <cstdint> // int64_t
+#include <string>
+#include <vector>
+
+namespace luky {
+    class LukList;
+
+    enum class ArrayKind { Float64, Int64 };
+
+    /// Note: typed numeric array, Float64Array or Int64Array.
+    /// The values are stored unboxed in a buffer aligned for the SIMD registers,
+    /// so a whole array is processed by a single kernel of simd.hpp,
+    /// instead of a loop of boxed values in the interpreter.
+    /// The array holds only numbers, so it cannot be part of a cycle,
+    /// and is not tracked by the cycle collector.
+    class LukArray : public LukHeap {
+    public:
+        // Note: the values are zeroed
+        LukArray(ArrayKind kind, size_t size);
+        ~LukArray();
+        LukArray(const LukArray&) = delete;
+        LukArray& operator=(const LukArray&) = delete;
+
+        ArrayKind kind() const noexcept { return m_kind; }
+        bool isFloat() const noexcept { return m_kind == ArrayKind::Float64; }
+        const char* kindName() const noexcept;
+        size_t size() const noexcept { return m_size; }
+        double* doubles() const noexcept { return static_cast<double*>(p_data); }
+        int64_t* ints() const noexcept { return static_cast<int64_t*>(p_data); }
+
+        // Note: a negative index counts from the end, throws whether the index is out of range
+        LukObject get(TLukInt index) const;
+        // throws whether the value is not a number, or not an int for an Int64Array
+        void set(TLukInt index, const LukObject& val);
+        void fill(const LukObject& val);
+        // Note: new array with the values from start to end excluded, like the list slices
+        LukRef<LukArray> slice(TLukInt start, TLukInt end) const;
+
+        static LukRef<LukArray> fromList(ArrayKind kind, LukList& list);
+        static LukRef<LukArray> fromArray(ArrayKind kind, const LukArray& other);
+        // Note: values from start to stop excluded, by step, without boxing them
+        static LukRef<LukArray> range(ArrayKind kind, const LukObject& start,
+                const LukObject& stop, const LukObject& step);
+
+        // Note: b is an array of the same size or a number, applied to each value.
+        // The result is an Int64Array only whether both operands are ints, and op is not Div.
+        static LukRef<LukArray> binary(simd::Op op, const LukArray& a, const LukObject& b);
+        // new Int64Array of -1, 0 or 1, whether each value is lesser, equal or greater than b
+        static LukRef<LukArray> compare(const LukArray& a, const LukObject& b);
+        LukObject sum() const;
+        // Note: throws whether the array is empty
+        LukObject min() const;
+        LukObject max() const;
+        static LukObject dot(const LukArray& a, const LukArray& b);
+        // multiplies the values in place
+        void scale(const LukObject& factor);
+
+        bool equals(const LukArray& other) const;
+        std::string toString() const;
+
+    private:
+        static constexpr size_t Alignment = 32;
+
+        // the values as doubles, converted in tmp whether the array is an Int64Array
+        const double* asDoubles(std::vector<double>& tmp) const;
+
+        ArrayKind m_kind;
+        size_t m_size;
+        void* p_data;
+    };
+}
+
+#endif // LUKARRAY_HPP
@@ -2,6 +2,8 @@
 #define LUKCALLABLE_HPP
 
 #include "common.hpp"
+#include "lukheap.hpp"
+#include "lukobject.hpp"
 
 #include <string>
 #include <vector>
@@ -12,12 +14,12 @@
 
 namespace luky {
     class Interpreter;
-    using VArguments = std::vector<ObjPtr>;
+    using VArguments = std::vector<LukObject>;
 
-    class LukCallable {
+    class LukCallable : public LukHeap {
     public:
         LukCallable() {}
-        ~LukCallable() {}
+        virtual ~LukCallable() {}
         
         virtual std::string addressOf() {  
             std::ostringstream oss;
@@ -26,7 +28,7 @@ namespace luky {
         }
      
         virtual size_t arity() = 0;
-        virtual ObjPtr call(Interpreter&, VArguments& v_args) =0;
+        virtual LukObject call(Interpreter&, VArguments& v_args) =0;
         virtual std::string toString() const = 0;
         virtual std::string typeName() const { return "LukCallable"; }
         std::map<std::string, std::string>& getKeywords() { return m_keywords; }
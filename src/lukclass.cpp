@@ -5,57 +5,100 @@
 
 using namespace luky;
 
-size_t LukClass::arity() { 
-    ObjPtr method = findMethod("init"); 
-    if (method != nullptr) {
-      std::shared_ptr<LukFunction> initializer = method->getDynCast<LukFunction>();
-      if (initializer == nullptr) return 0;
-      return initializer->arity();
-    }
+uint64_t LukClass::s_lastId =0;
 
-  
-  return 0;
+size_t LukClass::arity() { 
+  return m_arity;
 }
 
 std::string LukClass::toString() const {  
   return  "<Class " + m_name + ">";
 }
 
-ObjPtr  LukClass::call(Interpreter& interp, 
-           std::vector<ObjPtr>& v_args) {
-    // Note: "this" is a const pointer, 
-    // so the current function should be not const
-    // otherwire "this" is casting const type* const
-    // so not compile, when passing it as parameter to lukinstance object.
-    auto thisPtr = std::make_shared<LukClass>(*this);
-    auto instPtr = std::make_shared<LukInstance>(thisPtr );
-    ObjPtr method = findMethod("init"); 
-    if (method != nullptr) {
-          // Note: to get derived object from shared_ptr base object
-          // yout must use: static_pointer_cast or dynamic_pointer_cast to cast it.
-          std::shared_ptr<LukFunction> initializer = method->getDynCast<LukFunction>();
-          if (initializer != nullptr) {
-            auto obj_ptr = initializer->bind(instPtr);
-              obj_ptr->getCallable()->call(interp, v_args);
-          }
+void LukClass::resolveInitializer() {
+    LukObject method = findMethod(SymbolTable::Init); 
+    p_initializer = method.getDynCast<LukFunction>();
+    m_arity = p_initializer != nullptr ? p_initializer->arity() : 0;
+}
+
+LukObject  LukClass::call(Interpreter& interp, 
+           std::vector<LukObject>& v_args) {
+    // Note: the reference counter is stored in the object itself,
+    // so the instance can share this class, without copying it.
+    auto instPtr = makeRef<LukInstance>(LukRef<LukClass>(this));
+    if (p_initializer != nullptr) {
+        // Note: the initializer is called with the new instance as "this", without binding it
+        p_initializer->callWith(interp, LukObject(instPtr), v_args);
     }
 
-    return std::make_shared<LukObject>(instPtr);
+    return LukObject(instPtr);
 }
 
-ObjPtr LukClass::findMethod(const std::string& name) {
-    logMsg("\nIn LukClass::Findmethod, name: ", name, "m_methods size: ", m_methods.size());
+LukObject LukClass::findMethod(Symbol name) {
+    LOG_MSG(cat_OBJECT, "\nIn LukClass::Findmethod, name: ", symbolName(name), "m_methods size: ", m_methods.size());
+    const LukObject* method = methodRef(name);
+
+    return method != nullptr ? *method : LukObject();
+}
+
+// Note: the methods never change after the class is built, and a map never moves its values,
+// only clearRefs empties them, and it changes the version
+const LukObject* LukClass::methodRef(Symbol name) const {
     auto iter = m_methods.find(name);
-    if (iter != m_methods.end()) {
-        return iter->second;
+    if (iter != m_methods.end()) return &iter->second;
+    if (p_superclass != nullptr) return p_superclass->methodRef(name);
+
+    return nullptr;
+}
+
+LukObject LukClass::get(TokPtr& name) {
+    if (p_statics == nullptr) return LukObject();
+    return p_statics->get(name);
+}
+
+LukObject LukClass::getProperty(TokPtr& name, InlineCache* cache) {
+    LukShape* shape = p_statics != nullptr ? p_statics->getShape() : nullptr;
+    if (cache != nullptr) {
+        if (auto entry = cache->find(shape, m_id, m_version)) return *entry->p_method;
     }
-    if (p_superclass != nullptr) {
-        return p_superclass->findMethod(name);
+    auto val = get(name);
+    if (!val.isNil()) return val;
+    const LukObject* method = methodRef(name->symbol);
+    if (method == nullptr) return LukObject();
+    if (cache != nullptr) {
+        CacheEntry entry;
+        entry.p_shape = shape;
+        entry.m_classId = m_id;
+        entry.m_version = m_version;
+        entry.p_method = method;
+        cache->add(name, std::move(entry));
     }
-    
-    return nullptr;
+
+    return *method;
 }
 
+void LukClass::set(TokPtr& name, const LukObject& val) {
+    if (p_statics == nullptr) 
+      p_statics = makeRef<LukInstance>(nullptr);
+    p_statics->set(name, val);
+    bumpVersion();
+}
+
+
+void LukClass::traverse(GcVisitor& visitor) {
+    visitor.visit(p_superclass);
+    for (auto& iter: m_methods) visitor.visit(iter.second);
+    visitor.visit(p_statics);
+    visitor.visit(p_initializer);
+}
+
+void LukClass::clearRefs() {
+    p_superclass = nullptr;
+    m_methods.clear();
+    p_statics = nullptr;
+    p_initializer = nullptr;
+    bumpVersion();
+}
 
 std::ostream& operator<<(std::ostream& oss, const luky::LukClass& lc) {
     oss << lc.m_name;
@@ -8,34 +8,74 @@
 
 #include <string>
 #include <vector>
+#include <cstdint> // uint32_t, uint64_t
 #include <memory>
 #include <unordered_map>
 
 namespace luky {
-    class LukClass : public LukInstance, public LukCallable {
+    class LukFunction;
+
+    /// Note: a class is a callable which holds its static fields
+    /// in an instance of its metaclass, so class methods are bound to this instance.
+    class LukClass : public LukCallable, public GcObject {
     public:
       std::string m_name;
-      std::shared_ptr<LukClass> p_superclass;
+      LukRef<LukClass> p_superclass;
 
-        LukClass( std::shared_ptr<LukClass> metaclass,
+        LukClass( LukRef<LukClass> metaclass,
               const std::string& name,
-              std::shared_ptr<LukClass> superclass,
-              const std::unordered_map<std::string, ObjPtr>& methods) :
-          LukInstance(metaclass),
+              LukRef<LukClass> superclass,
+              const std::unordered_map<Symbol, LukObject>& methods) :
           m_name(name),
           p_superclass(superclass),
-          m_methods(methods) 
-        {}
+          m_methods(methods) {
+            if (metaclass != nullptr) 
+              p_statics = makeRef<LukInstance>(metaclass);
+            resolveInitializer();
+        }
 
         ~LukClass() {}
 
         virtual size_t arity() override;
         virtual std::string toString() const override;
-        virtual ObjPtr  call(Interpreter& interp, std::vector<ObjPtr>& v_args) override;
-        ObjPtr findMethod(const std::string& name);
+        virtual LukObject  call(Interpreter& interp, std::vector<LukObject>& v_args) override;
+        LukObject findMethod(Symbol name);
+        // Note: the method in this class or a superclass, nullptr whether not found,
+        // the pointer is valid while the class keeps its version
+        const LukObject* methodRef(Symbol name) const;
+        
+        // static fields and class methods
+        LukObject get(TokPtr& name);
+        void set(TokPtr& name, const LukObject& val);
+        // Note: static field, class method or method, searched through the inline cache of the site.
+        // Only methods are cached, keyed by the shape of the static fields which could hide them.
+        LukObject getProperty(TokPtr& name, InlineCache* cache);
+        // Note: the inline caches holding a lookup of this class are valid only for this version
+        uint32_t version() const noexcept { return m_version; }
+        // Note: unique id of the class, never reused, so the inline caches do not hold the class
+        uint64_t id() const noexcept { return m_id; }
+        void bumpVersion() noexcept { ++m_version; }
+
+        // cycle collector
+        virtual GcObject* gcObject() noexcept override { return this; }
+        virtual LukHeap* gcHeap() noexcept override { return this; }
+        virtual void traverse(GcVisitor& visitor) override;
+        virtual void clearRefs() override;
+        virtual size_t gcOwners() const override { return refCount(); }
 
     private:
-      std::unordered_map<std::string, ObjPtr> m_methods;
+      // Note: methods are keyed by the symbol of their name
+      std::unordered_map<Symbol, LukObject> m_methods;
+      LukRef<LukInstance> p_statics;
+      // Note: methods cannot change after the class is built,
+      // so the initializer and its arity are resolved once, not on each instantiation.
+      LukRef<LukFunction> p_initializer;
+      size_t m_arity =0;
+      uint32_t m_version =0;
+      const uint64_t m_id = ++s_lastId;
+      static uint64_t s_lastId;
+
+      void resolveInitializer();
     };
 }
 
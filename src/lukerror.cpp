@@ -24,7 +24,7 @@ void LukError::error(const std::string& title, TokPtr& tok,
 	if (tok->type == TokenType::END_OF_FILE) {
       report(title, tok->line, tok->col, " at end", message);
     } else {
-      report(title, tok->line, tok->col, " at '" + tok->lexeme + "'", 
+      report(title, tok->line, tok->col, " at '" + std::string(tok->lexeme) + "'", 
               message);
     }
 
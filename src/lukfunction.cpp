@@ -2,41 +2,67 @@
 #include "lukobject.hpp"
 #include "environment.hpp"
 #include "interpreter.hpp"
-#include "return.hpp"
+#include "chunk.hpp"
 
 using namespace luky;
 
-ObjPtr  LukFunction::call(Interpreter& interp, std::vector<ObjPtr>& v_args) {
+LukObject  LukFunction::call(Interpreter& interp, std::vector<LukObject>& v_args) {
+    return callWith(interp, m_this, v_args);
+}
+
+LukObject LukFunction::callWith(Interpreter& interp, const LukObject& thisObj, std::vector<LukObject>& v_args) {
+    LukGC::get().safePoint();
     // TRACE_MSG("Call Function Tracer: ");
     // std::cerr << "interp.m_globals.size: " << interp.m_globals->size() << "\n";
     auto env = std::make_shared<Environment>(m_closure);
+    // Note: "this" is the first slot of a method's frame, before the parameters
+    unsigned first =0;
+    if (m_declaration->m_isMethod) {
+        env->defineSlot(0, thisObj);
+        first =1;
+    }
     for (unsigned i=0; i < m_declaration->m_params.size(); ++i) {
         // Note: C++ can store polymorphic or derived object in a container
         // only with pointer or smart pointers.
-        env->define(m_declaration->m_params.at(i)->lexeme, v_args.at(i));
+        env->defineSlot(first + i, v_args.at(i));
     }
     
-    try {
-        interp.executeBlock(m_declaration->m_body, env);
-    } catch(Return& ret) {
+    // compiled function, the VM returns the value of the return statement
+    if (m_declaration->m_chunk != nullptr) {
+        LukObject result = interp.runChunk(*m_declaration->m_chunk, env);
+        if (m_isInitializer) return env->getAt(0, 0);
+        return result;
+    }
+
+    interp.executeBlock(m_declaration->m_body, env);
+    if (interp.m_completion == Completion::Return) {
+        interp.m_completion = Completion::Normal;
         if (m_isInitializer) { 
-          return m_closure->getAt(0, "this");
+          return env->getAt(0, 0);
         }
         
-        return ret.m_value;
+        return std::move(interp.m_retValue);
     }
-    if (m_isInitializer) return  m_closure->getAt(0, "this");
+    if (m_isInitializer) return env->getAt(0, 0);
     
     
-    return nilptr;
+    return LukObject();
+}
+
+LukObject LukFunction::bind(LukRef<LukInstance> instPtr) {
+  // Note: the instance is stored in the bound function, not in a new environment,
+  // it's put in the frame at each call.
+  auto funcPtr = makeRef<LukFunction>(m_name, m_declaration, m_closure, m_isInitializer);
+  funcPtr->m_this = LukObject(instPtr);
+  return LukObject(funcPtr);
 }
 
-ObjPtr LukFunction::bind(std::shared_ptr<LukInstance> instPtr) {
-  auto env = std::make_shared<Environment>(m_closure);
-  ObjPtr objP = std::make_shared<LukObject>(instPtr);
-  env->define("this", objP);
-  auto funcPtr = std::make_shared<LukFunction>(m_name, m_declaration, env, m_isInitializer);
-  auto obj_ptr = std::make_shared<LukObject>(funcPtr);
-  return obj_ptr;
+void LukFunction::traverse(GcVisitor& visitor) {
+    visitor.visit(m_closure);
+    visitor.visit(m_this);
 }
 
+void LukFunction::clearRefs() {
+    m_closure.reset();
+    m_this = LukObject();
+}
@@ -4,6 +4,7 @@
 #include "common.hpp"
 #include "lukcallable.hpp"
 #include "expr.hpp"
+#include "lukgc.hpp"
 #include "logger.hpp"
 
 #include <string>
@@ -13,7 +14,7 @@
 #include <typeinfo> // type name
 
 namespace luky {
-    class LukFunction : public LukCallable {
+    class LukFunction : public LukCallable, public GcObject {
     public:
         // Note: WARNING: cannot copy assignment derived object like FunctionStmt ..
         // so passing it by raw pointer.
@@ -38,18 +39,30 @@ namespace luky {
         virtual std::string typeName() const override { return "LukFunction"; }
         
         virtual size_t arity() override { return m_declaration->m_params.size(); }
-        virtual ObjPtr  call(Interpreter& interp, std::vector<ObjPtr>& v_args) override;
+        virtual LukObject  call(Interpreter& interp, std::vector<LukObject>& v_args) override;
+        // Note: calls the method with "this" in the first slot of its frame,
+        // used by invoke expressions, without binding the method.
+        LukObject callWith(Interpreter& interp, const LukObject& thisObj, std::vector<LukObject>& v_args);
         virtual std::string toString() const override { 
           if (m_name == "") return "<Function Lambda>";
           return "<Function " + m_name + ">"; 
         }
-        ObjPtr bind(std::shared_ptr<LukInstance> instPtr);
+        LukObject bind(LukRef<LukInstance> instPtr);
+
+        // cycle collector
+        virtual GcObject* gcObject() noexcept override { return this; }
+        virtual LukHeap* gcHeap() noexcept override { return this; }
+        virtual void traverse(GcVisitor& visitor) override;
+        virtual void clearRefs() override;
+        virtual size_t gcOwners() const override { return refCount(); }
 
     private:
         const std::string m_name;
         std::shared_ptr<FunctionExpr> m_declaration;
         EnvPtr m_closure;
         bool m_isInitializer;
+        // instance bound to the method
+        LukObject m_this;
 
     };
 }
@@ -0,0 +1,121 @@
+#include "lukgc.hpp"
+#include "lukobject.hpp"
+#include "environment.hpp"
+#include "logger.hpp"
+
+#include <cassert>
+#include <chrono>
+#include <climits> // LONG_MAX
+#include <vector>
+
+using namespace luky;
+
+void GcVisitor::visit(const LukObject& val) {
+    if (val.isHeap()) visitHeap(val.p_heap);
+}
+
+void GcVisitor::visit(const EnvPtr& env) {
+    if (env) visit(static_cast<GcObject*>(env.get()));
+}
+
+void GcVisitor::visitHeap(LukHeap* heap) {
+    GcObject* obj = heap->gcObject();
+    if (obj) visit(obj);
+}
+
+// Note: removes the references between tracked objects from their counters
+class LukGC::SubtractVisitor : public GcVisitor {
+public:
+    using GcVisitor::visit;
+    void visit(GcObject* obj) override { --obj->m_gcRefs; }
+};
+
+// Note: marks the objects reachable from the roots
+class LukGC::MarkVisitor : public GcVisitor {
+public:
+    using GcVisitor::visit;
+    explicit MarkVisitor(std::vector<GcObject*>& pending) : m_pending(pending) {}
+    void visit(GcObject* obj) override {
+        if (obj->m_gcReachable) return;
+        obj->m_gcReachable = true;
+        m_pending.push_back(obj);
+    }
+
+private:
+    std::vector<GcObject*>& m_pending;
+};
+
+size_t LukGC::collect() {
+    // Note: clearing the garbage can reach a safe point, through a destructor
+    if (m_collecting) return 0;
+    m_collecting = true;
+    m_pending = false;
+    auto start = std::chrono::steady_clock::now();
+    size_t before = m_count;
+    if (m_count > m_maxCount) m_maxCount = m_count;
+
+    // every owner of an object is a root at first
+    for (auto obj = p_head; obj; obj = obj->p_gcNext) {
+        size_t owners = obj->gcOwners();
+        // Note: an object without counted owner is held by the C++ code, so it's a root
+        obj->m_gcRefs = owners > 0 ? static_cast<long>(owners) : LONG_MAX / 2;
+        obj->m_gcReachable = false;
+    }
+    SubtractVisitor subtract;
+    for (auto obj = p_head; obj; obj = obj->p_gcNext) {
+        obj->traverse(subtract);
+    }
+
+    // objects still owned from outside are the roots
+    std::vector<GcObject*> pending;
+    for (auto obj = p_head; obj; obj = obj->p_gcNext) {
+        assert(obj->m_gcRefs >= 0);
+        if (obj->m_gcRefs > 0) {
+            obj->m_gcReachable = true;
+            pending.push_back(obj);
+        }
+    }
+    MarkVisitor mark(pending);
+    while (!pending.empty()) {
+        auto obj = pending.back();
+        pending.pop_back();
+        obj->traverse(mark);
+    }
+
+    // Note: the garbage heap objects are held while their references are cleared,
+    // so none of them is freed before all the cycles are broken.
+    std::vector<LukRef<LukHeap>> garbage;
+    for (auto obj = p_head; obj; obj = obj->p_gcNext) {
+        if (obj->m_gcReachable) continue;
+        LukHeap* heap = obj->gcHeap();
+        if (heap) garbage.emplace_back(heap);
+    }
+    for (auto& heap: garbage) {
+        heap->gcObject()->clearRefs();
+    }
+    garbage.clear();
+
+    m_lastFreed = before - m_count;
+    m_freed += m_lastFreed;
+    ++m_collections;
+    // Note: the next collection waits for as many allocations as objects alive,
+    // so the cost of the collections stays proportional to the allocations.
+    m_allocated =0;
+    m_threshold = m_count > m_minThreshold ? m_count : m_minThreshold;
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    m_totalTime += elapsed.count();
+    LOG_MSG(cat_OBJECT, "\nLukGC::collect, freed: ", m_lastFreed, ", alive: ", m_count);
+    m_collecting = false;
+
+    return m_lastFreed;
+}
+
+void LukGC::printStats(std::ostream& ost) const {
+    ost << "GC: collections: " << m_collections
+        << ", freed: " << m_freed
+        << ", last freed: " << m_lastFreed
+        << ", alive: " << m_count
+        << ", peak: " << (m_count > m_maxCount ? m_count : m_maxCount)
+        << ", threshold: " << m_threshold
+        << ", time: " << m_totalTime * 1000 << " ms\n";
+}
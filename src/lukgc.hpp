@@ -0,0 +1,129 @@
+#ifndef LUKGC_HPP
+#define LUKGC_HPP
+
+#include "common.hpp"
+#include "lukheap.hpp"
+
+#include <cstddef> // size_t
+#include <iostream>
+#include <memory>
+
+namespace luky {
+    class GcObject;
+    class LukObject;
+
+    /// Note: receives each reference owned by a GcObject
+    class GcVisitor {
+    public:
+        virtual ~GcVisitor() {}
+        virtual void visit(GcObject* obj) =0;
+
+        void visit(const LukObject& val);
+        void visit(const EnvPtr& env);
+        template <typename T>
+        void visit(const LukRef<T>& ref) { if (ref) visitHeap(ref.heap()); }
+
+    private:
+        void visitHeap(LukHeap* heap);
+    };
+
+    /// Note: object which owns references to other objects, so it can be part of a reference cycle.
+    /// The object links itself in the list of the collector while it is alive.
+    class GcObject {
+    public:
+        GcObject();
+        // Note: a copy is a new object, linked on its own
+        GcObject(const GcObject&) : GcObject() {}
+        GcObject& operator=(const GcObject&) { return *this; }
+        virtual ~GcObject();
+
+        // Note: visits each reference owned by the object, once per reference,
+        // a reference not visited keeps only its target alive, a reference visited twice is unsafe.
+        virtual void traverse(GcVisitor& visitor) =0;
+        // drops the references owned by the object, to break a cycle
+        virtual void clearRefs() =0;
+        // number of references owning the object
+        virtual size_t gcOwners() const =0;
+        // Note: the heap object to hold while its references are cleared,
+        // nullptr whether the object is not a LukHeap, it's freed by its owners
+        virtual LukHeap* gcHeap() noexcept { return nullptr; }
+
+    private:
+        friend class LukGC;
+        GcObject* p_gcPrev = nullptr;
+        GcObject* p_gcNext = nullptr;
+        // owners not found in the tracked objects, during a collection
+        long m_gcRefs =0;
+        bool m_gcReachable = false;
+    };
+
+    /// Note: cycle collector for the objects which are reference counted.
+    /// Reference counting frees every object, except the cycles,
+    /// like a closure stored in a field of the instance it captures.
+    /// A collection subtracts the references between tracked objects from their counters,
+    /// objects still owned from outside (interpreter environments, globals, stack of the VM,
+    /// native values) are the roots, everything they reach is kept,
+    /// the rest is garbage whose references are cleared, so the counters free it.
+    /// A collection is requested after a number of allocations,
+    /// and runs at the next safe point of the interpreter or the VM.
+    class LukGC {
+    public:
+        // Note: the collector is never destroyed, so objects freed at exit can still unlink themselves
+        static LukGC& get() {
+            static LukGC* gc = new LukGC();
+            return *gc;
+        }
+
+        void track(GcObject* obj) noexcept {
+            obj->p_gcNext = p_head;
+            if (p_head) p_head->p_gcPrev = obj;
+            p_head = obj;
+            ++m_count;
+            if (++m_allocated >= m_threshold) m_pending = true;
+        }
+
+        void untrack(GcObject* obj) noexcept {
+            if (obj->p_gcPrev) obj->p_gcPrev->p_gcNext = obj->p_gcNext;
+            else p_head = obj->p_gcNext;
+            if (obj->p_gcNext) obj->p_gcNext->p_gcPrev = obj->p_gcPrev;
+            --m_count;
+        }
+
+        // Note: called where no raw pointer to a tracked object is held without owning it
+        void safePoint() {
+            if (m_pending) collect();
+        }
+
+        // returns the number of objects freed
+        size_t collect();
+
+        size_t count() const noexcept { return m_count; }
+        void printStats(std::ostream& ost) const;
+
+    private:
+        class SubtractVisitor;
+        class MarkVisitor;
+
+        LukGC() {}
+
+        GcObject* p_head = nullptr;
+        size_t m_count =0;
+        size_t m_allocated =0;
+        size_t m_minThreshold = 10000;
+        size_t m_threshold = 10000;
+        bool m_pending = false;
+        bool m_collecting = false;
+
+        // statistics
+        size_t m_collections =0;
+        size_t m_freed =0;
+        size_t m_lastFreed =0;
+        size_t m_maxCount =0;
+        double m_totalTime =0;
+    };
+
+    inline GcObject::GcObject() { LukGC::get().track(this); }
+    inline GcObject::~GcObject() { LukGC::get().untrack(this); }
+}
+
+#endif // LUKGC_HPP
@@ -0,0 +1,97 @@
+#ifndef LUKHEAP_HPP
+#define LUKHEAP_HPP
+
+#include <cstddef> // size_t, nullptr_t
+#include <utility> // forward
+#include <type_traits> // enable_if, is_convertible
+
+namespace luky {
+    class GcObject;
+
+    /// Note: base class for all objects living on the heap
+    /// like strings, callables and instances.
+    /// The reference counter is stored in the object itself (intrusive counting),
+    /// so a LukObject value can hold an heap object behind a single raw pointer.
+    class LukHeap {
+    public:
+        LukHeap() {}
+        // Note: a copy is a new object, so it starts without any owner
+        LukHeap(const LukHeap&) : m_refs(0) {}
+        LukHeap& operator=(const LukHeap&) { return *this; }
+        virtual ~LukHeap() {}
+
+        void retain() noexcept { ++m_refs; }
+        void release() noexcept {
+            if (--m_refs == 0) destroy();
+        }
+        size_t refCount() const noexcept { return m_refs; }
+        // Note: returns the object tracked by the cycle collector, nullptr whether it has no reference
+        virtual GcObject* gcObject() noexcept { return nullptr; }
+
+    private:
+        size_t m_refs =0;
+        // Note: defined out of line, so the deletion is not inlined on each release.
+        void destroy() noexcept;
+    };
+
+    /// Note: smart pointer for LukHeap objects.
+    /// It stores only a LukHeap pointer, so it can be declared as member
+    /// with incomplete types, T must be complete only when the pointer is dereferenced.
+    template <typename T>
+    class LukRef {
+    public:
+        LukRef() noexcept : p_heap(nullptr) {}
+        LukRef(std::nullptr_t) noexcept : p_heap(nullptr) {}
+        explicit LukRef(T* ptr) : p_heap(ptr) {
+            if (p_heap) p_heap->retain();
+        }
+
+        LukRef(const LukRef& other) noexcept : p_heap(other.p_heap) {
+            if (p_heap) p_heap->retain();
+        }
+        LukRef(LukRef&& other) noexcept : p_heap(other.p_heap) {
+            other.p_heap = nullptr;
+        }
+
+        // converting constructor from derived object
+        template <typename U,
+                 typename = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+        LukRef(const LukRef<U>& other) : LukRef(static_cast<T*>(other.get())) {}
+
+        ~LukRef() {
+            if (p_heap) p_heap->release();
+        }
+
+        LukRef& operator=(LukRef other) noexcept {
+            LukHeap* tmp = p_heap;
+            p_heap = other.p_heap;
+            other.p_heap = tmp;
+            return *this;
+        }
+
+        T* get() const noexcept { return static_cast<T*>(p_heap); }
+        T* operator->() const noexcept { return get(); }
+        T& operator*() const noexcept { return *get(); }
+        explicit operator bool() const noexcept { return p_heap != nullptr; }
+        LukHeap* heap() const noexcept { return p_heap; }
+
+        bool operator==(std::nullptr_t) const noexcept { return p_heap == nullptr; }
+        bool operator!=(std::nullptr_t) const noexcept { return p_heap != nullptr; }
+        template <typename U>
+        bool operator==(const LukRef<U>& other) const noexcept { return p_heap == other.heap(); }
+        template <typename U>
+        bool operator!=(const LukRef<U>& other) const noexcept { return p_heap != other.heap(); }
+
+    private:
+        LukHeap* p_heap;
+    };
+
+    /// Note: like std::make_shared, creates a new heap object and returns its reference.
+    template <typename T, typename... TArgs>
+    LukRef<T> makeRef(TArgs&&... args) {
+        return LukRef<T>(new T(std::forward<TArgs>(args)...));
+    }
+
+}
+
+#endif // LUKHEAP_HPP
@@ -14,44 +14,110 @@ std::string LukInstance::toString() const {
   return  "<Instance " + m_klass->m_name  + ">"; 
 }
 
-ObjPtr LukInstance::get(TokPtr& name) {
-    logMsg("\nIn LukInstance::get, searching in m_fields, name: ", name);
-    auto iter = m_fields.find(name->lexeme);
-    if (iter != m_fields.end()) {
-      return iter->second;
+LukObject LukInstance::get(TokPtr& name, InlineCache* cache) {
+    bool isMethod = false;
+    LukObject member = getMember(name, isMethod, cache);
+    if (isMethod) {
+        // Note: the reference counter is stored in the object itself,
+        // so this instance can be bound directly, without copying it.
+        return static_cast<LukFunction*>(member.getCallable())->bind(LukRef<LukInstance>(this));
+    }
+
+    return member;
+}
+
+LukObject LukInstance::getMember(TokPtr& name, bool& isMethod, InlineCache* cache) {
+    if (cache == nullptr) return lookupMember(name, isMethod);
+    LukClass* klass = m_klass.get();
+    uint64_t classId = klass != nullptr ? klass->id() : 0;
+    uint32_t version = klass != nullptr ? klass->version() : 0;
+    if (auto entry = cache->find(p_shape, classId, version)) {
+        isMethod = entry->m_isMethod;
+        if (entry->m_slot >= 0) return m_fields[entry->m_slot];
+        return entry->p_method != nullptr ? *entry->p_method : LukObject();
+    }
+
+    CacheEntry entry;
+    entry.p_shape = p_shape;
+    entry.m_classId = classId;
+    entry.m_version = version;
+    entry.m_slot = p_shape->lookup(name->symbol);
+    LukObject member = lookupMember(name, isMethod);
+    entry.m_isMethod = isMethod;
+    if (entry.m_slot < 0 && klass != nullptr) entry.p_method = klass->methodRef(name->symbol);
+    cache->add(name, std::move(entry));
+
+    return member;
+}
+
+LukObject LukInstance::lookupMember(TokPtr& name, bool& isMethod) {
+    LOG_MSG(cat_OBJECT, "\nIn LukInstance::getMember, searching in m_fields, name: ", name);
+    isMethod = false;
+    int slot = p_shape->lookup(name->symbol);
+    if (slot >= 0) {
+      return m_fields[slot];
     }
     if (m_klass != nullptr) {
-        logMsg("In LukInstance::get, searching in m_klass::m_methods, name: ", name);
-        ObjPtr method = m_klass->findMethod(name->lexeme); 
+        LOG_MSG(cat_OBJECT, "In LukInstance::getMember, searching in m_klass::m_methods, name: ", name);
+        LukObject method = m_klass->findMethod(name->symbol); 
         // Note: to retrieve lukfunction,
         // you must extract lukfunction from lukobject
-        if (method != nullptr && method->isCallable()) {
-          // Note: to get derived object from shared_ptr base object
-          // yout must use: static_pointer_cast or dynamic_pointer_cast to cast it.
-          std::shared_ptr<LukFunction> funcPtr = method->getDynCast<LukFunction>();
-          // must convert *this to lukinstance shared_ptr to be stored in a lukobject object.
-          // Note: here deep copy is necessary cause, this object is more sophiscated object,
-          // so the default copy constructor not suficient.
-          std::shared_ptr<LukInstance> instPtr = std::make_shared<LukInstance>(*this);
-          return funcPtr->bind(instPtr);
+        if (method.isCallable()) {
+          isMethod = dynamic_cast<LukFunction*>(method.getCallable()) != nullptr;
         }
         
-        else if (method != nullptr) {
-          return method;
-        }
-
+        return method;
     }
   /*
     throw RuntimeError(name, 
-        "Undefined property '" + name->lexeme + "'.");
+        "Undefined property '" + std::string(name->lexeme) + "'.");
         */
-    logMsg("LukInstance::get, Undefined property: ", name->lexeme);
+    LOG_MSG(cat_OBJECT, "LukInstance::getMember, Undefined property: ", name->lexeme);
     // unrichable
-    return nilptr;
+    return LukObject();
+}
+
+void LukInstance::set(TokPtr& name, const LukObject& val, InlineCache* cache) {
+  // Note: the layout of the fields depends only on the shape, not on the class
+  if (cache != nullptr) {
+    if (auto entry = cache->find(p_shape, 0, 0)) {
+      if (entry->p_next != nullptr) {
+        p_shape = entry->p_next;
+        m_fields.push_back(val);
+      } else {
+        m_fields[entry->m_slot] = val;
+      }
+      return;
+    }
+  }
+
+  CacheEntry entry;
+  entry.p_shape = p_shape;
+  int slot = p_shape->lookup(name->symbol);
+  if (slot >= 0) {
+    m_fields[slot] = val;
+  } else {
+    // new field, transition to the next shape
+    p_shape = p_shape->addField(name->symbol);
+    m_fields.push_back(val);
+    slot = static_cast<int>(m_fields.size()) -1;
+    entry.p_next = p_shape;
+  }
+  if (cache != nullptr) {
+    entry.m_slot = slot;
+    cache->add(name, std::move(entry));
+  }
+}
+
+void LukInstance::traverse(GcVisitor& visitor) {
+  visitor.visit(m_klass);
+  for (auto& val: m_fields) visitor.visit(val);
 }
 
-void LukInstance::set(TokPtr& name, ObjPtr valPtr) {
-  m_fields[name->lexeme] = valPtr;
+void LukInstance::clearRefs() {
+  m_klass = nullptr;
+  m_fields.clear();
+  p_shape = LukShape::root();
 }
 
 std::ostream& operator<<(std::ostream& oss, const LukInstance& li) {
@@ -2,6 +2,11 @@
 #define LUKINSTANCE_HPP
 
 #include "common.hpp"
+#include "lukheap.hpp"
+#include "lukobject.hpp"
+#include "lukshape.hpp"
+#include "inlinecache.hpp"
+#include "lukgc.hpp"
 // #include "lukclass.hpp"
 #include "logger.hpp"
 
@@ -9,41 +14,48 @@
 #include <string>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 namespace luky {
     class LukClass;
 
-    class LukInstance {
+    class LukInstance : public LukHeap, public GcObject {
     public:
-        explicit LukInstance(std::shared_ptr<LukClass> klass)
-          : m_klass(klass)
+        explicit LukInstance(LukRef<LukClass> klass)
+          : m_klass(klass),
+          p_shape(LukShape::root())
         {}
           
-        explicit LukInstance(LukInstance& other) {
-            // Note: we should do a deep copy for this object
-            // cause this object is more sophisticated
-            // so the compiler's default copy constructor cannot copy it entirely.
-            logMsg("LukInstance copy Ctor with deep copy");
-            // not necessary, cause m_klass and m_fields are protected now
-            // m_klass = other.getKlass();
-            // m_fields = other.getFields();
-            m_klass = other.m_klass;
-            m_fields = other.m_fields;
-        }
-        
         ~LukInstance() {}
 
         // for debugging
-        std::shared_ptr<LukClass>& getKlass() { return m_klass; }
-        std::unordered_map<std::string, ObjPtr>& getFields() { return m_fields; }
+        LukRef<LukClass>& getKlass() { return m_klass; }
+        LukShape* getShape() const { return p_shape; }
+        std::vector<LukObject>& getFields() { return m_fields; }
 
         virtual std::string toString() const;
-        ObjPtr get(TokPtr& name);
-        void set(TokPtr& name, ObjPtr valPtr);
+        // Note: the optional cache is the inline cache of the access site
+        LukObject get(TokPtr& name, InlineCache* cache=nullptr);
+        // Note: returns the field, or the method without binding it,
+        // isMethod is set whether the result is a LukFunction to call with this instance.
+        LukObject getMember(TokPtr& name, bool& isMethod, InlineCache* cache=nullptr);
+        void set(TokPtr& name, const LukObject& val, InlineCache* cache=nullptr);
+
+        // cycle collector
+        virtual GcObject* gcObject() noexcept override { return this; }
+        virtual LukHeap* gcHeap() noexcept override { return this; }
+        virtual void traverse(GcVisitor& visitor) override;
+        virtual void clearRefs() override;
+        virtual size_t gcOwners() const override { return refCount(); }
 
     protected:
-        std::shared_ptr<LukClass> m_klass;
-       std::unordered_map<std::string, ObjPtr> m_fields = {};
+        LukRef<LukClass> m_klass;
+        // Note: the shape gives the slot of each field name,
+        // so an instance stores only the field values.
+        LukShape* p_shape;
+        std::vector<LukObject> m_fields = {};
+
+        LukObject lookupMember(TokPtr& name, bool& isMethod);
 
     };
 }
@@ -0,0 +1,84 @@
+#include "luklist.hpp"
+#include "runtimeerror.hpp"
+
+#include <algorithm> // find
+#include <utility> // pair
+#include <vector>
+
+using namespace luky;
+
+LukObject& LukList::at(TLukInt index) {
+    TLukInt size = static_cast<TLukInt>(m_items.size());
+    if (index < 0) index += size;
+    if (index < 0 || index >= size) throw RuntimeError("List index out of range.");
+
+    return m_items[index];
+}
+
+LukObject LukList::pop() {
+    if (m_items.empty()) throw RuntimeError("pop() from empty list.");
+    LukObject val = std::move(m_items.back());
+    m_items.pop_back();
+
+    return val;
+}
+
+LukRef<LukList> LukList::slice(TLukInt start, TLukInt end) const {
+    TLukInt size = static_cast<TLukInt>(m_items.size());
+    if (start < 0) start = std::max(start + size, TLukInt(0));
+    if (end < 0) end = std::max(end + size, TLukInt(0));
+    start = std::min(start, size);
+    end = std::min(end, size);
+    auto result = makeRef<LukList>();
+    if (start < end)
+        result->m_items.assign(m_items.begin() + start, m_items.begin() + end);
+
+    return result;
+}
+
+bool LukList::equals(const LukList& other) const {
+    if (this == &other) return true;
+    if (m_items.size() != other.m_items.size()) return false;
+    // Note: the pairs of lists being compared, so lists holding themselves are not compared forever,
+    // a pair met again while it is compared is taken as equal
+    static std::vector<std::pair<const LukList*, const LukList*>> s_comparing;
+    const auto pair = std::make_pair(this, &other);
+    if (std::find(s_comparing.begin(), s_comparing.end(), pair) != s_comparing.end()) return true;
+    s_comparing.push_back(pair);
+    bool result = true;
+    try {
+        for (size_t i=0; i < m_items.size() && result; ++i) {
+            auto& a = m_items[i];
+            auto& b = other.m_items[i];
+            // Note: the same heap object is equal, even whether its type has no equality
+            if (a.isHeap() && a.m_type == b.m_type && a.p_heap == b.p_heap) continue;
+            result = a == b;
+        }
+    } catch (...) {
+        s_comparing.pop_back();
+        throw;
+    }
+    s_comparing.pop_back();
+
+    return result;
+}
+
+std::string LukList::toString() const {
+    // Note: the lists being printed, so a list holding itself is printed as [...]
+    static std::vector<const LukList*> s_printing;
+    if (std::find(s_printing.begin(), s_printing.end(), this) != s_printing.end()) return "[...]";
+    s_printing.push_back(this);
+    std::string result = "[";
+    for (size_t i=0; i < m_items.size(); ++i) {
+        if (i > 0) result += ", ";
+        m_items[i].appendTo(result);
+    }
+    result += "]";
+    s_printing.pop_back();
+
+    return result;
+}
+
+void LukList::traverse(GcVisitor& visitor) {
+    for (auto& val: m_items) visitor.visit(val);
+}
@@ -0,0 +1,50 @@
+#ifndef LUKLIST_HPP
+#define LUKLIST_HPP
+
+#include "common.hpp"
+#include "lukheap.hpp"
+#include "lukobject.hpp"
+#include "lukgc.hpp"
+
+#include <string>
+#include <vector>
+
+namespace luky {
+    /// Note: native list, its items are stored in a contiguous vector of values,
+    /// so indexing is O(1), push and pop are amortized O(1),
+    /// and a loop over the items reads the memory in order.
+    /// A list can hold itself, so it's tracked by the cycle collector.
+    class LukList : public LukHeap, public GcObject {
+    public:
+        LukList() {}
+        explicit LukList(std::vector<LukObject>&& items) : m_items(std::move(items)) {}
+        ~LukList() {}
+
+        size_t size() const noexcept { return m_items.size(); }
+        std::vector<LukObject>& getItems() noexcept { return m_items; }
+
+        // Note: a negative index counts from the end, throws whether the index is out of range
+        LukObject& at(TLukInt index);
+        void push(const LukObject& val) { m_items.push_back(val); }
+        // removes and returns the last item, throws whether the list is empty
+        LukObject pop();
+        // Note: new list with the items from start to end excluded,
+        // the bounds are clamped to the list, a negative bound counts from the end.
+        LukRef<LukList> slice(TLukInt start, TLukInt end) const;
+
+        bool equals(const LukList& other) const;
+        std::string toString() const;
+
+        // cycle collector
+        virtual GcObject* gcObject() noexcept override { return this; }
+        virtual LukHeap* gcHeap() noexcept override { return this; }
+        virtual void traverse(GcVisitor& visitor) override;
+        virtual void clearRefs() override { m_items.clear(); }
+        virtual size_t gcOwners() const override { return refCount(); }
+
+    private:
+        std::vector<LukObject> m_items;
+    };
+}
+
+#endif // LUKLIST_HPP
@@ -0,0 +1,204 @@
+#include "lukmap.hpp"
+#include "lukstring.hpp"
+#include "runtimeerror.hpp"
+
+#include <algorithm> // find
+#include <cmath> // trunc
+#include <cstring> // memcpy
+#include <utility> // pair
+
+using namespace luky;
+
+// Note: finalizer of MurmurHash3, so consecutive ints are spread over the whole index
+static inline size_t mixHash(uint64_t val) noexcept {
+    val ^= val >> 33;
+    val *= 0xff51afd7ed558ccdULL;
+    val ^= val >> 33;
+    val *= 0xc4ceb9fe1a85ec53ULL;
+    val ^= val >> 33;
+
+    return static_cast<size_t>(val);
+}
+
+bool LukMap::isKey(const LukObject& key) noexcept {
+    return key.isString() || key.isNumber() || key.isBool();
+}
+
+size_t LukMap::hashKey(const LukObject& key) noexcept {
+    switch(key.getType()) {
+        case LukType::String: return key.getLukString()->hash();
+        case LukType::Int: return mixHash(static_cast<uint64_t>(key.getInt()));
+        case LukType::Double: {
+            double val = key.getDouble();
+            // Note: a double equal to an int has the hash of this int
+            if (std::trunc(val) == val && val >= -9.2e18 && val <= 9.2e18)
+                return mixHash(static_cast<uint64_t>(static_cast<TLukInt>(val)));
+            uint64_t bits;
+            std::memcpy(&bits, &val, sizeof(bits));
+            return mixHash(bits);
+        }
+        case LukType::Bool: return mixHash(key.getBool() ? 0x9e3779b97f4a7c15ULL : 0x7f4a7c159e3779b9ULL);
+        default: return 0;
+    }
+}
+
+bool LukMap::keyEquals(const LukObject& a, const LukObject& b) noexcept {
+    if (a.isInt() && b.isInt()) return a.getInt() == b.getInt();
+    if (a.isNumber() && b.isNumber()) return a.getNumber() == b.getNumber();
+    if (a.getType() != b.getType()) return false;
+    if (a.isString()) return a.getLukString()->equals(*b.getLukString());
+    if (a.isBool()) return a.getBool() == b.getBool();
+
+    return false;
+}
+
+long LukMap::findSlot(const LukObject& key, size_t hash) const {
+    if (m_index.empty()) return -1;
+    size_t mask = m_index.size() -1;
+    // Note: the index always keeps an empty slot, so the probing stops
+    for (size_t i = hash & mask; ; i = (i +1) & mask) {
+        int32_t idx = m_index[i];
+        if (idx == EmptySlot) return -1;
+        if (idx >= 0) {
+            auto& entry = m_entries[idx];
+            if (entry.m_hash == hash && keyEquals(entry.m_key, key)) return static_cast<long>(i);
+        }
+    }
+}
+
+void LukMap::rebuild(size_t count) {
+    if (m_count != m_entries.size()) {
+        m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(),
+                    [](const Entry& entry) { return entry.m_key.isNil(); }),
+                m_entries.end());
+    }
+    size_t capacity = MinCapacity;
+    while (capacity < count * 2) capacity *= 2;
+    m_index.assign(capacity, EmptySlot);
+    size_t mask = capacity -1;
+    for (size_t idx=0; idx < m_entries.size(); ++idx) {
+        size_t i = m_entries[idx].m_hash & mask;
+        while (m_index[i] != EmptySlot) i = (i +1) & mask;
+        m_index[i] = static_cast<int32_t>(idx);
+    }
+}
+
+LukObject* LukMap::find(const LukObject& key) {
+    long slot = findSlot(key, hashKey(key));
+    if (slot < 0) return nullptr;
+
+    return &m_entries[m_index[slot]].m_value;
+}
+
+void LukMap::set(const LukObject& key, const LukObject& val) {
+    size_t hash = hashKey(key);
+    long slot = findSlot(key, hash);
+    if (slot >= 0) {
+        m_entries[m_index[slot]].m_value = val;
+        return;
+    }
+    // Note: the deleted entries are counted in the load, until the index is rebuilt
+    if ((m_entries.size() +1) * 4 > m_index.size() * 3) rebuild(m_count +1);
+    m_entries.push_back(Entry{hash, key, val});
+    size_t mask = m_index.size() -1;
+    size_t i = hash & mask;
+    while (m_index[i] >= 0) i = (i +1) & mask;
+    m_index[i] = static_cast<int32_t>(m_entries.size() -1);
+    ++m_count;
+}
+
+bool LukMap::remove(const LukObject& key) {
+    long slot = findSlot(key, hashKey(key));
+    if (slot < 0) return false;
+    auto& entry = m_entries[m_index[slot]];
+    m_index[slot] = DeletedSlot;
+    --m_count;
+    // Note: the value can be the last owner of this map, so it's released last
+    LukObject val = std::move(entry.m_value);
+    entry.m_key = LukObject();
+    if (m_count == 0) {
+        m_entries.clear();
+        m_index.clear();
+    }
+
+    return true;
+}
+
+std::vector<LukObject> LukMap::keys() const {
+    std::vector<LukObject> result;
+    result.reserve(m_count);
+    for (auto& entry: m_entries) {
+        if (!entry.m_key.isNil()) result.push_back(entry.m_key);
+    }
+
+    return result;
+}
+
+bool LukMap::equals(LukMap& other) {
+    if (this == &other) return true;
+    if (m_count != other.m_count) return false;
+    // Note: the pairs of maps being compared, so maps holding themselves are not compared forever,
+    // a pair met again while it is compared is taken as equal
+    static std::vector<std::pair<const LukMap*, const LukMap*>> s_comparing;
+    const auto pair = std::make_pair(static_cast<const LukMap*>(this), static_cast<const LukMap*>(&other));
+    if (std::find(s_comparing.begin(), s_comparing.end(), pair) != s_comparing.end()) return true;
+    s_comparing.push_back(pair);
+    bool result = true;
+    try {
+        for (auto& entry: m_entries) {
+            if (entry.m_key.isNil()) continue;
+            LukObject* val = other.find(entry.m_key);
+            if (val == nullptr) {
+                result = false;
+                break;
+            }
+            auto& a = entry.m_value;
+            // Note: the same heap object is equal, even whether its type has no equality
+            if (a.isHeap() && a.m_type == val->m_type && a.p_heap == val->p_heap) continue;
+            if (a != *val) {
+                result = false;
+                break;
+            }
+        }
+    } catch (...) {
+        s_comparing.pop_back();
+        throw;
+    }
+    s_comparing.pop_back();
+
+    return result;
+}
+
+std::string LukMap::toString() const {
+    // Note: the maps being printed, so a map holding itself is printed as {...}
+    static std::vector<const LukMap*> s_printing;
+    if (std::find(s_printing.begin(), s_printing.end(), this) != s_printing.end()) return "{...}";
+    s_printing.push_back(this);
+    std::string result = "{";
+    bool first = true;
+    for (auto& entry: m_entries) {
+        if (entry.m_key.isNil()) continue;
+        if (!first) result += ", ";
+        first = false;
+        entry.m_key.appendTo(result);
+        result += ": ";
+        entry.m_value.appendTo(result);
+    }
+    result += "}";
+    s_printing.pop_back();
+
+    return result;
+}
+
+void LukMap::traverse(GcVisitor& visitor) {
+    for (auto& entry: m_entries) {
+        visitor.visit(entry.m_key);
+        visitor.visit(entry.m_value);
+    }
+}
+
+void LukMap::clearRefs() {
+    m_entries.clear();
+    m_index.clear();
+    m_count =0;
+}
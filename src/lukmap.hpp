@@ -0,0 +1,74 @@
+#ifndef LUKMAP_HPP
+#define LUKMAP_HPP
+
+#include "common.hpp"
+#include "lukheap.hpp"
+#include "lukobject.hpp"
+#include "lukgc.hpp"
+
+#include <cstdint> // int32_t
+#include <string>
+#include <vector>
+
+namespace luky {
+    /// Note: native map, keyed by strings, numbers and bools.
+    /// The entries are stored in a flat vector, in insertion order, with the hash of their key,
+    /// an open addressing index with linear probing gives the entry of each hash,
+    /// so a lookup probes a compact array of integers, and compares the key
+    /// only whether the cached hashes are equal.
+    /// A deleted entry is left as a hole until the next rebuild of the index.
+    /// A map can hold itself, so it's tracked by the cycle collector.
+    class LukMap : public LukHeap, public GcObject {
+    public:
+        LukMap() {}
+        ~LukMap() {}
+
+        // Note: a key is a string, a number or a bool, an int and an equal double are the same key
+        static bool isKey(const LukObject& key) noexcept;
+        static size_t hashKey(const LukObject& key) noexcept;
+        static bool keyEquals(const LukObject& a, const LukObject& b) noexcept;
+
+        size_t size() const noexcept { return m_count; }
+        // returns the value of the key, nullptr whether the key is not in the map
+        // Note: the pointer is valid until the next insertion
+        LukObject* find(const LukObject& key);
+        void set(const LukObject& key, const LukObject& val);
+        // returns whether the key was in the map
+        bool remove(const LukObject& key);
+        // keys in insertion order
+        std::vector<LukObject> keys() const;
+
+        bool equals(LukMap& other);
+        std::string toString() const;
+
+        // cycle collector
+        virtual GcObject* gcObject() noexcept override { return this; }
+        virtual LukHeap* gcHeap() noexcept override { return this; }
+        virtual void traverse(GcVisitor& visitor) override;
+        virtual void clearRefs() override;
+        virtual size_t gcOwners() const override { return refCount(); }
+
+    private:
+        // Note: a deleted entry has a nil key
+        struct Entry {
+            size_t m_hash;
+            LukObject m_key;
+            LukObject m_value;
+        };
+
+        static constexpr int32_t EmptySlot = -1;
+        static constexpr int32_t DeletedSlot = -2;
+        static constexpr size_t MinCapacity = 8;
+
+        // returns the slot of the index holding the key, -1 whether the key is not in the map
+        long findSlot(const LukObject& key, size_t hash) const;
+        // Note: drops the deleted entries, and rebuilds the index with a capacity for count entries
+        void rebuild(size_t count);
+
+        std::vector<Entry> m_entries;
+        std::vector<int32_t> m_index;
+        size_t m_count =0;
+    };
+}
+
+#endif // LUKMAP_HPP
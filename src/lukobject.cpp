@@ -4,9 +4,13 @@
  * */
 
 #include "lukobject.hpp"
+#include "lukstring.hpp"
 #include "lukcallable.hpp"
-#include "lukfunction.hpp"
 #include "lukinstance.hpp"
+#include "luklist.hpp"
+#include "lukmap.hpp"
+#include "lukarray.hpp"
+#include "lukrange.hpp"
 #include "runtimeerror.hpp"
 #include <iostream> // cout and cerr
 #include <sstream> // ostringstream
@@ -15,103 +19,108 @@
 
 using namespace luky;
 
-int LukObject::next_id =0;
-ObjPtr LukObject::stat_nilPtr = LukObject::getNilPtr();
+void LukHeap::destroy() noexcept {
+    delete this;
+}
 
 // constructors
-    
-LukObject::LukObject() 
-    : id(++next_id) { 
-    logMsg("\nLukObject constructor, id: ", id, ", val: Nil");
-    m_type = LukType::Nil;  
-    m_string = "nil";
-    // p_string = nullptr;
-    p_callable = nullptr;
-    p_instance = nullptr;
-    logMsg("\nExit out constructor nil");
+LukObject::LukObject(const std::string& val)
+        : m_type(LukType::String) {
+    // Note: an empty string is displayed with its quotes
+    p_heap = new LukString(val == "" ? "''" : val);
+    p_heap->retain();
 }
 
-LukObject::LukObject(bool val) 
-        : id(++next_id), m_bool(val) {
-    logMsg("\nLukObject constructor bool,  id: ", id);
-    m_type = LukType::Bool; 
+LukObject::LukObject(std::string&& val)
+        : m_type(LukType::String) {
+    if (val.empty()) val = "''";
+    p_heap = new LukString(std::move(val));
+    p_heap->retain();
 }
 
-LukObject::LukObject(TLukInt val) 
-        : id(++next_id), m_int(val) {
-    logMsg("\nLukObject constructor int,  id: ", id, "val: ", val);
-    m_type = LukType::Int;
+LukObject::LukObject(const char* val)
+        : m_type(LukType::String) {
+    p_heap = new LukString(std::string(val));
+    p_heap->retain();
 }
 
-LukObject::LukObject(double val) 
-        : id(++next_id), m_double(val) {
-    logMsg("\nLukObject constructor double,  id: ", id, "val: ", val);
-    m_type = LukType::Double; 
+LukObject::LukObject(LukRef<LukCallable> callable)
+        : m_type(LukType::Callable) {
+    p_heap = callable.heap();
+    p_heap->retain();
 }
 
-LukObject::LukObject(const std::string& val) 
-        : id(++next_id), m_string(val) {
-          if (m_string == "") m_string = "''";
-    logMsg("\nLukObject constructor string,  id: ", id, "val: ", val);
-    m_type = LukType::String; 
+LukObject::LukObject(LukRef<LukString> str)
+        : m_type(LukType::String) {
+    p_heap = str.heap();
+    p_heap->retain();
 }
 
-LukObject::LukObject(const char* val) 
-        : id(++next_id), m_string(std::string(val)) {
-    logMsg("\nLukObject constructor char*,  id: ", id, "val: ", val);
-    m_type = LukType::String; 
+LukObject::LukObject(LukRef<LukInstance> instance)
+        : m_type(LukType::Instance) {
+    p_heap = instance.heap();
+    p_heap->retain();
 }
 
-LukObject::LukObject(std::shared_ptr<LukCallable> callable)
-        : id(++next_id), p_callable(callable) {
-    logMsg("\nLukObject constructor callable,  id: ", id, "val: ", callable->toString());
-    m_type = LukType::Callable;
-    m_string = callable->toString();
+LukObject::LukObject(LukRef<LukList> list)
+        : m_type(LukType::List) {
+    p_heap = list.heap();
+    p_heap->retain();
 }
 
-// std::shared_ptr<LukFunction> LukObject::getFunc() { return std::make_shared<LukFunction>(p_callable); }
+LukObject::LukObject(LukRef<LukMap> map)
+        : m_type(LukType::Map) {
+    p_heap = map.heap();
+    p_heap->retain();
+}
 
-LukObject::LukObject(std::shared_ptr<LukInstance> instance)
-        : id(++next_id), p_instance(instance) {
-    logMsg("\nLukObject constructor instance,  id: ", id, "val: ", instance->toString());
-    m_type = LukType::Instance;
-    logMsg("\nIn LukObject instance toString: ", instance->toString());
-    m_string = p_instance->toString();
+LukObject::LukObject(LukRef<LukArray> array)
+        : m_type(LukType::Array) {
+    p_heap = array.heap();
+    p_heap->retain();
 }
 
-LukObject::LukObject(nullptr_t) 
-      : id(++next_id) {
-  logMsg("\nIn LukObject constructor nullptr: ");
-        m_type = LukType::Nil;
-        m_string = "nil";
-        // p_string = nullptr;
-        p_callable = nullptr;
-        p_instance = nullptr;
+LukObject::LukObject(LukRef<LukRange> range)
+        : m_type(LukType::Range) {
+    p_heap = range.heap();
+    p_heap->retain();
 }
 
+// getters for heap objects
+const std::string& LukObject::getString() const {
+    return static_cast<LukString*>(p_heap)->str();
+}
 
-// copy constructor
-LukObject::LukObject(const LukObject& obj) {
-    // avoid copy of same object
-    if (this != &obj) {
-      swap(obj);
-      // cannot use obj.getId function, cause obj is constant
-      logMsg("\nIn LukObject, copy constructor, id: ", id, ", val: ");
-      
-    }
+std::string_view LukObject::getView() const noexcept {
+    return static_cast<LukString*>(p_heap)->view();
+}
 
+LukString* LukObject::getLukString() const noexcept {
+    return static_cast<LukString*>(p_heap);
 }
 
-// move constructor
-LukObject::LukObject(const LukObject&& obj) {
-    // avoid copy of same object
-    if (this != &obj) {
-      swap(obj);
-      // cannot use obj.getId function, cause obj is constant
-      logMsg("\nIn LukObject, move constructor, id: ", id, ", val: ", obj);
-      
-    }
+LukCallable* LukObject::getCallable() const noexcept {
+    return static_cast<LukCallable*>(p_heap);
+}
+
+LukInstance* LukObject::getInstance() const noexcept {
+    return static_cast<LukInstance*>(p_heap);
+}
 
+LukList* LukObject::getList() const noexcept {
+    return static_cast<LukList*>(p_heap);
+}
+
+LukMap* LukObject::getMap() const noexcept {
+    return static_cast<LukMap*>(p_heap);
+}
+
+LukArray* LukObject::getArray() const noexcept {
+    return static_cast<LukArray*>(p_heap);
+}
+
+LukRange* LukObject::getRange() const noexcept {
+    return static_cast<LukRange*>(p_heap);
 }
 
 std::string LukObject::typeOf() const {
@@ -123,103 +132,75 @@ std::string LukObject::typeOf() const {
         case LukType::String: return "string";
         case LukType::Callable:  return "callable";
         case LukType::Instance:  return "instance";
+        case LukType::List:  return "list";
+        case LukType::Map:  return "map";
+        case LukType::Array:  return getArray()->kindName();
+        case LukType::Range:  return "range";
     }
     throw RuntimeError("Cannot determine the object's type.");
 
     return "''";
 }
 
-// returns the current value to string
-std::string LukObject::value() {
-       return _toString();
-}
-
 // convertions
-bool LukObject::toBool() {
-        if (m_type == LukType::Bool) return m_bool;
-        m_bool = _toBool();
-        m_type = LukType::Bool;
-        return m_bool;
-}
-
-TLukInt LukObject::toInt() {
-        if (m_type == LukType::Int) return m_int;
-        m_int = _toInt();
-        m_type = LukType::Int;
-        return m_int;
-}
- 
-double LukObject::toDouble() {
-        if (m_type == LukType::Double) return m_double;
-        m_double = _toDouble();
-        m_type = LukType::Double;
-        return m_double;
-    }
-    
-std::string LukObject::toString() {
-  // Warning: not change the m_type to string      
-  if (m_type == LukType::String) return m_string;
-    // return *p_string;
-  // m_type = LukType::String;
-  return _toString();
-}
-
-bool LukObject::_toBool() const {
+bool LukObject::toBool() const {
     switch(m_type) {
         case LukType::Nil: return false;
-        case LukType::Bool: return m_bool != 0;
+        case LukType::Bool: return m_bool;
         case LukType::Int: return m_int != 0;
         case LukType::Double: return m_double != 0;
-        case LukType::String: return m_string != "";
-        // return p_string != nullptr;
+        case LukType::String: return !getView().empty();
+        case LukType::List: return getList()->size() != 0;
+        case LukType::Map: return getMap()->size() != 0;
+        case LukType::Array: return getArray()->size() != 0;
+        case LukType::Range: return getRange()->size() != 0;
         // callables and classes are true by default
         case LukType::Callable:
-        case LukType::Instance: 
+        case LukType::Instance:
             return true;
     }
-    
+
     throw RuntimeError("Invalid convertion to bool\n");
 
     return false;
 }
 
-TLukInt LukObject::_toInt() const {
+TLukInt LukObject::toInt() const {
     switch(m_type) {
         case LukType::Nil: return 0;
         case LukType::Bool: return m_bool ? 1 : 0;
         case LukType::Int: return m_int;
-        case LukType::Double: return int(m_double);
+        case LukType::Double: return TLukInt(m_double);
         case LukType::String: {
             TLukInt i;
             try {
-                i = std::stol(m_string);
+                i = std::stol(getString());
             } catch (const std::invalid_argument &) {
                 // not throw exception
-                // std::cerr << "Argument is invalid\n";
-                // throw 
                 return 0;
             } catch(const std::out_of_range &) {
-                // std::cerr << "Argument is out of range for a double\n";
-                // throw;
                 return 0;
             }
-            
+
             return i;
         }
         break;
 
-        case LukType::Callable:  
-        case LukType::Instance:  
+        case LukType::Callable:
+        case LukType::Instance:
+        case LukType::List:
+        case LukType::Map:
+        case LukType::Array:
+        case LukType::Range:
         break;
-        
+
     }
     throw RuntimeError("Cannot convert object to int.");
 
     return 0;
 }
 
-
-double LukObject::_toDouble() const {
+double LukObject::toDouble() const {
     switch(m_type) {
         case LukType::Nil: return 0.;
         case LukType::Bool: return m_bool ? 1.0 : 0.0;
@@ -228,43 +209,50 @@ double LukObject::_toDouble() const {
         case LukType::String: {
             double d;
             try {
-                d = std::stod(m_string);
+                d = std::stod(getString());
             } catch (const std::invalid_argument &) {
                 // not throw exception
-                // std::cerr << "Argument is invalid\n";
-                // throw 
                 return 0.;
             } catch(const std::out_of_range &) {
-                // std::cerr << "Argument is out of range for a double\n";
-                // throw;
                 return 0.;
             }
-            
+
             return d;
         }
         break;
 
-        case LukType::Callable:  
-        case LukType::Instance:  
+        case LukType::Callable:
+        case LukType::Instance:
+        case LukType::List:
+        case LukType::Map:
+        case LukType::Array:
+        case LukType::Range:
         break;
-        
+
     }
     throw RuntimeError("Cannot convert object to double.");
 
     return 0.;
 }
 
-std::string LukObject::_toString() const {
+void LukObject::appendTo(std::string& out) const {
+    if (isString()) out += getView();
+    else out += toString();
+}
+
+std::string LukObject::toString() const {
     switch(m_type) {
         case LukType::Nil: return "nil";
         case LukType::Bool: return (m_bool ? "true" : "false");
         case LukType::Int: return std::to_string(m_int);
         case LukType::Double: return stripZeros( std::to_string(m_double) );
-        case LukType::String: return m_string;
-        case LukType::Callable: 
-        case LukType::Instance: 
-          return m_string;
-          // return *p_string;
+        case LukType::String: return std::string(getView());
+        case LukType::Callable: return getCallable()->toString();
+        case LukType::Instance: return getInstance()->toString();
+        case LukType::List: return getList()->toString();
+        case LukType::Map: return getMap()->toString();
+        case LukType::Array: return getArray()->toString();
+        case LukType::Range: return getRange()->toString();
     }
     throw RuntimeError("Cannot convert object to string.");
 
@@ -277,467 +265,141 @@ std::string LukObject::stripZeros(std::string str) const {
     // keeping the first zero whether they are only zeros after the dot
     if (str[pos] == '.') str.erase(pos +2, std::string::npos);
     else str.erase(pos +1, std::string::npos);
-    // returning a constant string
-    auto result = str;
-    
-    return result;
-
-
-}
-
-// casting to the right type
-void LukObject::cast(LukType tp) {
-    if (m_type == tp) return;
-    switch(tp) {
-        case LukType::Nil: break;
-        case LukType::Bool: m_bool = bool(*this); break;
-        case LukType::Int: m_int = int(*this); break;
-        case LukType::Double: m_double = double(*this); break;
-        case LukType::String: m_string = std::string(*this); break;
-        case LukType::Callable: 
-        case LukType::Instance: 
-            break;
-    
-    }
-    m_type = tp;
 
+    return str;
 }
 
-// assignment operators
-std::shared_ptr<LukObject> LukObject::operator=(nullptr_t) {
-  logMsg("\nIn LukObject nullptr assignment operator: ");
-        m_type = LukType::Nil;
-        m_string = "nil";
-        // p_string = nullptr;
-        p_callable = nullptr;
-        p_instance = nullptr;
-        return std::make_shared<LukObject>(*this);
-}
-
-std::shared_ptr<LukObject> LukObject::operator=(ObjPtr obj) {
-  logMsg("\nIn LukObject shared pointer  assignment operator: ");
-        m_type = obj->m_type;
-        m_int = obj->m_int;
-        m_double = obj->m_double;
-        m_string = obj->m_string;
-        p_callable = obj->p_callable;
-        p_instance = obj->p_instance;
-        return std::make_shared<LukObject>(*this);
-}
-
-
-LukObject& LukObject::operator=(const bool&& val) { 
-    id = ++next_id;
-    m_type = LukType::Bool;
-    m_bool = val;
-    return *this;
-}
-
-LukObject& LukObject::operator=(const TLukInt&& val)  {
-    id = ++next_id;
-    m_type = LukType::Int;
-    m_int = val;
-    return *this;
-}
-
-LukObject& LukObject::operator=(const double&& val) { 
-    id = ++next_id;
-    m_type = LukType::Double;
-    m_double = val;
-    return *this;
-}
-
-// implement overloaded char* to avoid implicit casting to bool
-LukObject& LukObject::operator=(const char* &&val) {
-    id = ++next_id;
-    m_type = LukType::String;
-    m_string = std::string(val);
-    return *this;
-}
-
-
-LukObject& LukObject::operator=(const std::string&& val) {
-    id = ++next_id;
-    m_type = LukType::String;
-    m_string = val;
-    return *this;
-}
-
-// Note: swap function to avoid duplicate code between copy constructor and copy assignment operator
-void LukObject::swap(const LukObject& obj) {
-    id = ++next_id;
-    m_type = obj.m_type;
-    m_bool = obj.m_bool; 
-    m_int = obj.m_int; 
-    m_double = obj.m_double;
-    m_string = obj.m_string;
-    p_callable = obj.p_callable;
-    // Note: dont forget to associate p_instance in operator =
-    p_instance = obj.p_instance;
-}
-
-// copy assignment operator
-LukObject& LukObject::operator=(const LukObject& obj) { 
-    // avoid copy of same object
-    if (this == &obj) return *this;
-    swap(obj);
-    logMsg("\nIn LukObject, Copy Assignment operator, id: ", id, ", val: ", obj);
-
-    return *this;
-}
-
-
-// move assignment operator
-LukObject& LukObject::operator=(const LukObject&& obj) { 
-    // avoid copy of same object
-    if (this == &obj) return *this;
-    swap(obj);
-    logMsg("Move Assignment operator, id: ", id, ", val: ", obj);
-
-    return *this;
-}
-
-// compound assignment operators
-// += operator
-LukObject& LukObject::operator+=(const LukObject& obj) {
-    if (m_type == obj.m_type)  {
-        switch(m_type) {
-            case LukType::Nil:
-                throw RuntimeError("Cannot add nil");
-            case LukType::Bool:
-                throw RuntimeError("Cannot add bools");
-            case LukType::Int:
-                m_int += obj.m_int; break;
-            case LukType::Double:
-                m_double += obj.m_double; break;
-            case LukType::String:
-                m_string += obj.m_string; break;
-                // oss << m_string << obj.m_string;
-                break;
-            default:
-                throw RuntimeError("Cannot add objects.");
-        }
-
-        return (*this);
-    }
-    
-    if (m_type < obj.m_type) {
-        cast(obj.m_type);
-        return (*this) += obj;
-    } else {
-        auto ob = obj;
-        ob.cast(m_type);
-        return (*this) += ob;
+// arithmetic operators
+// Note: bools are promoted to int, and int to double, whether the operands have not the same type.
+LukObject luky::operator+(const LukObject& a, const LukObject& b) {
+    if (a.isInt() && b.isInt()) return LukObject(a.m_int + b.m_int);
+    if (a.isNil() || b.isNil()) throw RuntimeError("Cannot add nil");
+    if (a.isBool() && b.isBool()) throw RuntimeError("Cannot add bools");
+    if (a.isDouble() || b.isDouble()) {
+        if (a.isNumeric() && b.isNumeric())
+            return LukObject(a.toDouble() + b.toDouble());
+    } else if (a.isNumeric() && b.isNumeric()) {
+        return LukObject(a.toInt() + b.toInt());
     }
+    if (a.isString() || b.isString())
+        return LukObject(a.toString() + b.toString());
 
+    throw RuntimeError("Cannot add objects.");
 }
 
-// -= operator
-LukObject& LukObject::operator-=(const LukObject& obj) {
-    if (m_type == obj.m_type)  {
-        switch(m_type) {
-            case LukType::Nil:
-                throw RuntimeError("Cannot substract nil");
-            case LukType::Bool:
-                throw RuntimeError("Cannot substract bools");
-            case LukType::Int:
-                m_int -= obj.m_int; break;
-            case LukType::Double:
-                m_double -= obj.m_double; break;
-            case LukType::String:
-                throw RuntimeError("Cannot substract strings.");
-            default:
-                throw RuntimeError("Cannot substract objects.");
-        }
-
-        return (*this);
-    }
-    
-    if (m_type < obj.m_type) {
-        cast(obj.m_type);
-        return (*this) -= obj;
-    } else {
-        auto ob = obj;
-        ob.cast(m_type);
-        return (*this) -= ob;
-    }
+LukObject luky::operator-(const LukObject& a, const LukObject& b) {
+    if (a.isInt() && b.isInt()) return LukObject(a.m_int - b.m_int);
+    if (a.isNil() || b.isNil()) throw RuntimeError("Cannot substract nil");
+    if (a.isBool() && b.isBool()) throw RuntimeError("Cannot substract bools");
+    if (a.isString() || b.isString()) throw RuntimeError("Cannot substract strings.");
+    if (!a.isNumeric() || !b.isNumeric()) throw RuntimeError("Cannot substract objects.");
+    if (a.isDouble() || b.isDouble()) return LukObject(a.toDouble() - b.toDouble());
 
+    return LukObject(a.toInt() - b.toInt());
 }
 
+LukObject luky::operator*(const LukObject& a, const LukObject& b) {
+    if (a.isInt() && b.isInt()) return LukObject(a.m_int * b.m_int);
+    if (a.isNil() || b.isNil()) throw RuntimeError("Cannot multiply nil");
+    if (a.isBool() && b.isBool()) throw RuntimeError("Cannot multiply bools");
+    if (a.isString() || b.isString()) throw RuntimeError("Cannot multiply strings.");
+    if (!a.isNumeric() || !b.isNumeric()) throw RuntimeError("Cannot multiply objects.");
+    if (a.isDouble() || b.isDouble()) return LukObject(a.toDouble() * b.toDouble());
 
-// *= operator
-LukObject& LukObject::operator*=(const LukObject& obj) {
-    if (m_type == obj.m_type)  {
-        switch(m_type) {
-            case LukType::Nil:
-                throw RuntimeError("Cannot multiply nil");
-            case LukType::Bool:
-                throw RuntimeError("Cannot multiply bools");
-            case LukType::Int:
-                m_int *= obj.m_int; break;
-            case LukType::Double:
-                m_double *= obj.m_double; break;
-            case LukType::String:
-                throw RuntimeError("Cannot multiply strings.");
-            default:
-                throw RuntimeError("Cannot multiply objects.");
-        }
-
-        return (*this);
-    }
-    
-    if (m_type < obj.m_type) {
-        cast(obj.m_type);
-        return (*this) *= obj;
-    } else {
-        auto ob = obj;
-        ob.cast(m_type);
-        return (*this) *= ob;
-    }
-
+    return LukObject(a.toInt() * b.toInt());
 }
 
-// /= operator
-LukObject& LukObject::operator/=(const LukObject& obj) {
-    double num;
-    if (m_type == obj.m_type)  {
-        switch(m_type) {
-            case LukType::Nil:
-                throw RuntimeError("Cannot divide nil");
-            case LukType::Bool:
-                throw RuntimeError("Cannot divide bools");
-            case LukType::Int:
-                num = double(m_int) / obj.m_int;
-                if ( std::fmod(num, 1) == 0) m_int = int(num); 
-                else {
-                    m_double = num;
-                    m_type = LukType::Double;
-                }
-                break;
-            case LukType::Double:
-                m_double /= obj.m_double; break;
-            case LukType::String:
-                throw RuntimeError("Cannot divide strings.");
-            default:
-                throw RuntimeError("Cannot divide objects.");
-        }
+LukObject luky::operator/(const LukObject& a, const LukObject& b) {
+    if (a.isNil() || b.isNil()) throw RuntimeError("Cannot divide nil");
+    if (a.isBool() && b.isBool()) throw RuntimeError("Cannot divide bools");
+    if (a.isString() || b.isString()) throw RuntimeError("Cannot divide strings.");
+    if (!a.isNumeric() || !b.isNumeric()) throw RuntimeError("Cannot divide objects.");
+    if (a.isDouble() || b.isDouble()) return LukObject(a.toDouble() / b.toDouble());
 
-        return (*this);
-    }
-    
-    if (m_type < obj.m_type) {
-        cast(obj.m_type);
-        return (*this) /= obj;
-    } else {
-        auto ob = obj;
-        ob.cast(m_type);
-        return (*this) /= ob;
-    }
+    // integer division returns an int only whether there is no remainder
+    double num = double(a.toInt()) / b.toInt();
+    if ( std::fmod(num, 1) == 0) return LukObject(TLukInt(num));
 
+    return LukObject(num);
 }
 
-LukObject& LukObject::operator%=(const LukObject& obj) {
-    if (m_type == obj.m_type)  {
-        switch(m_type) {
-            case LukType::Nil:
-                throw RuntimeError("Cannot modulus nil");
-            case LukType::Bool:
-                throw RuntimeError("Cannot modulus bools");
-            case LukType::Int:
-                m_int %= obj.m_int; break;
-            case LukType::Double:
-                m_double = std::fmod(m_double, obj.m_double); break;
-            case LukType::String:
-                throw RuntimeError("Cannot modulus strings.");
-            default:
-                throw RuntimeError("Cannot modulus objects.");
-        }
-
-        return (*this);
-    }
-    
-    if (m_type < obj.m_type) {
-        cast(obj.m_type);
-        return (*this) %= obj;
-    } else {
-        auto ob = obj;
-        ob.cast(m_type);
-        return (*this) %= ob;
-    }
+LukObject luky::operator%(const LukObject& a, const LukObject& b) {
+    if (a.isNil() || b.isNil()) throw RuntimeError("Cannot modulus nil");
+    if (a.isBool() && b.isBool()) throw RuntimeError("Cannot modulus bools");
+    if (a.isString() || b.isString()) throw RuntimeError("Cannot modulus strings.");
+    if (!a.isNumeric() || !b.isNumeric()) throw RuntimeError("Cannot modulus objects.");
+    // Note: cannot use modulus % on double
+    // use instead fmod function for modulus between double
+    if (a.isDouble() || b.isDouble()) return LukObject(std::fmod(a.toDouble(), b.toDouble()));
+    if (b.toInt() == 0) throw RuntimeError("Integer modulus by zero.");
 
+    return LukObject(a.toInt() % b.toInt());
 }
 
 // bitwise operators
-// bitwise OR operator
-LukObject& LukObject::operator|=(const LukObject& obj) {
-    if (m_type == obj.m_type)  {
-        switch(m_type) {
-            case LukType::Bool:
-                m_bool |= obj.m_bool; break;
-            case LukType::Int:
-                m_int |= obj.m_int; break;
-            default:
-                throw RuntimeError("Operands must be bools or integers");
-        }
-
-        return (*this);
-    }
-    
-    if (m_type < obj.m_type) {
-        cast(obj.m_type);
-        return (*this) |= obj;
-    } else {
-        auto ob = obj;
-        ob.cast(m_type);
-        return (*this) |= ob;
-    }
+// Note: two bools give a bool, otherwise the bools are promoted to int
+LukObject luky::operator|(const LukObject& a, const LukObject& b) {
+    if (!a.isBoolInt() || !b.isBoolInt())
+        throw RuntimeError("Operands must be bools or integers");
+    if (a.isBool() && b.isBool()) return LukObject(bool(a.m_bool | b.m_bool));
 
+    return LukObject(a.toInt() | b.toInt());
 }
 
-// bitwise AND operator
-LukObject& LukObject::operator&=(const LukObject& obj) {
-    if (m_type == obj.m_type)  {
-        switch(m_type) {
-            case LukType::Bool:
-                m_bool &= obj.m_bool; break;
-            case LukType::Int:
-                m_int &= obj.m_int; break;
-            default:
-                throw RuntimeError("Operands must be bools or integers");
-        }
-
-        return (*this);
-    }
-    
-    if (m_type < obj.m_type) {
-        cast(obj.m_type);
-        return (*this) &= obj;
-    } else {
-        auto ob = obj;
-        ob.cast(m_type);
-        return (*this) &= ob;
-    }
-
-}
-
-// bitwise XOR operator
-LukObject& LukObject::operator^=(const LukObject& obj) {
-    if (m_type == obj.m_type)  {
-        switch(m_type) {
-            case LukType::Bool: m_bool ^= obj.m_bool; break;
-            case LukType::Int: m_int ^= obj.m_int; break;
-            default:
-                throw RuntimeError("Operands must be bools or integers");
-        }
-
-        return (*this);
-    }
-    
-    if (m_type < obj.m_type) {
-        cast(obj.m_type);
-        return (*this) ^= obj;
-    } else {
-        auto ob = obj;
-        ob.cast(m_type);
-        return (*this) ^= ob;
-    }
+LukObject luky::operator&(const LukObject& a, const LukObject& b) {
+    if (!a.isBoolInt() || !b.isBoolInt())
+        throw RuntimeError("Operands must be bools or integers");
+    if (a.isBool() && b.isBool()) return LukObject(bool(a.m_bool & b.m_bool));
 
+    return LukObject(a.toInt() & b.toInt());
 }
 
-// bitwise NOT operator
-LukObject operator~(LukObject a) {
-    switch(a.m_type) {
-        // Note: for ~ operator, bool value returns -1 or -2, 
-        // so it's an integer
-      case LukType::Bool:  a.m_int = a.m_bool == 0 ? -1 : -2;
-            a.m_type = LukType::Int; break;
-        case LukType::Int: a.m_int = ~a.m_int; break;
-        default:
-            throw RuntimeError("cannot bitwise NOT object.");
-    }
+LukObject luky::operator^(const LukObject& a, const LukObject& b) {
+    if (!a.isBoolInt() || !b.isBoolInt())
+        throw RuntimeError("Operands must be bools or integers");
+    if (a.isBool() && b.isBool()) return LukObject(bool(a.m_bool ^ b.m_bool));
 
-    return a;
+    return LukObject(a.toInt() ^ b.toInt());
 }
 
-// bitwise shift left operator
-LukObject& LukObject::operator<<=(const LukObject& obj) {
-    if (m_type == obj.m_type)  {
-        switch(m_type) {
-            case LukType::Bool: m_int <<= obj.m_bool; 
-                m_type = LukType::Int; break;
-            case LukType::Int: m_int <<= obj.m_int; break;
-            default:
-                throw RuntimeError("Operands must be bools or integers");
-        }
-
-        return (*this);
-    }
-    
-    if (m_type < obj.m_type) {
-        cast(obj.m_type);
-        return (*this) <<= obj;
-    } else {
-        auto ob = obj;
-        ob.cast(m_type);
-        return (*this) <<= ob;
-    }
+// Note: bitwise shift operators returns always an int
+LukObject luky::operator<<(const LukObject& a, const LukObject& b) {
+    if (!a.isBoolInt() || !b.isBoolInt())
+        throw RuntimeError("Operands must be bools or integers");
 
+    return LukObject(a.toInt() << b.toInt());
 }
 
-// bitwise shift right operator
-LukObject& LukObject::operator>>=(const LukObject& obj) {
-    if (m_type == obj.m_type)  {
-        switch(m_type) {
-            case LukType::Bool: m_int >>= obj.m_bool; 
-                m_type = LukType::Int; break;
-            case LukType::Int: m_int >>= obj.m_int; break;
-            default:
-                throw RuntimeError("Operands must be bools or integers");
-        }
-
-        return (*this);
-    }
-    
-    if (m_type < obj.m_type) {
-        cast(obj.m_type);
-        return (*this) >>= obj;
-    } else {
-        auto ob = obj;
-        ob.cast(m_type);
-        return (*this) >>= ob;
-    }
+LukObject luky::operator>>(const LukObject& a, const LukObject& b) {
+    if (!a.isBoolInt() || !b.isBoolInt())
+        throw RuntimeError("Operands must be bools or integers");
 
+    return LukObject(a.toInt() >> b.toInt());
 }
 
-
 // unary operators
 // unary minus operator
-LukObject luky::operator-(LukObject a) {
+LukObject luky::operator-(const LukObject& a) {
     switch(a.m_type) {
-        case LukType::Bool: a.m_bool = -a.m_bool; break;
-        case LukType::Int: a.m_int = -a.m_int; break;
-        case LukType::Double: a.m_double = -a.m_double; break;
-        default: 
+        // Note: the negation of a bool stays the same bool
+        case LukType::Bool: return a;
+        case LukType::Int: return LukObject(-a.m_int);
+        case LukType::Double: return LukObject(-a.m_double);
+        default:
             throw RuntimeError("Unary minus cannot apply for this type.");
     }
-
-    return a;
 }
-   
-// unary not operator
-LukObject operator!(LukObject a) {
+
+// bitwise NOT operator
+LukObject luky::operator~(const LukObject& a) {
     switch(a.m_type) {
-        case LukType::Nil: a.m_bool = true; break;
-        case LukType::Bool:  a.m_bool = !a.m_bool; break;
-        case LukType::Int: a.m_bool = a.m_int == 0; break;
-        case LukType::Double: a.m_bool = a.m_double == 0.; break;
-        case LukType::String: a.m_bool = a.m_string == ""; break;
+        // Note: for ~ operator, bool value returns -1 or -2,
+        // so it's an integer
+        case LukType::Bool: return LukObject(TLukInt(a.m_bool ? -2 : -1));
+        case LukType::Int: return LukObject(~a.m_int);
         default:
-            throw RuntimeError("cannot negate object.");
+            throw RuntimeError("cannot bitwise NOT object.");
     }
-
-    a.m_type = LukType::Bool;
-    return a;
 }
 
 // equality operators
@@ -749,19 +411,23 @@ bool luky::operator==(const LukObject& a, const LukObject& b) {
             case LukType::Bool: return a.m_bool == b.m_bool;
             case LukType::Int: return a.m_int == b.m_int;
             case LukType::Double: return a.m_double == b.m_double;
-            case LukType::String: return a.m_string == b.m_string;
-            default: 
+            case LukType::String: return a.getLukString()->equals(*b.getLukString());
+            case LukType::List: return a.getList()->equals(*b.getList());
+            case LukType::Map: return a.getMap()->equals(*b.getMap());
+            case LukType::Array: return a.getArray()->equals(*b.getArray());
+            case LukType::Range: return a.getRange()->equals(*b.getRange());
+            default:
                 throw RuntimeError("Cannot compare objects for equality.");
         }
     }
 
     if (a.m_type > b.m_type) return b == a;
     if (a.m_type == LukType::Nil || b.m_type == LukType::Nil) return false;
-    
+
     // whether a.m_type < b.m_type
     switch(a.m_type) {
-        case LukType::Bool: return a.m_bool == bool(b);
-        case LukType::Int: 
+        case LukType::Bool: return a.m_bool == b.toBool();
+        case LukType::Int:
               if (b.isDouble()) return a.m_int == b.m_double;
               break;
         case LukType::Double: return false;
@@ -769,7 +435,7 @@ bool luky::operator==(const LukObject& a, const LukObject& b) {
         default:
             throw RuntimeError("Cannot compare objects for equality.");
     }
-    
+
     return false;
 }
 
@@ -782,7 +448,6 @@ bool luky::operator>(LukType a, LukType b) {
     return static_cast<int>(a) > static_cast<int>(b);
 }
 
-// /*
 bool luky::operator<(const LukObject& a, const LukObject& b) {
     if (a.m_type == b.m_type) {
         switch(a.m_type) {
@@ -791,23 +456,14 @@ bool luky::operator<(const LukObject& a, const LukObject& b) {
                 throw RuntimeError("Nil and Bool cannot odered.");
             case LukType::Int: return a.m_int < b.m_int;
             case LukType::Double: return a.m_double < b.m_double;
-            case LukType::String: return a.m_string < b.m_string;
-            default: 
+            case LukType::String: return a.getView() < b.getView();
+            default:
                   throw RuntimeError("Objects cannot ordered.");
         }
     }
     if (a.isNumber() && b.isNumber()) {
-        if (a.isInt()) return a.m_int < a.m_double;
-        if (a.isDouble()) return a.m_double < a.m_int;
+        return a.getNumber() < b.getNumber();
     }
 
-
     throw RuntimeError("Only objects of the same type can be ordered.");
 }
-// */
-// bool operator<=(const luky::LukObject& a, const luky::LukObject& b) { return a< b || a == b; }
-
-/* 
- * Note: other operators like binary operators, are implemented inline in the header .hpp file
-*/
-
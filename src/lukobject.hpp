@@ -2,14 +2,14 @@
 #define LUKOBJECT_HPP
 
 #include "common.hpp"
-#include "lukinstance.hpp"
+#include "lukheap.hpp"
 #include "logger.hpp"
 
 #include <sstream> // ostreamstring
 #include <string>
+#include <string_view>
 #include <iostream>
-#include <memory>
-#include <functional>
+#include <cstdint> // uint8_t
 
 // Note: best practice:
 // to avoid circular dependencies files,
@@ -19,85 +19,111 @@
 
 namespace luky {
     // forward declarations
+    class LukArray;
     class LukCallable;
-    class LukFunction;
-    class LukObject;
     class LukInstance;
-    // using ObjPtr = std::shared_ptr<LukObject>;
-    // macro to make global variable the static nilptr
-#define nilptr LukObject::getStatNilPtr()
+    class LukList;
+    class LukMap;
+    class LukRange;
+    class LukString;
 
-    enum class LukType { 
+    enum class LukType : uint8_t {
         Nil=0, Bool=1, Int=2, Double=3, String=4,
-        Callable =5, Instance=6
+        Callable =5, Instance=6, List=7, Map=8, Array=9, Range=10
     };
-    class LukObject {
-    protected:
-        static int next_id;
-        // Note: static variable must defining in the .cpp file
-        // to avoid multiple header inclusion and compile error
-        static ObjPtr stat_nilPtr;
 
+    /// Note: LukObject is an immediate value of 16 bytes: a type tag and a payload.
+    /// Nil, bool, int and double are stored directly in the payload, without touching the heap,
+    /// strings, callables, instances, lists, maps, arrays and ranges are stored behind a single LukHeap pointer,
+    /// which is reference counted by the copy and the destructor.
+    class LukObject {
     public:
-        int id;
         LukType m_type;
-        bool m_bool = false;
-        TLukInt m_int =0;
-        double m_double =0.;
-        std::string m_string = "";
-        std::shared_ptr<std::string> p_string;
-        std::shared_ptr<LukCallable> p_callable;
-        std::shared_ptr<LukInstance> p_instance;
-     
+        union {
+            bool m_bool;
+            TLukInt m_int;
+            double m_double;
+            LukHeap* p_heap;
+        };
+
         // constructors
-        LukObject();
-        LukObject(bool val); 
-        LukObject(TLukInt val); 
-        LukObject(double val);
+        LukObject() noexcept : m_type(LukType::Nil), m_int(0) {}
+        LukObject(std::nullptr_t) noexcept : m_type(LukType::Nil), m_int(0) {}
+        LukObject(bool val) noexcept : m_type(LukType::Bool), m_int(0) { m_bool = val; }
+        LukObject(TLukInt val) noexcept : m_type(LukType::Int), m_int(val) {}
+        LukObject(double val) noexcept : m_type(LukType::Double), m_double(val) {}
         LukObject(const std::string& val);
+        LukObject(std::string&& val);
         LukObject(const char* val);
-        LukObject(std::shared_ptr<LukCallable> callable);
-        LukObject(std::shared_ptr<LukInstance> instance);
-        LukObject(nullptr_t nulp);
-        
+        LukObject(LukRef<LukCallable> callable);
+        LukObject(LukRef<LukInstance> instance);
+        LukObject(LukRef<LukString> str);
+        LukObject(LukRef<LukList> list);
+        LukObject(LukRef<LukMap> map);
+        LukObject(LukRef<LukArray> array);
+        LukObject(LukRef<LukRange> range);
+
         // copy constructor
-        LukObject(const LukObject& obj);
-        
+        LukObject(const LukObject& obj) noexcept
+            : m_type(obj.m_type), m_int(obj.m_int) {
+            if (isHeap()) p_heap->retain();
+        }
+
         // move constructor
-        LukObject(const LukObject&& obj);
-         
-        // destructor is necessary
+        LukObject(LukObject&& obj) noexcept
+            : m_type(obj.m_type), m_int(obj.m_int) {
+            obj.m_type = LukType::Nil;
+        }
+
         ~LukObject() {
-            logMsg("\n~LukObject destructor,  id: ", id, ", val: ", toString());
+            if (isHeap()) p_heap->release();
+        }
+
+        // copy assignment operator
+        LukObject& operator=(const LukObject& obj) noexcept {
+            // Note: retaining the new heap object before releasing the old one
+            // manage the self assignment
+            if (obj.isHeap()) obj.p_heap->retain();
+            if (isHeap()) p_heap->release();
+            m_type = obj.m_type;
+            m_int = obj.m_int;
+            return *this;
+        }
+
+        // move assignment operator
+        LukObject& operator=(LukObject&& obj) noexcept {
+            if (this == &obj) return *this;
+            if (isHeap()) p_heap->release();
+            m_type = obj.m_type;
+            m_int = obj.m_int;
+            obj.m_type = LukType::Nil;
+            return *this;
+        }
+
+        // Note: stores an int in place, without building a temporary object,
+        // used by the for-in loop to update its counter in the variable slot
+        void setInt(TLukInt val) noexcept {
+            if (isHeap()) p_heap->release();
+            m_type = LukType::Int;
+            m_int = val;
         }
-        
-        // get current object
-        LukObject& getObj() { return *this; }
+
         // get the type id
-        LukType getType() { return m_type; }
+        LukType getType() const { return m_type; }
         /// Note: returns the string representation for object's type
         std::string typeOf() const;
 
-        // get id number
-        size_t getId() { return id; }
-        // get id name
-        std::string getName() { 
-            std::ostringstream oss;
-            oss << this;
-            return oss.str(); 
-        }
-        // clonable
-        std::shared_ptr<LukObject> clone()  { return std::make_shared<LukObject>(*this); }
-
         // convertions
-        bool toBool();
-        TLukInt toInt();
-        double toDouble();
-        std::string toString();
-        std::string value();
-        
-
-        // convert string to number  
+        bool toBool() const;
+        TLukInt toInt() const;
+        double toDouble() const;
+        std::string toString() const;
+        std::string value() const { return toString(); }
+        // Note: appends the string representation to out, without copying a string value
+        void appendTo(std::string& out) const;
+
+
+        // convert string to number
         // Note: template function must be defining in the header file, not in the implementation file.
         // not used, is just as an exercise for template
         // Note: usage:
@@ -114,18 +140,15 @@ namespace luky {
 
             return tValue;
         }
-        
+
 
         /// Note: make dynamic casting to convert base object to derived one.
+        /// returns null reference whether the object is not a callable of type T
         /// Note: template function must be defining in the header file, not in the implementation file.
         template <typename T>
-        std::shared_ptr<T> getDynCast()  {
-          if (p_callable == nullptr) {
-            std::runtime_error err("LukObjectError: cannot casting p_callable when its null");
-            throw err;
-          }
-
-          return std::dynamic_pointer_cast<T>(p_callable);
+        LukRef<T> getDynCast() const {
+          if (!isCallable()) return nullptr;
+          return LukRef<T>(dynamic_cast<T*>(p_heap));
         }
 
         // test type state
@@ -139,162 +162,73 @@ namespace luky {
         bool isString() const { return m_type == LukType::String; }
         bool isCallable() const { return m_type == LukType::Callable; }
         bool isInstance() const { return m_type == LukType::Instance; }
+        bool isList() const { return m_type == LukType::List; }
+        bool isMap() const { return m_type == LukType::Map; }
+        bool isArray() const { return m_type == LukType::Array; }
+        bool isRange() const { return m_type == LukType::Range; }
+        // whether the payload is an heap pointer
+        bool isHeap() const { return m_type >= LukType::String; }
 
         // getters
-        static LukObject getNil() {
-          logMsg("In static getNil");
-            static LukObject obj;
-            return obj;
-        }
-        
-        static ObjPtr getNilPtr()  {
-          logMsg("In static getNilPtr");
-          static ObjPtr nilP = std::make_shared<LukObject>();
-          return nilP;
-        }
-      // Note: static stat_nilPtr is protected for access control
-      // so, we need a static function to get it out of the class
-        static ObjPtr& getStatNilPtr() { return stat_nilPtr; }
-
         bool getBool() const noexcept { return m_bool; }
-        int getInt() const noexcept { return m_int; }
+        TLukInt getInt() const noexcept { return m_int; }
         double getDouble() const noexcept { return m_double; }
         // TODO: should be returned int or double
-        double getNumber() const noexcept { 
-            if (isInt()) return double(m_int); 
+        double getNumber() const noexcept {
+            if (isInt()) return double(m_int);
             return m_double;
         }
 
-        std::string getString() const noexcept { return m_string; }
-        std::shared_ptr<std::string> getPtrString() const noexcept { return p_string; }
-        std::shared_ptr<LukCallable> getCallable() const noexcept { return p_callable; }
-        // std::shared_ptr<LukFunction> getFunc(); 
-        std::shared_ptr<LukInstance> getInstance() const noexcept { return p_instance; }
-        
-
-        // casting to the right type
-        void cast(LukType tp);
-
-        // convertion operators to cast the LukObject type
-        operator bool() const { return _toBool(); }
-        operator int() const { return _toInt(); }
-        operator double() const { return _toDouble(); }
-        operator std::string() const { return _toString(); }
-
-        // assignment operators 
-        // TODO: convert nullptr to shared_ptr lukobject
-        std::shared_ptr<LukObject> operator=(nullptr_t);
-        std::shared_ptr<LukObject> operator=(ObjPtr obj);
-        
-        LukObject& operator=(const bool&& val);
-        LukObject& operator=(const TLukInt&& val);
-        LukObject& operator=(const double&& val);
-        // implement overloaded char* to avoid implicit casting to bool
-        LukObject& operator=(const char* &&val);
-        LukObject& operator=(const std::string&& val);
-        
-        // Note: swap function to avoid duplicate code between copy constructor and copy assignment operator
-        void swap(const LukObject& obj);   
-        // copy assignment operator
-        LukObject& operator=(const LukObject& obj); 
-        // move assignment operator
-        LukObject& operator=(const LukObject&& obj); 
-     
-        // compound assignment operators
-        LukObject& operator+=(const LukObject& obj);
-        LukObject& operator-=(const LukObject& obj);
-        LukObject& operator*=(const LukObject& obj);
-        LukObject& operator/=(const LukObject& obj);
-        LukObject& operator%=(const LukObject& obj);
-
-        // bitwise operators
-        LukObject& operator|=(const LukObject& obj);
-        LukObject& operator&=(const LukObject& obj);
-        LukObject& operator^=(const LukObject& obj);
-        // Note: bitwise NOT operator is friend function
-        LukObject& operator<<=(const LukObject& obj);
-        LukObject& operator>>=(const LukObject& obj);
-
-
-        /*
-            Note: these operators are non member functions
-            therefore there are declared friends
-            Also, for binary operators, object a is passing by copy not by reference
-            so the original object a stay unchanged
-        */
-
-        // Equality operators
-        friend bool operator==(const LukObject& a, const LukObject& b);
-        friend inline bool operator!=(LukObject& a, LukObject& b);
-
-        // Unary operators
-        friend LukObject operator-(LukObject a);
-        friend LukObject operator!(LukObject a);
-        
-        // Binary friend functions
-        friend inline LukObject& operator+(LukObject a, const LukObject& b);
-        friend inline LukObject& operator-(LukObject a, const LukObject& b); 
-        friend inline LukObject& operator*(LukObject a, const LukObject& b); 
-        friend inline LukObject& operator/(LukObject a, const LukObject& b); 
-        friend inline LukObject& operator%(LukObject a, const LukObject& b); 
-
-        // bitwise friend functions
-        friend LukObject& operator|(LukObject a, const LukObject& b);
-        friend LukObject& operator&(LukObject a, const LukObject& b);
-        friend LukObject& operator^(LukObject a, const LukObject& b);
-        friend LukObject operator~(LukObject a);
-        friend LukObject& operator<<(LukObject a, const LukObject& b);
-        friend LukObject& operator>>(LukObject a, const LukObject& b);
-        
-        // comparison friend functions
-        friend bool operator<(const LukObject& a, const LukObject& b);
-        friend inline bool operator<=(const LukObject& a, const LukObject& b);
-        friend inline bool operator>(const LukObject& a, const LukObject& b);
-        friend inline bool operator>=(const LukObject& a, const LukObject& b);
+        // Note: a slice is copied in its own buffer, getView does not copy it
+        const std::string& getString() const;
+        std::string_view getView() const noexcept;
+        LukString* getLukString() const noexcept;
+        LukCallable* getCallable() const noexcept;
+        LukInstance* getInstance() const noexcept;
+        LukList* getList() const noexcept;
+        LukMap* getMap() const noexcept;
+        LukArray* getArray() const noexcept;
+        LukRange* getRange() const noexcept;
 
         // Output friend functions
-        // friend declaration cause ostream accept only one argument 
-        friend inline std::ostream& operator<<(std::ostream& ost, LukObject& obj);
-        friend inline std::ostream& operator<<(std::ostream& ost, ObjPtr& obj);
+        // friend declaration cause ostream accept only one argument
+        friend inline std::ostream& operator<<(std::ostream& ost, const LukObject& obj);
         friend inline std::ostream& operator<<(std::ostream& ost, LukType tp);
-     
+
     private:
-        // methods
-        bool _toBool() const;
-        TLukInt _toInt() const;
-        double _toDouble() const;
-        std::string _toString() const;
         /// Note: deleting trailing zeros
         std::string stripZeros(std::string str) const;
-        
 
     };
+    static_assert(sizeof(LukObject) == 16, "LukObject must stay a 16 bytes value");
+
+    /*
+        Note: operators are non member functions,
+        operands are passed by constant reference and the result is a new value,
+        so operands stay unchanged.
+    */
 
     // Equality operators
-    /// Note: "==" and "<" operators are implemented in the source filefor better readability
-    // equality != operator
     bool operator==(const LukObject& a, const LukObject& b);
-    inline bool operator!=(LukObject& a, LukObject& b) { return !(a == b); }
+    inline bool operator!=(const LukObject& a, const LukObject& b) { return !(a == b); }
 
     // Unary operators
-    LukObject operator-(LukObject a);
-    /// FIXME: The Unary NOT operator, No needing to declare it, dont know why???
-    // LukObject operator!(LukObject a);
- 
-    // binary operators 
-    inline LukObject& operator+(LukObject a, const LukObject & b) { return a += b; }
-    inline LukObject& operator-(LukObject a, const LukObject& b) { return a -= b; }
-    inline LukObject& operator*(LukObject a, const LukObject& b) { return a *= b; }
-    inline LukObject& operator/(LukObject a, const LukObject& b) { return a /= b; }
-    inline LukObject& operator%(LukObject a, const LukObject& b) { return a %= b; }
+    LukObject operator-(const LukObject& a);
+    LukObject operator~(const LukObject& a);
+
+    // binary operators
+    LukObject operator+(const LukObject& a, const LukObject& b);
+    LukObject operator-(const LukObject& a, const LukObject& b);
+    LukObject operator*(const LukObject& a, const LukObject& b);
+    LukObject operator/(const LukObject& a, const LukObject& b);
+    LukObject operator%(const LukObject& a, const LukObject& b);
 
     // bitwise operators
-    inline LukObject& operator|(LukObject a, const LukObject& b) { return a |= b; }
-    inline LukObject& operator&(LukObject a, const LukObject& b) { return a &= b; }
-    inline LukObject& operator^(LukObject a, const LukObject& b) { return a ^= b; }
-    inline LukObject operator~(LukObject a) { return ~a; }
-    inline LukObject& operator<<(LukObject a, const LukObject& b) { return a <<= b; }
-    inline LukObject& operator>>(LukObject a, const LukObject& b) { return a >>= b; }
+    LukObject operator|(const LukObject& a, const LukObject& b);
+    LukObject operator&(const LukObject& a, const LukObject& b);
+    LukObject operator^(const LukObject& a, const LukObject& b);
+    LukObject operator<<(const LukObject& a, const LukObject& b);
+    LukObject operator>>(const LukObject& a, const LukObject& b);
 
     // comparison operators
     bool operator<(const LukObject& a, const LukObject& b);
@@ -308,8 +242,7 @@ namespace luky {
     bool operator>(LukType a, LukType b);
     // outputs operators
     // friends functions definition, because ostream accept only one argument
-    inline std::ostream& operator<<(std::ostream& ost, luky::LukObject& obj) { return ost << obj.toString(); } 
-    inline std::ostream& operator<<(std::ostream& ost, luky::ObjPtr& obj) { return ost << obj->toString(); } 
+    inline std::ostream& operator<<(std::ostream& ost, const luky::LukObject& obj) { return ost << obj.toString(); }
 
     // output << operator for LukType enum
     inline std::ostream& operator<<(std::ostream& ost, luky::LukType tp) {
@@ -324,8 +257,12 @@ namespace luky {
             case Type::String: return ost << "<String>";
             case Type::Callable: return ost << "<Callable>";
             case Type::Instance: return ost << "<Instance>";
+            case Type::List: return ost << "<List>";
+            case Type::Map: return ost << "<Map>";
+            case Type::Array: return ost << "<Array>";
+            case Type::Range: return ost << "<Range>";
         }
-        
+
         return ost << "Invalid Object type";
     }
 
@@ -0,0 +1,30 @@
+#include "lukrange.hpp"
+#include "runtimeerror.hpp"
+
+using namespace luky;
+
+size_t LukRange::size() const noexcept {
+    if (!before(m_start)) return 0;
+    if (m_step > 0) return static_cast<size_t>((m_stop - m_start + m_step -1) / m_step);
+
+    return static_cast<size_t>((m_start - m_stop - m_step -1) / -m_step);
+}
+
+TLukInt LukRange::at(TLukInt index) const {
+    TLukInt size = static_cast<TLukInt>(this->size());
+    if (index < 0) index += size;
+    if (index < 0 || index >= size) throw RuntimeError("Range index out of range.");
+
+    return m_start + index * m_step;
+}
+
+bool LukRange::equals(const LukRange& other) const noexcept {
+    return m_start == other.m_start && m_stop == other.m_stop && m_step == other.m_step;
+}
+
+std::string LukRange::toString() const {
+    std::string result = "range(" + std::to_string(m_start) + ", " + std::to_string(m_stop);
+    if (m_step != 1) result += ", " + std::to_string(m_step);
+
+    return result + ")";
+}
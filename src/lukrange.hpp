@@ -0,0 +1,38 @@
+#ifndef LUKRANGE_HPP
+#define LUKRANGE_HPP
+
+#include "common.hpp"
+#include "lukheap.hpp"
+
+#include <string>
+
+namespace luky {
+    /// Note: lazy range of integers, from start to stop excluded, by step.
+    /// Only its three bounds are stored, the values are computed on demand,
+    /// so a for-in loop over a range never builds the sequence.
+    class LukRange : public LukHeap {
+    public:
+        // Note: the step is not zero, checked by the range() function
+        LukRange(TLukInt start, TLukInt stop, TLukInt step) :
+            m_start(start), m_stop(stop), m_step(step) {}
+
+        TLukInt start() const noexcept { return m_start; }
+        TLukInt stop() const noexcept { return m_stop; }
+        TLukInt step() const noexcept { return m_step; }
+        // whether the value is before the stop, in the direction of the step
+        bool before(TLukInt val) const noexcept { return m_step > 0 ? val < m_stop : val > m_stop; }
+        size_t size() const noexcept;
+        // Note: a negative index counts from the end, throws whether the index is out of range
+        TLukInt at(TLukInt index) const;
+
+        bool equals(const LukRange& other) const noexcept;
+        std::string toString() const;
+
+    private:
+        TLukInt m_start;
+        TLukInt m_stop;
+        TLukInt m_step;
+    };
+}
+
+#endif // LUKRANGE_HPP
@@ -0,0 +1,42 @@
+#include "lukshape.hpp"
+
+using namespace luky;
+
+LukShape* LukShape::root() {
+    // Note: the shapes tree lives until the end of the program,
+    // so instances can keep a raw pointer to their shape.
+    static LukRef<LukShape> s_root = makeRef<LukShape>();
+    return s_root.get();
+}
+
+int LukShape::lookup(Symbol name) const {
+    if (m_size > s_maxLinear) {
+        if (p_slots == nullptr) {
+            p_slots = std::make_unique<std::unordered_map<Symbol, int>>();
+            p_slots->reserve(m_size);
+            for (auto shape = this; shape->p_parent != nullptr; shape = shape->p_parent) {
+                (*p_slots)[shape->m_name] = int(shape->m_size) -1;
+            }
+        }
+        auto iter = p_slots->find(name);
+        return iter != p_slots->end() ? iter->second : -1;
+    }
+
+    for (auto shape = this; shape->p_parent != nullptr; shape = shape->p_parent) {
+        if (shape->m_name == name) return int(shape->m_size) -1;
+    }
+    return -1;
+}
+
+LukShape* LukShape::addField(Symbol name) {
+    auto iter = m_transitions.find(name);
+    if (iter != m_transitions.end()) return iter->second.get();
+
+    auto next = makeRef<LukShape>();
+    next->p_parent = this;
+    next->m_name = name;
+    next->m_size = m_size +1;
+    m_transitions[name] = next;
+
+    return next.get();
+}
@@ -0,0 +1,49 @@
+#ifndef LUKSHAPE_HPP
+#define LUKSHAPE_HPP
+
+#include "lukheap.hpp"
+#include "luksymbol.hpp"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace luky {
+    /// Note: hidden class describing the layout of the fields of an instance.
+    /// Instances which add the same fields in the same order share the same shape,
+    /// so the field names are stored once in the shape, as symbols,
+    /// and each instance stores only its values in a flat vector of slots.
+    /// Adding a field follows the transition to the next shape, created only the first time.
+    /// Note: a shape stores only its last field and a link to its parent,
+    /// so a chain of N fields costs N small shapes instead of N copies of the layout.
+    /// A lookup walks the chain, or a map built lazily for the large shapes.
+    class LukShape : public LukHeap {
+    public:
+        LukShape() {}
+        ~LukShape() {}
+
+        // the empty shape, shared by all new instances
+        static LukShape* root();
+
+        // returns the slot of the field, -1 whether the field is not in this shape
+        int lookup(Symbol name) const;
+
+        LukShape* addField(Symbol name);
+        size_t size() const noexcept { return m_size; }
+
+    private:
+        // Note: above this number of fields, a lookup uses the map instead of walking the chain
+        static constexpr size_t s_maxLinear = 8;
+
+        // Note: the parent owns this shape through its transitions,
+        // so the link back is a raw pointer, without reference cycle.
+        const LukShape* p_parent = nullptr;
+        Symbol m_name = SymbolTable::NoSymbol;
+        // the slot of the last field is always size -1
+        size_t m_size =0;
+        mutable std::unique_ptr<std::unordered_map<Symbol, int>> p_slots = nullptr;
+        std::unordered_map<Symbol, LukRef<LukShape>> m_transitions = {};
+    };
+}
+
+#endif // LUKSHAPE_HPP
@@ -0,0 +1,74 @@
+#include "luksource.hpp"
+
+#include <cerrno>
+#include <fcntl.h> // open
+#include <sys/mman.h> // mmap, munmap
+#include <sys/stat.h> // fstat
+#include <unistd.h> // read, close
+
+using namespace luky;
+
+SourceUnit::~SourceUnit() {
+    if (p_map != nullptr) munmap(p_map, m_mapSize);
+}
+
+SourcePtr SourceUnit::fromString(std::string source) {
+    SourcePtr unit(new SourceUnit());
+    unit->m_buffer = std::move(source);
+    unit->m_source = unit->m_buffer;
+
+    return unit;
+}
+
+SourcePtr SourceUnit::fromFile(const std::string& path) {
+    const bool isStdin = path == "-";
+    const int fd = isStdin ? STDIN_FILENO : open(path.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+
+    struct stat st {};
+    const bool isRegular = fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+    if (isRegular && st.st_size > 0) {
+        const size_t size = static_cast<size_t>(st.st_size);
+        void* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            // Note: the mapping stays valid after closing the file, until the unit is freed,
+            // the scanner reads it once from the start to the end
+            madvise(addr, size, MADV_SEQUENTIAL);
+            if (!isStdin) close(fd);
+            SourcePtr unit(new SourceUnit());
+            unit->p_map = addr;
+            unit->m_mapSize = size;
+            unit->m_source = std::string_view(static_cast<const char*>(addr), size);
+            return unit;
+        }
+    }
+
+    // Note: a pipe, a terminal or an empty file is read in a buffer
+    std::string buffer;
+    if (isRegular) buffer.reserve(static_cast<size_t>(st.st_size));
+    char chunk[65536];
+    ssize_t count;
+    while ((count = read(fd, chunk, sizeof(chunk))) != 0) {
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        buffer.append(chunk, static_cast<size_t>(count));
+    }
+    if (!isStdin) close(fd);
+    if (count < 0) return nullptr;
+
+    return fromString(std::move(buffer));
+}
+
+std::string_view SourceUnit::addString(std::string str) {
+    m_strings.push_back(std::move(str));
+
+    return m_strings.back();
+}
+
+std::vector<Token>& SourceUnit::addTokens(std::vector<Token>&& tokens) {
+    m_tokens.push_back(std::move(tokens));
+
+    return m_tokens.back();
+}
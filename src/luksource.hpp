@@ -0,0 +1,56 @@
+#ifndef LUKSOURCE_HPP
+#define LUKSOURCE_HPP
+
+#include "common.hpp"
+#include "token.hpp"
+
+#include <cstddef> // size_t
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace luky {
+    /// Note: a scanned source, with its materialized literals and its tokens.
+    /// The token lexemes are views into the source buffer, and the AST, the chunks
+    /// and the inline caches point to the tokens, so the unit lives as long as they do:
+    /// the caller keeps it while the source is parsed and run, then only the functions
+    /// parsed from it keep it, so a REPL line is freed once no live function refers to it.
+    /// Each scan adds one contiguous block of tokens,
+    /// instead of an allocation and two string copies per token.
+    /// A script file is mapped in memory and scanned in place, without copy.
+    class SourceUnit {
+    public:
+        ~SourceUnit();
+        SourceUnit(const SourceUnit&) = delete;
+        SourceUnit& operator=(const SourceUnit&) = delete;
+
+        // new unit holding the source
+        static SourcePtr fromString(std::string source);
+        // Note: maps the file read only, or reads it whether it cannot be mapped,
+        // like a pipe or a terminal, the path "-" reads the standard input.
+        // Returns nullptr whether the file cannot be opened or read.
+        static SourcePtr fromFile(const std::string& path);
+
+        // the view never moves while the unit lives
+        std::string_view source() const noexcept { return m_source; }
+        // Note: string of an escaped literal, which is not a view of its source
+        std::string_view addString(std::string str);
+        // returns the stored block, its tokens never move
+        std::vector<Token>& addTokens(std::vector<Token>&& tokens);
+
+    private:
+        SourceUnit() = default;
+
+        std::string m_buffer;
+        std::string_view m_source;
+        // Note: the mapping of a script file, unmapped with the unit
+        void* p_map = nullptr;
+        size_t m_mapSize =0;
+        // Note: a deque never moves its elements, so the views and the pointers stay valid
+        std::deque<std::string> m_strings;
+        std::deque<std::vector<Token>> m_tokens;
+    };
+}
+
+#endif // LUKSOURCE_HPP
@@ -0,0 +1,87 @@
+#ifndef LUKSTRING_HPP
+#define LUKSTRING_HPP
+
+#include "lukheap.hpp"
+
+#include <cstddef> // size_t
+#include <functional> // hash
+#include <string>
+#include <string_view>
+
+namespace luky {
+    /// Note: heap body for string values,
+    /// a LukObject holds only a pointer to it, so passing a string never copies its bytes.
+    /// A string is immutable while it's shared, a string owned by a single value
+    /// can be appended in place, its buffer grows geometrically,
+    /// so building a string by repeated appends is linear.
+    /// A slice is a view onto the bytes of its parent, which it keeps alive,
+    /// it's copied in its own buffer only whether a std::string is requested.
+    /// The hash is computed at the first request, and kept until the string is modified.
+    class LukString : public LukHeap {
+    public:
+        explicit LukString(const std::string& str) : m_string(str) {}
+        explicit LukString(std::string&& str) : m_string(std::move(str)) {}
+        // Note: a slice of a slice is a view onto the first parent
+        LukString(LukRef<LukString> parent, size_t offset, size_t length) : m_length(length) {
+            if (parent->isSlice()) {
+                offset += parent->m_offset;
+                parent = parent->p_parent;
+            }
+            p_parent = std::move(parent);
+            m_offset = offset;
+        }
+
+        std::string_view view() const noexcept {
+            if (p_parent) return std::string_view(p_parent->m_string.data() + m_offset, m_length);
+            return m_string;
+        }
+
+        // Note: a slice copies its bytes, and releases its parent
+        const std::string& str() const {
+            if (p_parent) flatten();
+            return m_string;
+        }
+
+        size_t size() const noexcept { return p_parent ? m_length : m_string.size(); }
+        bool isSlice() const noexcept { return bool(p_parent); }
+
+        size_t hash() const noexcept {
+            if (!m_hashed) {
+                m_hash = std::hash<std::string_view>()(view());
+                m_hashed = true;
+            }
+            return m_hash;
+        }
+
+        // Note: the hashes are compared only whether they are already computed
+        bool equals(const LukString& other) const noexcept {
+            if (this == &other) return true;
+            if (size() != other.size()) return false;
+            if (m_hashed && other.m_hashed && m_hash != other.m_hash) return false;
+            return view() == other.view();
+        }
+
+        // Note: the caller checks that the string has a single owner
+        void append(std::string_view str) {
+            if (p_parent) flatten();
+            m_string.append(str);
+            m_hashed = false;
+        }
+
+    private:
+        void flatten() const {
+            m_string.assign(view());
+            p_parent = nullptr;
+        }
+
+        // Note: the bytes are mutable only to flatten a slice, the value stays the same
+        mutable std::string m_string;
+        mutable LukRef<LukString> p_parent;
+        size_t m_offset =0;
+        size_t m_length =0;
+        mutable size_t m_hash =0;
+        mutable bool m_hashed = false;
+    };
+}
+
+#endif // LUKSTRING_HPP
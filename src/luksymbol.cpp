@@ -0,0 +1,23 @@
+#include "luksymbol.hpp"
+
+#include <cassert>
+
+using namespace luky;
+
+SymbolTable::SymbolTable() {
+    intern("this");
+    intern("super");
+    intern("init");
+    assert(name(This) == "this" && name(Super) == "super" && name(Init) == "init");
+}
+
+Symbol SymbolTable::intern(std::string_view name) {
+    auto iter = m_symbols.find(name);
+    if (iter != m_symbols.end()) return iter->second;
+
+    Symbol sym = static_cast<Symbol>(m_names.size());
+    m_names.emplace_back(name);
+    m_symbols.emplace(m_names.back(), sym);
+
+    return sym;
+}
@@ -0,0 +1,50 @@
+#ifndef LUKSYMBOL_HPP
+#define LUKSYMBOL_HPP
+
+#include <cstdint> // uint32_t
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace luky {
+    // Note: id of an interned name, two names are equal whether their symbols are equal
+    using Symbol = uint32_t;
+
+    /// Note: table of the interned names.
+    /// The scanner interns each identifier once, when it creates its token,
+    /// so variables, fields and methods are keyed by their symbol,
+    /// a lookup hashes and compares an integer instead of a string.
+    /// Symbols are never freed, a name lives until the end of the program.
+    class SymbolTable {
+    public:
+        // Note: predefined symbols, interned first, in this order
+        static constexpr Symbol This =0;
+        static constexpr Symbol Super =1;
+        static constexpr Symbol Init =2;
+        static constexpr Symbol NoSymbol = UINT32_MAX;
+
+        // Note: the table is never destroyed, so tokens freed at exit can still use it
+        static SymbolTable& get() {
+            static SymbolTable* table = new SymbolTable();
+            return *table;
+        }
+
+        // returns the symbol of the name, adding it the first time
+        Symbol intern(std::string_view name);
+        const std::string& name(Symbol sym) const { return m_names.at(sym); }
+        size_t size() const noexcept { return m_names.size(); }
+
+    private:
+        SymbolTable();
+
+        // Note: a deque never moves its strings, so the views used as keys stay valid
+        std::deque<std::string> m_names;
+        std::unordered_map<std::string_view, Symbol> m_symbols;
+    };
+
+    inline Symbol intern(std::string_view name) { return SymbolTable::get().intern(name); }
+    inline const std::string& symbolName(Symbol sym) { return SymbolTable::get().name(sym); }
+}
+
+#endif // LUKSYMBOL_HPP
@@ -0,0 +1,527 @@
+#include "lukvm.hpp"
+#include "interpreter.hpp"
+#include "runtimeerror.hpp"
+#include "lukcallable.hpp"
+#include "lukfunction.hpp"
+#include "lukclass.hpp"
+#include "luklist.hpp"
+#include "lukgc.hpp"
+#include "stmt.hpp"
+
+#include <iostream>
+#include <sstream> // ostringstream
+#include <string>
+#include <unordered_map>
+
+using namespace luky;
+
+// Note: GCC and Clang dispatch the instructions with computed goto,
+// one indirect jump per instruction, which is better predicted than a single switch.
+// Other compilers use the portable switch.
+#if defined(__GNUC__)
+#  define LUK_COMPUTED_GOTO
+// Note: labels as values are a GNU extension, silence the pedantic warnings only here
+#  pragma GCC diagnostic ignored "-Wpedantic"
+#endif
+
+LukVM::LukVM(Interpreter& interp) : m_interp(interp) {
+    LOG_MSG(cat_INTERP, "\nIn LukVM constructor");
+    m_stack.reserve(1024);
+}
+
+LukObject LukVM::run(Chunk& chunk, EnvPtr env) {
+    auto previous = m_env;
+    size_t base = m_stack.size();
+    m_env = env;
+    LukObject result;
+    try {
+        result = execute(chunk);
+    // Note: like executeBlock, must catch all exceptions to restore the environment and the stack
+    } catch(...) {
+        m_stack.resize(base);
+        m_env = previous;
+        throw;
+    }
+    // Note: a return inside a for-in loop leaves the iterable and its position on the stack
+    m_stack.resize(base);
+    m_env = previous;
+
+    return result;
+}
+
+LukObject LukVM::execute(Chunk& chunk) {
+    const uint8_t* ip = chunk.m_code.data();
+    auto& stack = m_stack;
+
+#define READ_BYTE() (*ip++)
+#define READ_SHORT() (ip += 2, uint16_t((ip[-2] << 8) | ip[-1]))
+#define READ_TOKEN() (chunk.m_tokens[READ_SHORT()])
+#define READ_CACHE() (chunk.m_caches[READ_SHORT()])
+#define PEEK(distance) (stack[stack.size() -1 -(distance)])
+
+#ifdef LUK_COMPUTED_GOTO
+    static void* s_dispatch[] = {
+#   define LUK_OPCODE_LABEL(name) &&op_##name,
+        LUK_OPCODES(LUK_OPCODE_LABEL)
+#   undef LUK_OPCODE_LABEL
+    };
+    // Note: a computed goto does not call the destructors of the locals it leaves,
+    // so each instruction keeps its locals in its own block, and dispatches after the block.
+#   define DISPATCH() goto *s_dispatch[READ_BYTE()]
+#   define CASE(name) op_##name:
+    DISPATCH();
+#else
+#   define DISPATCH() goto dispatch
+#   define CASE(name) case OpCode::name:
+dispatch:
+    switch(static_cast<OpCode>(READ_BYTE())) {
+#endif
+
+    CASE(Constant) {
+        stack.push_back(chunk.m_constants[READ_SHORT()]);
+    }
+    DISPATCH();
+    CASE(Nil) { stack.emplace_back(); } DISPATCH();
+    CASE(True) { stack.emplace_back(true); } DISPATCH();
+    CASE(False) { stack.emplace_back(false); } DISPATCH();
+    CASE(Pop) { stack.pop_back(); } DISPATCH();
+    CASE(Dup) { stack.push_back(stack.back()); } DISPATCH();
+    CASE(Swap) {
+        std::swap(PEEK(0), PEEK(1));
+    }
+    DISPATCH();
+
+    CASE(GetLocal) {
+        int depth = READ_BYTE();
+        int slot = READ_SHORT();
+        stack.push_back(m_env->getAt(depth, slot));
+    }
+    DISPATCH();
+    CASE(SetLocal) {
+        int depth = READ_BYTE();
+        int slot = READ_SHORT();
+        // Note: assignment is an expression, the value stays on the stack
+        m_env->assignAt(depth, slot, stack.back());
+    }
+    DISPATCH();
+    CASE(DefineLocal) {
+        m_env->defineSlot(READ_SHORT(), stack.back());
+        stack.pop_back();
+    }
+    DISPATCH();
+    CASE(GetGlobal) {
+        stack.push_back(m_interp.m_globals->get(READ_TOKEN()));
+    }
+    DISPATCH();
+    CASE(SetGlobal) {
+        m_interp.m_globals->assign(READ_TOKEN(), stack.back());
+    }
+    DISPATCH();
+    CASE(CompoundLocal) {
+        int depth = READ_BYTE();
+        int slot = READ_SHORT();
+        auto& tok = READ_TOKEN();
+        LukObject& var = m_env->getAt(depth, slot);
+        m_interp.compoundAssign(var, tok, stack.back());
+        stack.back() = var;
+    }
+    DISPATCH();
+    CASE(CompoundGlobal) {
+        auto& name = READ_TOKEN();
+        auto& tok = READ_TOKEN();
+        LukObject& var = m_interp.m_globals->get(name);
+        m_interp.compoundAssign(var, tok, stack.back());
+        stack.back() = var;
+    }
+    DISPATCH();
+    CASE(DefineGlobal) {
+        m_env->define(READ_TOKEN()->symbol, stack.back());
+        stack.pop_back();
+    }
+    DISPATCH();
+
+    CASE(GetProperty) {
+        auto& name = READ_TOKEN();
+        auto cache = READ_CACHE();
+        stack.back() = m_interp.getProperty(stack.back(), name, cache);
+    }
+    DISPATCH();
+    CASE(SetProperty) {
+        auto& name = READ_TOKEN();
+        auto cache = READ_CACHE();
+        LukObject value = m_interp.setProperty(PEEK(1), name, PEEK(0), cache);
+        stack.pop_back();
+        stack.back() = std::move(value);
+    }
+    DISPATCH();
+    CASE(BuildList) {
+        size_t count = READ_SHORT();
+        std::vector<LukObject> items;
+        items.reserve(count);
+        for (size_t i = stack.size() - count; i < stack.size(); ++i) {
+            items.push_back(std::move(stack[i]));
+        }
+        stack.resize(stack.size() - count);
+        stack.emplace_back(makeRef<LukList>(std::move(items)));
+    }
+    DISPATCH();
+    CASE(BuildMap) {
+        size_t count = READ_SHORT();
+        auto& brace = READ_TOKEN();
+        size_t first = stack.size() - count * 2;
+        LukObject map = m_interp.buildMap(brace, &stack[first], count);
+        stack.resize(first);
+        stack.push_back(std::move(map));
+    }
+    DISPATCH();
+    CASE(GetItem) {
+        LukObject item = m_interp.getItem(PEEK(1), PEEK(0));
+        stack.pop_back();
+        stack.back() = std::move(item);
+    }
+    DISPATCH();
+    CASE(SetItem) {
+        auto& tok = READ_TOKEN();
+        LukObject value = m_interp.setItem(PEEK(2), PEEK(1), tok, PEEK(0));
+        stack.resize(stack.size() -2);
+        stack.back() = std::move(value);
+    }
+    DISPATCH();
+    CASE(Slice) {
+        LukObject list = m_interp.sliceList(PEEK(2), PEEK(1), PEEK(0));
+        stack.resize(stack.size() -2);
+        stack.back() = std::move(list);
+    }
+    DISPATCH();
+    CASE(GetSuper) {
+        int depth = READ_BYTE();
+        int slot = READ_SHORT();
+        int thisDepth = READ_BYTE();
+        auto& name = READ_TOKEN();
+        auto cache = READ_CACHE();
+        stack.push_back(m_interp.superMethod(*m_env, depth, slot, thisDepth, name, cache));
+    }
+    DISPATCH();
+    CASE(GetMethod) {
+        auto& name = READ_TOKEN();
+        auto& paren = READ_TOKEN();
+        auto cache = READ_CACHE();
+        bool isMethod = false;
+        LukObject callee = m_interp.getMethod(stack.back(), name, isMethod, cache);
+        if (!callee.isCallable())
+            throw RuntimeError(paren, "Can only call function and class.");
+        // Note: the object stays above the callee as "this" for a method, otherwise nil
+        LukObject thisObj;
+        if (isMethod) thisObj = std::move(stack.back());
+        stack.back() = std::move(callee);
+        stack.push_back(std::move(thisObj));
+    }
+    DISPATCH();
+
+    // Note: integers and doubles are computed in place,
+    // the other operands fall back to the interpreter operation.
+#define ARITH_OP(name, op) \
+    CASE(name) { \
+        auto& tok = READ_TOKEN(); \
+        LukObject& a = PEEK(1); \
+        const LukObject& b = PEEK(0); \
+        if (a.isInt() && b.isInt()) { \
+            a.m_int = a.m_int op b.m_int; \
+        } else if (a.isDouble() && b.isDouble()) { \
+            a.m_double = a.m_double op b.m_double; \
+        } else { \
+            a = m_interp.binaryOp(tok, a, b); \
+        } \
+        stack.pop_back(); \
+    } \
+    DISPATCH();
+
+#define COMPARE_OP(name, op) \
+    CASE(name) { \
+        auto& tok = READ_TOKEN(); \
+        LukObject& a = PEEK(1); \
+        const LukObject& b = PEEK(0); \
+        if (a.isInt() && b.isInt()) { \
+            a = LukObject(bool(a.m_int op b.m_int)); \
+        } else { \
+            a = m_interp.binaryOp(tok, a, b); \
+        } \
+        stack.pop_back(); \
+    } \
+    DISPATCH();
+
+    ARITH_OP(Add, +)
+    ARITH_OP(Subtract, -)
+    ARITH_OP(Multiply, *)
+    CASE(Divide) {
+        auto& tok = READ_TOKEN();
+        LukObject& a = PEEK(1);
+        const LukObject& b = PEEK(0);
+        if (a.isDouble() && b.isDouble()) a.m_double = a.m_double / b.m_double;
+        else a = m_interp.binaryOp(tok, a, b);
+        stack.pop_back();
+    }
+    DISPATCH();
+    COMPARE_OP(Less, <)
+    COMPARE_OP(LessEqual, <=)
+    COMPARE_OP(Greater, >)
+    COMPARE_OP(GreaterEqual, >=)
+    COMPARE_OP(Equal, ==)
+    COMPARE_OP(NotEqual, !=)
+#undef ARITH_OP
+#undef COMPARE_OP
+
+    CASE(Binary) {
+        auto& tok = READ_TOKEN();
+        LukObject& a = PEEK(1);
+        a = m_interp.binaryOp(tok, a, PEEK(0));
+        stack.pop_back();
+    }
+    DISPATCH();
+    CASE(Unary) {
+        auto& tok = READ_TOKEN();
+        stack.back() = m_interp.unaryOp(tok, stack.back());
+    }
+    DISPATCH();
+    CASE(Not) {
+        stack.back() = LukObject(!m_interp.isTruthy(stack.back()));
+    }
+    DISPATCH();
+
+    CASE(Jump) {
+        uint16_t offset = READ_SHORT();
+        ip += offset;
+    }
+    DISPATCH();
+    CASE(JumpIfFalse) {
+        uint16_t offset = READ_SHORT();
+        if (!m_interp.isTruthy(stack.back())) ip += offset;
+    }
+    DISPATCH();
+    CASE(JumpIfTrue) {
+        uint16_t offset = READ_SHORT();
+        if (m_interp.isTruthy(stack.back())) ip += offset;
+    }
+    DISPATCH();
+    CASE(PopJumpIfFalse) {
+        uint16_t offset = READ_SHORT();
+        const LukObject& cond = stack.back();
+        // Note: bools are tested without calling isTruthy
+        bool truthy = cond.isBool() ? cond.m_bool : m_interp.isTruthy(cond);
+        stack.pop_back();
+        if (!truthy) ip += offset;
+    }
+    DISPATCH();
+    CASE(Loop) {
+        uint16_t offset = READ_SHORT();
+        ip -= offset;
+        // Note: a loop can allocate without calling any function
+        LukGC::get().safePoint();
+    }
+    DISPATCH();
+    CASE(ForPrep) {
+        auto& keyword = READ_TOKEN();
+        stack.emplace_back(m_interp.iterStart(stack.back(), keyword));
+    }
+    DISPATCH();
+    CASE(ForIn) {
+        int slot = READ_SHORT();
+        uint16_t offset = READ_SHORT();
+        // Note: the position is an unboxed int, updated in place on the stack
+        if (!m_interp.iterNext(PEEK(1), PEEK(0).m_int, m_env->getAt(0, slot))) ip += offset;
+    }
+    DISPATCH();
+
+    CASE(CheckCallable) {
+        auto& paren = READ_TOKEN();
+        if (!stack.back().isCallable())
+            throw RuntimeError(paren, "Can only call function and class.");
+    }
+    DISPATCH();
+    CASE(Call) {
+        size_t argCount = READ_BYTE();
+        auto& paren = READ_TOKEN();
+        LukObject result = callValue(PEEK(argCount), argCount, paren, nullptr);
+        stack.resize(stack.size() - argCount);
+        stack.back() = std::move(result);
+    }
+    DISPATCH();
+    CASE(CallKeywords) {
+        size_t argCount = READ_BYTE();
+        auto& paren = READ_TOKEN();
+        auto& keywords = chunk.m_keywords[READ_SHORT()];
+        size_t count = argCount + keywords.m_names.size();
+        LukObject result = callValue(PEEK(count), argCount, paren, &keywords);
+        stack.resize(stack.size() - count);
+        stack.back() = std::move(result);
+    }
+    DISPATCH();
+
+    CASE(Invoke) {
+        size_t argCount = READ_BYTE();
+        LukObject callee = PEEK(argCount +1);
+        LukObject thisObj = PEEK(argCount);
+        VArguments v_args(stack.end() - argCount, stack.end());
+        m_interp.checkArity(callee, argCount);
+        LukObject result = thisObj.isNil() ?
+            callee.getCallable()->call(m_interp, v_args) :
+            static_cast<LukFunction*>(callee.getCallable())->callWith(m_interp, thisObj, v_args);
+        stack.resize(stack.size() - argCount -1);
+        stack.back() = std::move(result);
+    }
+    DISPATCH();
+
+    CASE(Closure) {
+        auto& proto = chunk.m_functions[READ_SHORT()];
+        auto func = makeRef<LukFunction>(proto.m_name, proto.m_declaration, m_env, false);
+        stack.emplace_back(LukRef<LukCallable>(func));
+    }
+    DISPATCH();
+    CASE(Inherit) {
+        auto stmt = chunk.m_classes[READ_SHORT()];
+        // TODO: It will better to test whether superclass is classable instead callable
+        if (!stack.back().isCallable())
+            throw RuntimeError(stmt->m_superclass->m_name, "Superclass must be a class.");
+    }
+    DISPATCH();
+    CASE(Class) {
+        auto stmt = chunk.m_classes[READ_SHORT()];
+        LukObject klass = makeClass(chunk, *stmt);
+        stack.push_back(std::move(klass));
+    }
+    DISPATCH();
+
+    CASE(Interpolate) {
+        size_t count = READ_SHORT();
+        std::string msg;
+        for (size_t i = stack.size() - count; i < stack.size(); ++i) {
+            stack[i].appendTo(msg);
+        }
+        stack.resize(stack.size() - count);
+        stack.emplace_back(std::move(msg));
+    }
+    DISPATCH();
+    CASE(Print) {
+        size_t count = READ_SHORT();
+        std::string msg;
+        for (size_t i = stack.size() - count; i < stack.size(); ++i) {
+            stack[i].appendTo(msg);
+        }
+        stack.resize(stack.size() - count);
+        // Note: an empty message is printed with its quotes, like an empty string value
+        if (msg.empty()) msg = "''";
+        std::cout << msg << std::endl;
+        m_interp.m_result = LukObject();
+    }
+    DISPATCH();
+    CASE(ExprResult) {
+        m_interp.m_result = std::move(stack.back());
+        stack.pop_back();
+    }
+    DISPATCH();
+
+    CASE(PushEnv) {
+        m_env = std::make_shared<Environment>(m_env);
+    }
+    DISPATCH();
+    CASE(PopEnv) {
+        m_env = m_env->m_enclosing;
+    }
+    DISPATCH();
+    CASE(EndBlock) {
+        m_env = m_env->m_enclosing;
+        // reset the last result, like executeBlock
+        m_interp.m_result = LukObject();
+    }
+    DISPATCH();
+
+    CASE(Error) {
+        auto& tok = READ_TOKEN();
+        auto& msg = chunk.m_constants[READ_SHORT()];
+        throw RuntimeError(tok, msg.getString());
+    }
+
+    CASE(Return) {
+        LukObject result = std::move(stack.back());
+        stack.pop_back();
+        // Note: leaving a function body resets the last result, like executeBlock
+        m_interp.m_result = LukObject();
+        return result;
+    }
+    CASE(Halt) {
+        return LukObject();
+    }
+
+#ifndef LUK_COMPUTED_GOTO
+    }
+    // unreachable
+    return LukObject();
+#endif
+
+#undef READ_BYTE
+#undef READ_SHORT
+#undef READ_TOKEN
+#undef READ_CACHE
+#undef PEEK
+#undef DISPATCH
+#undef CASE
+}
+
+/// Note: the arguments are on the stack, above the callee, followed by the keywords values.
+LukObject LukVM::callValue(const LukObject& callee, size_t argCount, TokPtr& paren,
+        KeywordsProto* keywords) {
+    if (!callee.isCallable())
+        throw RuntimeError(paren, "Can only call function and class.");
+    size_t count = argCount + (keywords ? keywords->m_names.size() : 0);
+    auto first = m_stack.end() - count;
+    VArguments v_args(first, first + argCount);
+    // Note: the callee stays on the stack during the call
+    LukCallable* func = callee.getCallable();
+    m_interp.checkArity(callee, v_args.size());
+    if (keywords != nullptr) {
+        if (func->getKeywords().empty())
+            throw RuntimeError(paren, "No default keyword for this function.");
+        for (size_t i=0; i < keywords->m_names.size(); ++i) {
+            m_interp.setKeyword(func, keywords->m_names[i], *(first + argCount + i));
+        }
+    }
+
+    return func->call(m_interp, v_args);
+}
+
+/// Note: builds the class like Interpreter::visitClassStmt,
+/// the static variables values are on the stack, and the superclass is in the current environment.
+LukObject LukVM::makeClass(Chunk& /*chunk*/, ClassStmt& stmt) {
+    LukRef<LukClass> supKlass = nullptr;
+    if (stmt.m_superclass != nullptr) {
+        supKlass = m_env->getAt(0, 0).getDynCast<LukClass>();
+    }
+
+    std::unordered_map<Symbol, LukObject> methods;
+    size_t first = m_stack.size() - stmt.m_vars.size();
+    for (size_t i=0; i < stmt.m_vars.size(); ++i) {
+        methods[stmt.m_vars[i].first->symbol] = m_stack[first + i];
+    }
+    m_stack.resize(first);
+
+    std::unordered_map<Symbol, LukObject> classMethods;
+    for (auto& meth: stmt.m_classMethods) {
+        auto func = makeRef<LukFunction>(std::string(meth->m_name->lexeme),
+            meth->m_function, m_env, false);
+        classMethods[meth->m_name->symbol] = LukObject(LukRef<LukCallable>(func));
+    }
+    auto metaKlass = makeRef<LukClass>(nullptr,
+        std::string(stmt.m_name->lexeme) + " metaclass",
+        nullptr, classMethods);
+
+    for (auto& meth: stmt.m_methods) {
+        auto func = makeRef<LukFunction>(std::string(meth->m_name->lexeme),
+            meth->m_function, m_env,
+            meth->m_name->symbol == SymbolTable::Init);
+        methods[meth->m_name->symbol] = LukObject(LukRef<LukCallable>(func));
+    }
+    auto klass = makeRef<LukClass>(metaKlass, std::string(stmt.m_name->lexeme),
+        supKlass, methods);
+
+    return LukObject(LukRef<LukCallable>(klass));
+}
@@ -0,0 +1,41 @@
+#ifndef LUKVM_HPP
+#define LUKVM_HPP
+
+#include "common.hpp"
+#include "chunk.hpp"
+#include "lukobject.hpp"
+#include "environment.hpp"
+#include "logger.hpp"
+
+#include <vector>
+
+namespace luky {
+    class Interpreter;
+
+    /// Note: stack based virtual machine, running the chunks emitted by the compiler.
+    /// The VM shares the environments, the callables and the operations of the interpreter,
+    /// so functions compiled to bytecode and builtin functions can call each other.
+    /// Each function call re-enters run() with the function's environment.
+    class LukVM {
+    public:
+        explicit LukVM(Interpreter& interp);
+        ~LukVM() {
+          LOG_MSG(cat_INTERP, "\n~LukVM destructor");
+        }
+
+        LukObject run(Chunk& chunk, EnvPtr env);
+
+    private:
+        Interpreter& m_interp;
+        std::vector<LukObject> m_stack;
+        // current environment
+        EnvPtr m_env;
+
+        LukObject execute(Chunk& chunk);
+        LukObject makeClass(Chunk& chunk, ClassStmt& stmt);
+        LukObject callValue(const LukObject& callee, size_t argCount, TokPtr& paren,
+                KeywordsProto* keywords);
+    };
+}
+
+#endif // LUKVM_HPP
@@ -2,10 +2,14 @@
 #include "lukerror.hpp"
 #include "scanner.hpp"
 #include "parser.hpp"
+#include "optimizer.hpp"
 #include "resolver.hpp"
 #include "interpreter.hpp"
+#include "lukgc.hpp"
+#include "luksource.hpp"
+#include "allocstats.hpp"
+#include "simd.hpp"
 
-#include <fstream> // for file
 #include <iostream> // for IO buffer
 #include <sstream> // for string buffer
 
@@ -39,10 +43,10 @@ namespace luky {
 
     }
     */
-    bool hasOnlySpaces(const std::string& str) {
+    bool hasOnlySpaces(std::string_view str) {
         // ignore spaces, tabs, newlines,
         // vertical tabs, feeds and carriage returns
-        return str.find_first_not_of(" \t\n\v\f\r") == std::string::npos;
+        return str.find_first_not_of(" \t\n\v\f\r") == std::string_view::npos;
     }
 
     std::vector<std::string> split(const std::string& str, char delim) {
@@ -57,22 +61,39 @@ namespace luky {
         return v_elems;
     }
 
-    static void run(const std::string& source) {
+    // run statements with the bytecode VM, instead of walking the tree
+    bool m_vmMode = false;
+    // print the hit rate of the inline caches after running
+    bool m_cacheStats = false;
+    // print the statistics of the cycle collector at exit
+    bool m_gcStats = false;
+    // print the number of allocations at exit, used by the benchmark runner
+    bool m_allocStats = false;
+    // optimization level of the AST, 0 to run the statements as parsed
+    int m_optLevel =1;
+
+    // Note: the tokens are views into the unit, freed after the run
+    // whether no function declared by the source is still alive
+    static void run(SourcePtr unit) {
+        const std::string_view source = unit->source();
         if (source.empty() || hasOnlySpaces(source)) return;
 
         // scanner
-        Scanner scanner(source, m_lukErr);
-        const std::vector<TokPtr>&& v_tokens = scanner.scanTokens();
+        Scanner scanner(*unit, m_lukErr);
+        auto v_tokens = scanner.scanTokens();
         if (m_lukErr.hadError) return;
         // printer
         // printer(tokens);
         // /*
         // parser
-        Parser parser(std::move(v_tokens), m_lukErr);
+        Parser parser(std::move(v_tokens), unit, m_lukErr);
         auto stmts = parser.parse();
         // if found error during parsing, report
         if (m_lukErr.hadError)  return;
         static Interpreter  interp(m_lukErr);
+        interp.setVMMode(m_vmMode);
+        Optimizer optim(interp, m_lukErr, m_optLevel);
+        optim.optimize(stmts);
         Resolver resol(interp, m_lukErr);
         resol.resolve((stmts));
         
@@ -80,27 +101,25 @@ namespace luky {
         if (m_lukErr.hadError) return;
         
         // Interpreter
-        interp.interpret(std::move(stmts));
-        // interp.interpret((stmts));
+        // Note: statements are kept alive until the inline caches statistics are printed
+        interp.interpret(stmts);
+        if (m_cacheStats) InlineCache::printStats(std::cerr);
 
 
         std::cout << std::endl;
 
     }
 
+    // Note: the file is mapped in memory and scanned in place, the path "-" reads the standard input
     static void runFile(const std::string& path) {
-      // TODO: use filesystem library in C++17 to check whether file exists
-        std::ifstream file(path);
-        if (!file.is_open()) {
+        SourcePtr unit = SourceUnit::fromFile(path);
+        if (!unit) {
           const std::string msg = "cannot open file " + path;
           m_lukErr.error(m_errTitle, msg);
           return;
         }
 
-        std::ostringstream stream;
-        stream << file.rdbuf();
-        file.close();
-        run(stream.str());
+        run(std::move(unit));
     }
 
     static void runPrompt() {
@@ -126,14 +145,14 @@ namespace luky {
               continue;
             }
 
-            run(line);
+            run(SourceUnit::fromString(line));
             m_lukErr.hadError = false;
         }
 
     }
 
     static void runCommand(const std::string& line) {
-        run(line);
+        run(SourceUnit::fromString(line));
         m_lukErr.hadError = false;
 
     }
@@ -160,14 +179,45 @@ namespace luky {
 int main(int argc, char* argv[]) {
     // test();
     // LukError lukErr;
+    // Note: --vm, --cache-stats, --gc-stats, --alloc-stats, --no-simd, --log=, -O0 and -O1 options must be the first, and are combinable with other options
+    while (argc >1) {
+        const std::string opt = std::string(argv[1]);
+        if (opt == "--vm") luky::m_vmMode = true;
+        else if (opt == "--cache-stats") luky::m_cacheStats = true;
+        else if (opt == "--gc-stats") luky::m_gcStats = true;
+        else if (opt == "--alloc-stats") luky::m_allocStats = true;
+        else if (opt == "--no-simd") luky::simd::disable();
+        else if (opt.rfind("--log=", 0) == 0) {
+            if (!setLogCategories(opt.substr(6))) {
+                cerr << "Unknown log category in: " << opt << "\n";
+                return 1;
+            }
+        }
+        else if (opt == "-O0") luky::m_optLevel =0;
+        else if (opt == "-O1") luky::m_optLevel =1;
+        else break;
+        argv[1] = argv[0];
+        argc--;
+        argv++;
+    }
     if (argc >2) {
         const std::string opt = std::string(argv[1]);
         if (opt == "-c") {
             const std::string line = argv[2];
             luky::runCommand(line);
         } else {
-            cout << "Usage: luky [filename]\n" 
-              << "-c: line" << endl;
+            cout << "Usage: luky [--vm] [--cache-stats] [--gc-stats] [--alloc-stats] [--no-simd] [--log=categories] [-O0|-O1] [filename]\n" 
+              << "-c: line\n"
+              << "filename: script to run, - reads it from the standard input\n"
+              << "--vm: run with the bytecode VM\n"
+              << "--cache-stats: print the hit rate of the inline caches\n"
+              << "--gc-stats: print the statistics of the cycle collector\n"
+              << "--alloc-stats: print the number of allocations, counted by the luky_stats build only\n"
+              << "--no-simd: run the array functions and the scanner with the scalar kernels\n"
+              << "--log=categories: print the debug messages of the categories separated by commas,\n"
+              << "    scanner, parser, resolver, interp, env, object or all, in a debug build only\n"
+              << "-O0: run the statements as parsed\n"
+              << "-O1: fold the constant expressions before running (default)" << endl;
         }
     } else if (argc == 2) {
         cout << "Run file " << argv[1] << endl;
@@ -175,6 +225,8 @@ int main(int argc, char* argv[]) {
     } else {
       luky::runPrompt();
     }
+    if (luky::m_gcStats) luky::LukGC::get().printStats(std::cerr);
+    if (luky::m_allocStats) luky::AllocStats::printStats(std::cerr);
 
     return 0;
 }
@@ -0,0 +1,701 @@
+#include "optimizer.hpp"
+#include "interpreter.hpp"
+#include "runtimeerror.hpp"
+
+#include <sstream>
+
+using namespace luky;
+
+/// Note: collects the names of the variables assigned, or incremented, in the script,
+/// before the optimizer propagates the others.
+class Optimizer::AssignedNames : public ExprVisitor,  public StmtVisitor {
+public:
+    explicit AssignedNames(std::unordered_set<Symbol>& names) : m_names(names) {}
+
+    void collect(std::vector<StmtPtr>& statements) {
+        for (auto& stmt: statements) {
+            if (stmt) stmt->accept(*this);
+        }
+    }
+
+    void collect(const ExprPtr& expr) {
+        if (expr) expr->accept(*this);
+    }
+
+    void collect(const StmtPtr& stmt) {
+        if (stmt) stmt->accept(*this);
+    }
+
+    // expressions
+    LukObject visitAssignExpr(AssignExpr& expr) override {
+        m_names.insert(expr.m_name->symbol);
+        collect(expr.m_value);
+        return LukObject();
+    }
+
+    LukObject visitBinaryExpr(BinaryExpr& expr) override {
+        collect(expr.m_left);
+        collect(expr.m_right);
+        return LukObject();
+    }
+
+    LukObject visitCallExpr(CallExpr& expr) override {
+        collect(expr.m_callee);
+        for (auto& arg: expr.m_args) collect(arg);
+        for (auto& iter: expr.m_keywords) collect(iter.second);
+        return LukObject();
+    }
+
+    LukObject visitFunctionExpr(FunctionExpr& expr) override {
+        collect(expr.m_body);
+        return LukObject();
+    }
+
+    LukObject visitGetExpr(GetExpr& expr) override {
+        collect(expr.m_object);
+        return LukObject();
+    }
+
+    LukObject visitGroupingExpr(GroupingExpr& expr) override {
+        collect(expr.m_expression);
+        return LukObject();
+    }
+
+    LukObject visitIndexExpr(IndexExpr& expr) override {
+        collect(expr.m_object);
+        collect(expr.m_index);
+        collect(expr.m_end);
+        return LukObject();
+    }
+
+    LukObject visitInterpolateExpr(InterpolateExpr& expr) override {
+        for (auto& arg: expr.m_args) collect(arg);
+        return LukObject();
+    }
+
+    LukObject visitListExpr(ListExpr& expr) override {
+        for (auto& item: expr.m_items) collect(item);
+        return LukObject();
+    }
+
+    LukObject visitInvokeExpr(InvokeExpr& expr) override {
+        collect(expr.m_object);
+        for (auto& arg: expr.m_args) collect(arg);
+        for (auto& iter: expr.m_keywords) collect(iter.second);
+        return LukObject();
+    }
+
+    LukObject visitLiteralExpr(LiteralExpr&) override { return LukObject(); }
+
+    LukObject visitLogicalExpr(LogicalExpr& expr) override {
+        collect(expr.m_left);
+        collect(expr.m_right);
+        return LukObject();
+    }
+
+    LukObject visitMapExpr(MapExpr& expr) override {
+        for (auto& entry: expr.m_entries) {
+            collect(entry.first);
+            collect(entry.second);
+        }
+        return LukObject();
+    }
+
+    LukObject visitSetExpr(SetExpr& expr) override {
+        collect(expr.m_object);
+        collect(expr.m_value);
+        return LukObject();
+    }
+
+    LukObject visitSetIndexExpr(SetIndexExpr& expr) override {
+        collect(expr.m_object);
+        collect(expr.m_index);
+        collect(expr.m_value);
+        return LukObject();
+    }
+
+    LukObject visitSuperExpr(SuperExpr&) override { return LukObject(); }
+
+    LukObject visitTernaryExpr(TernaryExpr& expr) override {
+        collect(expr.m_condition);
+        collect(expr.m_thenBranch);
+        collect(expr.m_elseBranch);
+        return LukObject();
+    }
+
+    LukObject visitThisExpr(ThisExpr&) override { return LukObject(); }
+
+    LukObject visitUnaryExpr(UnaryExpr& expr) override {
+        if ((expr.m_op->type == TokenType::PLUS_PLUS || expr.m_op->type == TokenType::MINUS_MINUS)
+                && expr.m_right->isVariableExpr()) {
+            m_names.insert(expr.m_right->getName()->symbol);
+        }
+        collect(expr.m_right);
+        return LukObject();
+    }
+
+    LukObject visitVariableExpr(VariableExpr&) override { return LukObject(); }
+
+    // statements
+    void visitBlockStmt(BlockStmt& stmt) override { collect(stmt.m_statements); }
+    void visitBreakStmt(BreakStmt&) override {}
+
+    void visitClassStmt(ClassStmt& stmt) override {
+        for (auto& it: stmt.m_vars) collect(it.second);
+        for (auto& meth: stmt.m_methods) collect(meth->m_function->m_body);
+        for (auto& meth: stmt.m_classMethods) collect(meth->m_function->m_body);
+    }
+
+    void visitExpressionStmt(ExpressionStmt& stmt) override { collect(stmt.m_expression); }
+
+    void visitForInStmt(ForInStmt& stmt) override {
+        collect(stmt.m_iterable);
+        collect(stmt.m_body);
+    }
+    void visitFunctionStmt(FunctionStmt& stmt) override { collect(stmt.m_function->m_body); }
+
+    void visitIfStmt(IfStmt& stmt) override {
+        collect(stmt.m_condition);
+        collect(stmt.m_thenBranch);
+        collect(stmt.m_elseBranch);
+    }
+
+    void visitPrintStmt(PrintStmt& stmt) override {
+        for (auto& arg: stmt.m_args) collect(arg);
+    }
+
+    void visitReturnStmt(ReturnStmt& stmt) override { collect(stmt.m_value); }
+
+    void visitVarStmt(VarStmt& stmt) override {
+        for (auto& it: stmt.m_vars) collect(it.second);
+    }
+
+    void visitWhileStmt(WhileStmt& stmt) override {
+        collect(stmt.m_condition);
+        collect(stmt.m_body);
+    }
+
+private:
+    std::unordered_set<Symbol>& m_names;
+};
+
+Optimizer::Optimizer(Interpreter& interp, LukError& lukErr, int level) :
+    m_interp(interp),
+    m_lukErr(lukErr),
+    m_level(level) {
+    LOG_MSG(cat_RESOLVER, "\nIn Optimizer constructor, level: ", level);
+}
+
+void Optimizer::optimize(std::vector<StmtPtr>& statements) {
+    if (m_level <= 0) return;
+    m_assigned.clear();
+    AssignedNames names(m_assigned);
+    names.collect(statements);
+
+    // Note: global variables are never propagated, they can be assigned from everywhere
+    m_scopes.clear();
+    m_folded =0;
+    auto results = optimizeStatements(statements);
+    pruneStatements(statements, results);
+    m_emptyDecls.clear();
+    LOG_MSG(cat_RESOLVER, "\nOptimizer optimize, folded: ", m_folded);
+}
+
+ExprPtr Optimizer::optimize(ExprPtr expr) {
+    if (expr == nullptr) return expr;
+    m_exprResult = nullptr;
+    expr->accept(*this);
+    ExprPtr result = m_exprResult ? m_exprResult : expr;
+    m_exprResult = nullptr;
+
+    return result;
+}
+
+StmtPtr Optimizer::optimize(StmtPtr stmt) {
+    if (stmt == nullptr) return stmt;
+    m_stmtResult = nullptr;
+    m_removeStmt = false;
+    stmt->accept(*this);
+    StmtPtr result = m_removeStmt ? nullptr : (m_stmtResult ? m_stmtResult : stmt);
+    m_stmtResult = nullptr;
+    m_removeStmt = false;
+
+    return result;
+}
+
+StmtPtr Optimizer::optimizeSlot(StmtPtr stmt) {
+    // Note: a statement removed from a branch or a loop body is kept in place,
+    // it has been optimized, and it's never executed.
+    auto result = optimize(stmt);
+    return result ? result : stmt;
+}
+
+std::vector<StmtPtr> Optimizer::optimizeStatements(std::vector<StmtPtr>& statements) {
+    std::vector<StmtPtr> results;
+    results.reserve(statements.size());
+    for (auto& stmt: statements) {
+        results.push_back(optimize(stmt));
+    }
+
+    return results;
+}
+
+void Optimizer::pruneStatements(std::vector<StmtPtr>& statements, std::vector<StmtPtr>& results) {
+    std::vector<StmtPtr> kept;
+    StmtPtr lastDead = nullptr;
+    for (size_t i=0; i < results.size(); ++i) {
+        if (results[i] == nullptr) {
+            lastDead = statements[i];
+        } else if (m_emptyDecls.count(results[i].get()) == 0) {
+            kept.push_back(results[i]);
+        }
+    }
+    // Note: the resolver rejects an empty list of statements,
+    // so the last dead statement is kept, it's never executed.
+    if (kept.empty()) {
+        if (lastDead) kept.push_back(lastDead);
+        else if (!statements.empty()) kept.push_back(statements.back());
+    }
+    statements = std::move(kept);
+}
+
+void Optimizer::optimizeFunction(FunctionExpr& func) {
+    beginScope();
+    for (auto& param: func.m_params) {
+        declareShadow(param);
+    }
+    auto results = optimizeStatements(func.m_body);
+    endScope();
+    pruneStatements(func.m_body, results);
+}
+
+void Optimizer::beginScope() {
+    m_scopes.emplace_back();
+}
+
+void Optimizer::endScope() {
+    // Note: a declaration is dropped only whether all its reads have been replaced,
+    // otherwise the resolver would report a variable not used, or not declared.
+    for (auto& iter: m_scopes.back()) {
+        auto& local = iter.second;
+        if (!local.m_isConst || local.m_replaced == 0 || local.m_kept > 0) continue;
+        auto& vars = local.p_decl->m_vars;
+        for (auto it = vars.begin(); it != vars.end(); ++it) {
+            if (it->first == local.m_name) {
+                vars.erase(it);
+                break;
+            }
+        }
+        if (vars.empty()) m_emptyDecls.insert(local.p_decl);
+    }
+    m_scopes.pop_back();
+}
+
+void Optimizer::declareShadow(const TokPtr& name) {
+    if (m_scopes.empty()) return;
+    auto& scope = m_scopes.back();
+    auto iter = scope.find(name->symbol);
+    if (iter != scope.end()) {
+        // Note: redeclaration reported by the resolver, the first declaration is kept
+        iter->second.m_isConst = false;
+        iter->second.m_kept++;
+        return;
+    }
+    Local local;
+    local.m_name = name;
+    scope[name->symbol] = std::move(local);
+}
+
+bool Optimizer::isLiteral(const ExprPtr& expr, LukObject& value) {
+    if (expr == nullptr || !expr->isLiteralExpr()) return false;
+    value = std::static_pointer_cast<LiteralExpr>(expr)->m_value;
+
+    return true;
+}
+
+ExprPtr Optimizer::makeLiteral(const LukObject& value) {
+    ++m_folded;
+    return std::make_shared<LiteralExpr>(value);
+}
+
+bool Optimizer::isFoldable(const LukObject& value) const {
+    if (value.isNil() || value.isBool() || value.isNumber()) return true;
+    if (value.isString()) return value.getView().size() <= MaxFoldedString;
+
+    return false;
+}
+
+// expressions
+LukObject Optimizer::visitAssignExpr(AssignExpr& expr) {
+    ++m_unprunable;
+    expr.m_value = optimize(expr.m_value);
+
+    return LukObject();
+}
+
+LukObject Optimizer::visitBinaryExpr(BinaryExpr& expr) {
+    expr.m_left = optimize(expr.m_left);
+    expr.m_right = optimize(expr.m_right);
+    LukObject left, right;
+    if (!isLiteral(expr.m_left, left)) return LukObject();
+
+    // comma operator, the literal on the left has no effect
+    if (expr.m_op->type == TokenType::COMMA) {
+        m_exprResult = expr.m_right;
+        return LukObject();
+    }
+    if (!isLiteral(expr.m_right, right)) return LukObject();
+
+    switch(expr.m_op->type) {
+        case TokenType::PLUS:
+        case TokenType::MINUS:
+        case TokenType::STAR:
+        case TokenType::SLASH:
+        case TokenType::MOD:
+        case TokenType::EXP:
+        case TokenType::GREATER:
+        case TokenType::GREATER_EQUAL:
+        case TokenType::LESSER:
+        case TokenType::LESSER_EQUAL:
+        case TokenType::BANG_EQUAL:
+        case TokenType::EQUAL_EQUAL:
+        case TokenType::BIT_OR:
+        case TokenType::BIT_AND:
+        case TokenType::BIT_XOR:
+        case TokenType::BIT_LEFT:
+        case TokenType::BIT_RIGHT:
+            break;
+        default: return LukObject();
+    }
+
+    // Note: the error of an invalid operation is reported at runtime, whether it's reached
+    try {
+        auto value = m_interp.binaryOp(expr.m_op, left, right);
+        if (isFoldable(value)) m_exprResult = makeLiteral(value);
+    } catch (RuntimeError&) {
+        LOG_MSG(cat_RESOLVER, "\nOptimizer, not folded: ", expr.m_op->lexeme);
+    }
+
+    return LukObject();
+}
+
+LukObject Optimizer::visitCallExpr(CallExpr& expr) {
+    expr.m_callee = optimize(expr.m_callee);
+    for (auto& arg: expr.m_args) {
+        arg = optimize(arg);
+    }
+    for (auto& iter: expr.m_keywords) {
+        iter.second = optimize(iter.second);
+    }
+
+    return LukObject();
+}
+
+LukObject Optimizer::visitFunctionExpr(FunctionExpr& expr) {
+    ++m_unprunable;
+    optimizeFunction(expr);
+
+    return LukObject();
+}
+
+LukObject Optimizer::visitGetExpr(GetExpr& expr) {
+    expr.m_object = optimize(expr.m_object);
+
+    return LukObject();
+}
+
+LukObject Optimizer::visitGroupingExpr(GroupingExpr& expr) {
+    expr.m_expression = optimize(expr.m_expression);
+    // Note: only a literal is unwrapped, an operand grouped is not a variable for the operators ++ and --
+    if (expr.m_expression->isLiteralExpr()) m_exprResult = expr.m_expression;
+
+    return LukObject();
+}
+
+LukObject Optimizer::visitIndexExpr(IndexExpr& expr) {
+    expr.m_object = optimize(expr.m_object);
+    // Note: the omitted bounds of a slice stay nullptr
+    expr.m_index = optimize(expr.m_index);
+    expr.m_end = optimize(expr.m_end);
+
+    return LukObject();
+}
+
+LukObject Optimizer::visitInterpolateExpr(InterpolateExpr& expr) {
+    std::ostringstream msg;
+    bool isConst = true;
+    for (auto& arg: expr.m_args) {
+        arg = optimize(arg);
+        LukObject value;
+        if (isConst && isLiteral(arg, value)) msg << value.toString();
+        else isConst = false;
+    }
+    if (isConst) {
+        LukObject value(msg.str());
+        if (isFoldable(value)) m_exprResult = makeLiteral(value);
+    }
+
+    return LukObject();
+}
+
+LukObject Optimizer::visitInvokeExpr(InvokeExpr& expr) {
+    expr.m_object = optimize(expr.m_object);
+    for (auto& arg: expr.m_args) {
+        arg = optimize(arg);
+    }
+    for (auto& iter: expr.m_keywords) {
+        iter.second = optimize(iter.second);
+    }
+
+    return LukObject();
+}
+
+LukObject Optimizer::visitListExpr(ListExpr& expr) {
+    for (auto& item: expr.m_items) item = optimize(item);
+
+    return LukObject();
+}
+
+LukObject Optimizer::visitLiteralExpr(LiteralExpr&) {
+    return LukObject();
+}
+
+LukObject Optimizer::visitLogicalExpr(LogicalExpr& expr) {
+    expr.m_left = optimize(expr.m_left);
+    size_t unprunable = m_unprunable;
+    expr.m_right = optimize(expr.m_right);
+    LukObject left;
+    if (!isLiteral(expr.m_left, left)) return LukObject();
+
+    bool isTruthy = m_interp.isTruthy(left);
+    bool shortCircuit = expr.m_op->type == TokenType::OR ? isTruthy : !isTruthy;
+    if (!shortCircuit) m_exprResult = expr.m_right;
+    else if (m_unprunable == unprunable) m_exprResult = expr.m_left;
+
+    return LukObject();
+}
+
+LukObject Optimizer::visitMapExpr(MapExpr& expr) {
+    for (auto& entry: expr.m_entries) {
+        entry.first = optimize(entry.first);
+        entry.second = optimize(entry.second);
+    }
+
+    return LukObject();
+}
+
+LukObject Optimizer::visitSetExpr(SetExpr& expr) {
+    expr.m_object = optimize(expr.m_object);
+    expr.m_value = optimize(expr.m_value);
+
+    return LukObject();
+}
+
+LukObject Optimizer::visitSetIndexExpr(SetIndexExpr& expr) {
+    expr.m_object = optimize(expr.m_object);
+    expr.m_index = optimize(expr.m_index);
+    expr.m_value = optimize(expr.m_value);
+
+    return LukObject();
+}
+
+LukObject Optimizer::visitSuperExpr(SuperExpr&) {
+    ++m_unprunable;
+    return LukObject();
+}
+
+LukObject Optimizer::visitTernaryExpr(TernaryExpr& expr) {
+    expr.m_condition = optimize(expr.m_condition);
+    size_t unprunable = m_unprunable;
+    expr.m_thenBranch = optimize(expr.m_thenBranch);
+    bool thenPrunable = m_unprunable == unprunable;
+    unprunable = m_unprunable;
+    expr.m_elseBranch = optimize(expr.m_elseBranch);
+    bool elsePrunable = m_unprunable == unprunable;
+    LukObject cond;
+    if (!isLiteral(expr.m_condition, cond)) return LukObject();
+
+    if (m_interp.isTruthy(cond)) {
+        if (elsePrunable) m_exprResult = expr.m_thenBranch;
+    } else if (thenPrunable) {
+        m_exprResult = expr.m_elseBranch;
+    }
+
+    return LukObject();
+}
+
+LukObject Optimizer::visitThisExpr(ThisExpr&) {
+    ++m_unprunable;
+    return LukObject();
+}
+
+LukObject Optimizer::visitUnaryExpr(UnaryExpr& expr) {
+    expr.m_right = optimize(expr.m_right);
+    switch(expr.m_op->type) {
+        case TokenType::BANG:
+        case TokenType::MINUS:
+        case TokenType::PLUS:
+        case TokenType::BIT_NOT:
+            break;
+        // Note: increment and decrement assign their variable
+        default:
+            ++m_unprunable;
+            return LukObject();
+    }
+
+    LukObject right;
+    if (!isLiteral(expr.m_right, right)) return LukObject();
+    try {
+        auto value = m_interp.unaryOp(expr.m_op, right);
+        if (isFoldable(value)) m_exprResult = makeLiteral(value);
+    } catch (RuntimeError&) {
+        LOG_MSG(cat_RESOLVER, "\nOptimizer, not folded: ", expr.m_op->lexeme);
+    }
+
+    return LukObject();
+}
+
+LukObject Optimizer::visitVariableExpr(VariableExpr& expr) {
+    Symbol name = expr.m_name->symbol;
+    // Note: the scopes follow those of the resolver,
+    // a name not found in them is a global variable, which the resolver does not check.
+    for (auto scope = m_scopes.rbegin(); scope != m_scopes.rend(); ++scope) {
+        auto iter = scope->find(name);
+        if (iter == scope->end()) continue;
+        auto& local = iter->second;
+        if (local.m_isConst) {
+            local.m_replaced++;
+            m_exprResult = makeLiteral(local.m_value);
+        } else {
+            local.m_kept++;
+            ++m_unprunable;
+        }
+        return LukObject();
+    }
+
+    return LukObject();
+}
+
+// statements
+void Optimizer::visitBlockStmt(BlockStmt& stmt) {
+    beginScope();
+    auto results = optimizeStatements(stmt.m_statements);
+    endScope();
+    pruneStatements(stmt.m_statements, results);
+}
+
+void Optimizer::visitBreakStmt(BreakStmt&) {
+    ++m_unprunable;
+}
+
+void Optimizer::visitClassStmt(ClassStmt& stmt) {
+    ++m_unprunable;
+    declareShadow(stmt.m_name);
+    if (stmt.m_superclass != nullptr) {
+        // Note: the superclass cannot be replaced, its variable must stay declared
+        for (auto scope = m_scopes.rbegin(); scope != m_scopes.rend(); ++scope) {
+            auto iter = scope->find(stmt.m_superclass->m_name->symbol);
+            if (iter == scope->end()) continue;
+            iter->second.m_kept++;
+            break;
+        }
+        beginScope();
+    }
+    for (auto& it: stmt.m_vars) {
+        it.second = optimize(it.second);
+    }
+    for (auto& meth: stmt.m_methods) {
+        optimizeFunction(*meth->m_function);
+    }
+    for (auto& meth: stmt.m_classMethods) {
+        optimizeFunction(*meth->m_function);
+    }
+    if (stmt.m_superclass != nullptr) endScope();
+}
+
+void Optimizer::visitExpressionStmt(ExpressionStmt& stmt) {
+    stmt.m_expression = optimize(stmt.m_expression);
+}
+
+void Optimizer::visitForInStmt(ForInStmt& stmt) {
+    stmt.m_iterable = optimize(stmt.m_iterable);
+    // Note: the loop variable changes at each step, so it's never propagated
+    beginScope();
+    declareShadow(stmt.m_name);
+    stmt.m_body = optimizeSlot(stmt.m_body);
+    endScope();
+}
+
+void Optimizer::visitFunctionStmt(FunctionStmt& stmt) {
+    ++m_unprunable;
+    // the function is declared before its body, so it can call itself
+    declareShadow(stmt.m_name);
+    optimizeFunction(*stmt.m_function);
+}
+
+void Optimizer::visitIfStmt(IfStmt& stmt) {
+    stmt.m_condition = optimize(stmt.m_condition);
+    size_t unprunable = m_unprunable;
+    stmt.m_thenBranch = optimizeSlot(stmt.m_thenBranch);
+    bool thenPrunable = m_unprunable == unprunable;
+    unprunable = m_unprunable;
+    if (stmt.m_elseBranch) stmt.m_elseBranch = optimizeSlot(stmt.m_elseBranch);
+    bool elsePrunable = m_unprunable == unprunable;
+    LukObject cond;
+    if (!isLiteral(stmt.m_condition, cond)) return;
+
+    if (m_interp.isTruthy(cond)) {
+        if (elsePrunable) m_stmtResult = stmt.m_thenBranch;
+    } else if (thenPrunable) {
+        if (stmt.m_elseBranch) m_stmtResult = stmt.m_elseBranch;
+        else m_removeStmt = true;
+    }
+}
+
+void Optimizer::visitPrintStmt(PrintStmt& stmt) {
+    for (auto& arg: stmt.m_args) {
+        arg = optimize(arg);
+    }
+}
+
+void Optimizer::visitReturnStmt(ReturnStmt& stmt) {
+    ++m_unprunable;
+    stmt.m_value = optimize(stmt.m_value);
+}
+
+void Optimizer::visitVarStmt(VarStmt& stmt) {
+    ++m_unprunable;
+    for (auto& it: stmt.m_vars) {
+        // Note: like the resolver, the variable is declared before its initializer,
+        // so it's not replaced in it.
+        Local* local = nullptr;
+        if (!m_scopes.empty()) {
+            auto& scope = m_scopes.back();
+            if (scope.count(it.first->symbol)) {
+                declareShadow(it.first);
+            } else {
+                local = &scope[it.first->symbol];
+                local->m_name = it.first;
+                local->p_decl = &stmt;
+            }
+        }
+        it.second = optimize(it.second);
+        // Note: the scope is not modified by the initializer, so the local is still valid
+        if (local != nullptr) {
+            local->m_isConst = isLiteral(it.second, local->m_value)
+                && m_assigned.count(it.first->symbol) == 0;
+        }
+    }
+}
+
+void Optimizer::visitWhileStmt(WhileStmt& stmt) {
+    stmt.m_condition = optimize(stmt.m_condition);
+    size_t unprunable = m_unprunable;
+    stmt.m_body = optimizeSlot(stmt.m_body);
+    LukObject cond;
+    // Note: the body of a do-while loop runs once, whatever its condition
+    if (stmt.m_isWhile && m_unprunable == unprunable &&
+            isLiteral(stmt.m_condition, cond) && !m_interp.isTruthy(cond)) {
+        m_removeStmt = true;
+    }
+}
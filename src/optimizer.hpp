@@ -0,0 +1,132 @@
+#ifndef OPTIMIZER_HPP
+#define OPTIMIZER_HPP
+
+#include "common.hpp"
+#include "expr.hpp"
+#include "stmt.hpp"
+#include "lukobject.hpp"
+#include "lukerror.hpp"
+#include "logger.hpp"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace luky {
+    class Interpreter;
+
+    /// Note: the optimizer rewrites the AST between the parser and the resolver.
+    /// It folds the operators over literals, with the operations of the interpreter,
+    /// so a folded result is exactly the value computed at runtime,
+    /// an operation which throws an error is left to the runtime.
+    /// It simplifies constant ternary and logical expressions,
+    /// prunes if and while statements with a constant condition,
+    /// and propagates the local variables initialized by a literal and never assigned.
+    /// Dead code is dropped only whether it declares and reads nothing,
+    /// so the resolver reports the same errors as without the optimizer.
+    class Optimizer : public ExprVisitor,  public StmtVisitor {
+    public:
+        // Note: level 0 leaves the AST unchanged
+        explicit Optimizer(Interpreter& interp, LukError& lukErr, int level=1);
+        ~Optimizer() {
+          LOG_MSG(cat_RESOLVER, "\n~Optimizer destructor");
+        }
+
+        void optimize(std::vector<StmtPtr>& statements);
+
+        // expressions
+        LukObject visitAssignExpr(AssignExpr& expr) override;
+        LukObject visitBinaryExpr(BinaryExpr& expr) override;
+        LukObject visitCallExpr(CallExpr& expr) override;
+        LukObject visitFunctionExpr(FunctionExpr& expr) override;
+        LukObject visitGetExpr(GetExpr& expr) override;
+        LukObject visitGroupingExpr(GroupingExpr& expr) override;
+        LukObject visitIndexExpr(IndexExpr& expr) override;
+        LukObject visitInterpolateExpr(InterpolateExpr& expr) override;
+        LukObject visitInvokeExpr(InvokeExpr& expr) override;
+        LukObject visitListExpr(ListExpr& expr) override;
+        LukObject visitLiteralExpr(LiteralExpr& expr) override;
+        LukObject visitLogicalExpr(LogicalExpr& expr) override;
+        LukObject visitMapExpr(MapExpr& expr) override;
+        LukObject visitSetExpr(SetExpr& expr) override;
+        LukObject visitSetIndexExpr(SetIndexExpr& expr) override;
+        LukObject visitSuperExpr(SuperExpr& expr) override;
+        LukObject visitTernaryExpr(TernaryExpr& expr) override;
+        LukObject visitThisExpr(ThisExpr& expr) override;
+        LukObject visitUnaryExpr(UnaryExpr& expr) override;
+        LukObject visitVariableExpr(VariableExpr& expr) override;
+
+        // statements
+        void visitBlockStmt(BlockStmt& stmt) override;
+        void visitBreakStmt(BreakStmt& stmt) override;
+        void visitClassStmt(ClassStmt& stmt) override;
+        void visitExpressionStmt(ExpressionStmt& stmt) override;
+        void visitForInStmt(ForInStmt& stmt) override;
+        void visitFunctionStmt(FunctionStmt& stmt) override;
+        void visitIfStmt(IfStmt& stmt) override;
+        void visitPrintStmt(PrintStmt& stmt) override;
+        void visitReturnStmt(ReturnStmt& stmt) override;
+        void visitVarStmt(VarStmt& stmt) override;
+        void visitWhileStmt(WhileStmt& stmt) override;
+
+        // Note: a longer string is built at runtime, instead of being stored in the AST
+        static constexpr size_t MaxFoldedString = 1024;
+
+    private:
+        class AssignedNames;
+
+        // local variable, which is a constant whether its initializer is a literal
+        struct Local {
+            bool m_isConst = false;
+            LukObject m_value;
+            VarStmt* p_decl = nullptr;
+            TokPtr m_name;
+            // reads replaced by the value, and reads left in the AST
+            int m_replaced =0;
+            int m_kept =0;
+        };
+        using Scope = std::unordered_map<Symbol, Local>;
+
+        // returns the expression replacing expr, or expr itself
+        ExprPtr optimize(ExprPtr expr);
+        // returns nullptr whether the statement can be removed
+        StmtPtr optimize(StmtPtr stmt);
+        // optimizes a statement which cannot be removed
+        StmtPtr optimizeSlot(StmtPtr stmt);
+        void optimizeFunction(FunctionExpr& func);
+
+        void beginScope();
+        void endScope();
+        void declareShadow(const TokPtr& name);
+        // Note: statements are optimized before the scope ends,
+        // and dropped after, when the propagated declarations are known.
+        std::vector<StmtPtr> optimizeStatements(std::vector<StmtPtr>& statements);
+        void pruneStatements(std::vector<StmtPtr>& statements, std::vector<StmtPtr>& results);
+
+        // whether the expression is a literal, and sets its value
+        static bool isLiteral(const ExprPtr& expr, LukObject& value);
+        ExprPtr makeLiteral(const LukObject& value);
+        // whether the value can be stored in a literal
+        bool isFoldable(const LukObject& value) const;
+
+        Interpreter& m_interp;
+        LukError& m_lukErr;
+        int m_level;
+        ExprPtr m_exprResult = nullptr;
+        StmtPtr m_stmtResult = nullptr;
+        bool m_removeStmt = false;
+        // Note: counts the nodes which cannot be dropped,
+        // a subtree is dead code to drop whether the counter is unchanged by its visit.
+        size_t m_unprunable =0;
+        std::vector<Scope> m_scopes;
+        // names assigned somewhere in the script, they are never propagated
+        std::unordered_set<Symbol> m_assigned;
+        // declarations whose variables are all propagated
+        std::unordered_set<Stmt*> m_emptyDecls;
+        size_t m_folded =0;
+    };
+}
+
+#endif // OPTIMIZER_HPP
@@ -11,11 +11,12 @@ ParseError::ParseError(const std::string& msg, TokPtr& tokP)
     : std::runtime_error(msg)
     , m_token(tokP) {}
 
-Parser::Parser(const std::vector<TokPtr>&& tokens, LukError& _lukErr)
+Parser::Parser(std::vector<TokPtr> tokens, SourcePtr source, LukError& _lukErr)
       : m_current(0),
       m_tokens(std::move(tokens)),
+      p_source(std::move(source)),
       lukErr(_lukErr) {
-    logMsg("\nIn Parser constructor");
+    LOG_MSG(cat_PARSER, "\nIn Parser constructor");
 }
 
 std::vector<StmtPtr> Parser::parse() {
@@ -52,6 +53,8 @@ StmtPtr Parser::statement() {
         return returnStatement();
     if (match({TokenType::WHILE})) 
         return whileStatement();
+    if (check(TokenType::LEFT_BRACE) && isMapStart())
+        return expressionStatement();
     if (match({TokenType::LEFT_BRACE}))
         return std::make_shared<BlockStmt>( block() );
     
@@ -88,7 +91,13 @@ StmtPtr Parser::doStatement() {
 }
 
 StmtPtr Parser::forStatement() {
+    TokPtr keyword = previous();
     consume(TokenType::LEFT_PAREN, "Expect '(' after 'for'");
+    if ((check(TokenType::VAR) && m_tokens[m_current+1]->type == TokenType::IDENTIFIER
+                && m_tokens[m_current+2]->type == TokenType::IN) ||
+            (check(TokenType::IDENTIFIER) && checkNext(TokenType::IN))) {
+        return forInStatement(keyword);
+    }
     StmtPtr initializer; 
     if (match({TokenType::SEMICOLON})) {
         initializer = nullptr;
@@ -129,6 +138,19 @@ StmtPtr Parser::forStatement() {
     return body;
 }
 
+// Note: the 'var' before the loop variable is optional,
+// the variable is always declared in the scope of the loop
+StmtPtr Parser::forInStatement(TokPtr& keyword) {
+    match({TokenType::VAR});
+    TokPtr name = consume(TokenType::IDENTIFIER, "Expect variable name.");
+    consume(TokenType::IN, "Expect 'in' after loop variable.");
+    ExprPtr iterable = expression();
+    consume(TokenType::RIGHT_PAREN, "Expect ')' after for clauses.");
+    StmtPtr body = statement();
+
+    return std::make_shared<ForInStmt>(keyword, name, iterable, body);
+}
+
 StmtPtr Parser::ifStatement() {
     consume(TokenType::LEFT_PAREN, "Expect '(' after 'if'");
     ExprPtr condition = expression();
@@ -165,7 +187,7 @@ StmtPtr Parser::returnStatement() {
     if (!check(TokenType::SEMICOLON)) {
         value = expression();
     }
-    consume(TokenType::SEMICOLON, "Expect ';' after return value.");
+    checkEndLine("Expect ';' after return value.", true);
 
     return std::make_shared<ReturnStmt>(keyword, value);
 }
@@ -323,7 +345,7 @@ std::shared_ptr<FunctionExpr> Parser::functionBody(const std::string& kind) {
       auto retStmt = std::make_shared<ReturnStmt>(keyword, value);
       body.emplace_back( retStmt );
  
-      return std::make_shared<FunctionExpr>(params, body);
+      return std::make_shared<FunctionExpr>(params, body, p_source);
 
     }
 
@@ -332,7 +354,7 @@ std::shared_ptr<FunctionExpr> Parser::functionBody(const std::string& kind) {
     // std::vector<StmtPtr> body = block();
     body = block();
 
-    return std::make_shared<FunctionExpr>(params, body);
+    return std::make_shared<FunctionExpr>(params, body, p_source);
 }
 
 ExprPtr Parser::expression() {
@@ -371,6 +393,12 @@ ExprPtr Parser::assignment() {
         } else if (left->isGetExpr()) {
           return std::make_shared<SetExpr>(left->getObject(),
                 left->getName(), value );
+        } else if (left->isIndexExpr()) {
+          auto indexExpr = std::static_pointer_cast<IndexExpr>(left);
+          if (!indexExpr->m_isSlice) {
+            return std::make_shared<SetIndexExpr>(indexExpr->m_object,
+                indexExpr->m_bracket, indexExpr->m_index, equals, value);
+          }
         }
         
         error(equals, "Invalid assignment target.");
@@ -587,7 +615,14 @@ ExprPtr Parser::call() {
         } else if (match({TokenType::DOT})) {
           TokPtr name = consume(TokenType::IDENTIFIER,
             "Expect property name after '.'.");
-          expr = std::make_shared<GetExpr>(expr, name);
+          // Note: a get followed by a call is a method invocation
+          if (match({TokenType::LEFT_PAREN})) {
+            expr = finishInvoke(expr, name);
+          } else {
+            expr = std::make_shared<GetExpr>(expr, name);
+          }
+        } else if (match({TokenType::LEFT_BRACKET})) {
+            expr = finishIndex(expr);
         } else {
             break;
         }
@@ -598,8 +633,38 @@ ExprPtr Parser::call() {
 
 ExprPtr Parser::finishCall(ExprPtr callee) {
     std::vector<ExprPtr> v_args;
-    std::vector<ExprPtr> v_keywords;
     std::map<TokPtr, ExprPtr> mapKeywords; 
+    TokPtr paren = arguments(v_args, mapKeywords);
+
+    return std::make_shared<CallExpr>(callee, paren, v_args, mapKeywords);
+}
+
+ExprPtr Parser::finishIndex(ExprPtr object) {
+    TokPtr bracket = previous();
+    ExprPtr index = nullptr;
+    ExprPtr end = nullptr;
+    bool isSlice = false;
+    /// Note: calling assignment function rather than expression to avoid the comma operator
+    if (!check(TokenType::COLON)) index = assignment();
+    if (match({TokenType::COLON})) {
+        isSlice = true;
+        if (!check(TokenType::RIGHT_BRACKET)) end = assignment();
+    }
+    consume(TokenType::RIGHT_BRACKET, "Expect ']' after index.");
+
+    return std::make_shared<IndexExpr>(object, bracket, index, end, isSlice);
+}
+
+ExprPtr Parser::finishInvoke(ExprPtr object, TokPtr& name) {
+    std::vector<ExprPtr> v_args;
+    std::map<TokPtr, ExprPtr> mapKeywords; 
+    TokPtr paren = arguments(v_args, mapKeywords);
+
+    return std::make_shared<InvokeExpr>(object, name, paren, v_args, mapKeywords);
+}
+
+/// Note: parses the arguments and the keywords of a call, returns the closing parenthesis
+TokPtr Parser::arguments(std::vector<ExprPtr>& v_args, std::map<TokPtr, ExprPtr>& mapKeywords) {
     if (!check(TokenType::RIGHT_PAREN)) {
         do {
             if (v_args.size() >= 32) {
@@ -620,38 +685,29 @@ ExprPtr Parser::finishCall(ExprPtr callee) {
         } while (match({TokenType::COMMA}));
     }
 
-    TokPtr paren = consume(TokenType::RIGHT_PAREN, "Expect ')' after arguments.");
-
-    return std::make_shared<CallExpr>(callee, paren, v_args, mapKeywords);
+    return consume(TokenType::RIGHT_PAREN, "Expect ')' after arguments.");
 }
 
 ExprPtr Parser::primary() {
-    ObjPtr objP = nullptr;
+    LukObject obj;
+    bool isLiteral = true;
     if (match( {TokenType::NIL})) 
-        objP = std::make_shared<LukObject>();
+        obj = LukObject();
     else if (match( {TokenType::FALSE})) 
-        objP = std::make_shared<LukObject>( false );
+        obj = LukObject( false );
     else if (match( {TokenType::TRUE})) 
-        objP = std::make_shared<LukObject>( true );
+        obj = LukObject( true );
     else if (match( {TokenType::INT})) 
-        objP = std::make_shared<LukObject>(std::stol( previous()->literal ));
+        obj = LukObject(TLukInt(std::stol( std::string(previous()->literal) )));
     else if (match( {TokenType::NUMBER, TokenType::DOUBLE})) 
-        objP = std::make_shared<LukObject>(std::stod( previous()->literal ));
+        obj = LukObject(std::stod( std::string(previous()->literal) ));
     else if (match( {TokenType::STRING})) 
-        objP = std::make_shared<LukObject>(previous()->literal);
+        obj = LukObject(std::string(previous()->literal));
+    else isLiteral = false;
         
-    /*
-    else if (match(
-                {TokenType::FALSE, TokenType::TRUE, 
-                TokenType::NIL,
-                TokenType::NUMBER, TokenType::STRING, 
-                TokenType::INT, TokenType::DOUBLE})) { 
-        ObjPtr objP = std::make_shared<LukObject>( previous() );
-        */
-    
-    if (objP != nullptr) {
-        logMsg("\nIn primary Parser, before literalExpr: ", objP);
-        return std::make_shared<LiteralExpr>( objP );
+    if (isLiteral) {
+        LOG_MSG(cat_PARSER, "\nIn primary Parser, before literalExpr: ", obj);
+        return std::make_shared<LiteralExpr>( obj );
     }
    
     if (match({TokenType::SUPER})) {
@@ -683,6 +739,42 @@ ExprPtr Parser::primary() {
         consume(TokenType::RIGHT_PAREN, "Exppect ')' after expression.");
         return std::make_shared<GroupingExpr>(expr);
     }
+
+    // list literal
+    if (match({TokenType::LEFT_BRACKET})) {
+        TokPtr bracket = previous();
+        std::vector<ExprPtr> items;
+        if (!check(TokenType::RIGHT_BRACKET)) {
+            do {
+                // Note: a trailing comma is allowed
+                if (check(TokenType::RIGHT_BRACKET)) break;
+                items.push_back(assignment());
+            } while (match({TokenType::COMMA}));
+        }
+        consume(TokenType::RIGHT_BRACKET, "Expect ']' after list items.");
+        return std::make_shared<ListExpr>(bracket, items);
+    }
+
+    // map literal, a brace in an expression
+    if (match({TokenType::LEFT_BRACE})) {
+        TokPtr brace = previous();
+        std::vector<std::pair<ExprPtr, ExprPtr>> entries;
+        skipEndLines();
+        if (!check(TokenType::RIGHT_BRACE)) {
+            do {
+                skipEndLines();
+                // Note: a trailing comma is allowed
+                if (check(TokenType::RIGHT_BRACE)) break;
+                ExprPtr key = assignment();
+                consume(TokenType::COLON, "Expect ':' after map key.");
+                skipEndLines();
+                entries.emplace_back(key, assignment());
+                skipEndLines();
+            } while (match({TokenType::COMMA}));
+        }
+        consume(TokenType::RIGHT_BRACE, "Expect '}' after map entries.");
+        return std::make_shared<MapExpr>(brace, std::move(entries));
+    }
     
     
     throw error(peek(), "Expect expression.");
@@ -692,6 +784,9 @@ ExprPtr Parser::primary() {
 bool Parser::checkEndLine(const std::string& msg, bool verbose=true) {
     if (isAtEnd()) return false;
     if (match({TokenType::SEMICOLON})) return true;
+    // Note: no semicolon is inserted after a closing brace,
+    // so a map literal or a lambda can end the line, like a block
+    if (previous()->type == TokenType::RIGHT_BRACE) return false;
     
     if (verbose)
       throw error(peek(), msg);
@@ -699,6 +794,23 @@ bool Parser::checkEndLine(const std::string& msg, bool verbose=true) {
     return false;
 }
 
+void Parser::skipEndLines() {
+    while (match({TokenType::SEMICOLON}));
+}
+
+bool Parser::isMapStart() {
+    // Note: a block never starts with a key followed by a colon
+    if (m_current +2 >= m_tokens.size()) return false;
+    if (m_tokens[m_current+2]->type != TokenType::COLON) return false;
+    switch (m_tokens[m_current+1]->type) {
+        case TokenType::STRING: case TokenType::INT: case TokenType::DOUBLE:
+        case TokenType::IDENTIFIER: case TokenType::TRUE: case TokenType::FALSE:
+            return true;
+        default:
+            return false;
+    }
+}
+
 TokPtr& Parser::consume(TokenType type, std::string message) {
     if (check(type))
         return advance();
@@ -711,7 +823,7 @@ ParseError Parser::error(TokPtr& tokP, const std::string& message) {
         lukErr.error(errTitle, tokP->line, tokP->col, " at end, " + message);
     } else {
         lukErr.error(errTitle, tokP->line, tokP->col, 
-                "at '" + tokP->lexeme + "' " + message);
+                "at '" + std::string(tokP->lexeme) + "' " + message);
     }
 
     throw ParseError(message, tokP);
@@ -24,10 +24,11 @@ namespace luky {
 
     class Parser {
     public:
-        Parser(const std::vector<TokPtr>&& tokens, LukError& lukErr);
+        // Note: the functions keep the source, so their tokens outlive the statements run
+        Parser(std::vector<TokPtr> tokens, SourcePtr source, LukError& lukErr);
         
         ~Parser() {
-          logMsg("\n~Parser destructor");
+          LOG_MSG(cat_PARSER, "\n~Parser destructor");
 
         }
         std::vector<StmtPtr> parse();
@@ -36,6 +37,7 @@ namespace luky {
     private:
         size_t m_current;
         std::vector<TokPtr> m_tokens;
+        SourcePtr p_source;
         LukError& lukErr;
         const std::string errTitle = "ParseError: ";
         bool m_isFuncBody = false;
@@ -48,6 +50,7 @@ namespace luky {
         StmtPtr doStatement();
         StmtPtr expressionStatement();
         StmtPtr forStatement();
+        StmtPtr forInStatement(TokPtr& keyword);
         FuncPtr function(const std::string& kind);
         StmtPtr ifStatement();
         StmtPtr printStatement();
@@ -78,8 +81,16 @@ namespace luky {
         ExprPtr postfix();
         ExprPtr call();
         ExprPtr finishCall(ExprPtr callee);
+        ExprPtr finishIndex(ExprPtr object);
+        ExprPtr finishInvoke(ExprPtr object, TokPtr& name);
+        TokPtr arguments(std::vector<ExprPtr>& v_args, std::map<TokPtr, ExprPtr>& mapKeywords);
         ExprPtr primary();
         bool checkEndLine(const std::string& msg, bool verbose);
+        // the scanner reads every brace as a block, so it inserts semicolons
+        // at the newlines of a map literal, which are skipped between its entries
+        void skipEndLines();
+        // whether the left brace starting a statement opens a map literal instead of a block
+        bool isMapStart();
 
         TokPtr& consume(TokenType type, std::string message);
         bool match(const std::vector<TokenType>& types);
@@ -0,0 +1,102 @@
+#ifndef RESERVEDWORDS_HPP
+#define RESERVEDWORDS_HPP
+
+#include "token.hpp"
+
+#include <array>
+#include <cstdint> // uint32_t
+#include <string_view>
+
+namespace luky {
+    /// Note: table of the reserved words, built at compile time.
+    /// The hash of a word is computed from its length, its first and its last char,
+    /// with a multiplier searched at compile time so the reserved words never collide,
+    /// a perfect hash. So a word is checked by one hash, one slot and one comparison,
+    /// without map and without allocation.
+    namespace reserved {
+        struct Word {
+            std::string_view name;
+            TokenType type;
+        };
+
+        constexpr Word Words[] = {
+            {"and", TokenType::AND},
+            {"break", TokenType::BREAK},
+            {"class", TokenType::CLASS},
+            {"continue", TokenType::CONTINUE},
+            {"do", TokenType::DO},
+            {"else", TokenType::ELSE},
+            {"false", TokenType::FALSE},
+            {"for", TokenType::FOR},
+            {"fun", TokenType::FUN},
+            {"if", TokenType::IF},
+            {"in", TokenType::IN},
+            {"nil", TokenType::NIL},
+            {"or", TokenType::OR},
+            {"print", TokenType::PRINT},
+            {"return", TokenType::RETURN},
+            {"super", TokenType::SUPER},
+            {"this", TokenType::THIS},
+            {"true", TokenType::TRUE},
+            {"var", TokenType::VAR},
+            {"while", TokenType::WHILE},
+        };
+
+        // Note: the number of slots is a power of 2, so the slot is a mask of the hash
+        constexpr uint32_t Slots =64;
+        constexpr size_t MinLength =2;
+        constexpr size_t MaxLength =8;
+
+        constexpr uint32_t hash(std::string_view word, uint32_t mult) {
+            return (static_cast<unsigned char>(word.front()) * mult +
+                    static_cast<unsigned char>(word.back()) + static_cast<uint32_t>(word.size()) * 31) & (Slots -1);
+        }
+
+        constexpr bool isPerfect(uint32_t mult) {
+            bool used[Slots] = {};
+            for (auto& word: Words) {
+                const uint32_t slot = hash(word.name, mult);
+                if (used[slot]) return false;
+                used[slot] = true;
+            }
+
+            return true;
+        }
+
+        // first multiplier without collision, 0 whether there is none
+        constexpr uint32_t findMultiplier() {
+            for (uint32_t mult =1; mult < 4096; ++mult) {
+                if (isPerfect(mult)) return mult;
+            }
+
+            return 0;
+        }
+
+        constexpr uint32_t Multiplier = findMultiplier();
+        static_assert(Multiplier != 0, "no perfect hash of the reserved words");
+
+        // Note: an empty slot has an empty name, which never equals an identifier
+        constexpr std::array<Word, Slots> buildTable() {
+            std::array<Word, Slots> table {};
+            for (auto& slot: table) slot = {std::string_view(), TokenType::IDENTIFIER};
+            for (auto& word: Words) table[hash(word.name, Multiplier)] = word;
+
+            return table;
+        }
+
+        constexpr std::array<Word, Slots> Table = buildTable();
+
+        // returns the type of a reserved word, IDENTIFIER for another word
+        constexpr TokenType lookup(std::string_view word) {
+            if (word.size() < MinLength || word.size() > MaxLength) return TokenType::IDENTIFIER;
+            const Word& slot = Table[hash(word, Multiplier)];
+
+            return slot.name == word ? slot.type : TokenType::IDENTIFIER;
+        }
+
+        static_assert(lookup("continue") == TokenType::CONTINUE && lookup("in") == TokenType::IN &&
+                lookup("orchid") == TokenType::IDENTIFIER, "reserved words table");
+    }
+}
+
+#endif // RESERVEDWORDS_HPP
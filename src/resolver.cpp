@@ -5,13 +5,13 @@ using namespace luky;
 Resolver::Resolver(Interpreter& interp, LukError& lukErr)
       : m_interp(interp),
       m_lukErr(lukErr) {
-    logMsg("\nIn Resolver constructor");
+    LOG_MSG(cat_RESOLVER, "\nIn Resolver constructor");
 }
 
 void Resolver::beginScope() {
-  std::unordered_map<std::string, Variable> scope;
+  std::unordered_map<Symbol, Variable> scope;
   m_scopes.push_back(scope);
-  logMsg("\nin beginScope, adding scope, m_scopes size: ", m_scopes.size());
+  LOG_MSG(cat_RESOLVER, "\nin beginScope, adding scope, m_scopes size: ", m_scopes.size());
 }
 
 void Resolver::endScope() {
@@ -25,25 +25,31 @@ void Resolver::endScope() {
   /// Note: pop_back function does not returns any value
   /// but remove the item from the vector
   m_scopes.pop_back();
-  logMsg("\nin endScope, remove scope, m_scopes size: ", m_scopes.size());
+  LOG_MSG(cat_RESOLVER, "\nin endScope, remove scope, m_scopes size: ", m_scopes.size());
   
 }
 
-void Resolver::declare(TokPtr& name) {
-  if (m_scopes.size() == 0) return;
+int Resolver::declare(TokPtr& name) {
+  // global variables have no slot
+  if (m_scopes.size() == 0) return -1;
   auto& scope = m_scopes.back();
-  auto iter = scope.find(name->lexeme);
+  // Note: slots are given in the declaration order,
+  // so the environment created at runtime for this scope has the same layout.
+  int slot = scope.size();
+  auto iter = scope.find(name->symbol);
   if (iter != scope.end()) {
     m_lukErr.error(errTitle, name, "This Variable is allready declared in this scope.");
+    slot = iter->second.m_slot;
   }
-  scope[name->lexeme] = Variable(name, VarState::DECLARED);
+  scope[name->symbol] = Variable(name, VarState::DECLARED, slot);
 
+  return slot;
 }
 
 void Resolver::define(TokPtr& name) {
   if (m_scopes.size() == 0) return;
   auto& scope = m_scopes.back(); 
-  scope.at(name->lexeme).m_state = VarState::DEFINED;
+  scope.at(name->symbol).m_state = VarState::DEFINED;
 }
 
 // resolve vector
@@ -67,7 +73,16 @@ void Resolver::resolve(StmtPtr& stmt) {
 void Resolver::resolveFunction(FunctionExpr& func, FunctionType ft) {
   auto enclosingFt = m_curFunction;
   m_curFunction = ft;
+  // a loop cannot be break from an inner function
+  auto enclosingLoopDepth = m_loopDepth;
+  m_loopDepth =0;
   beginScope();
+  // Note: "this" is the first slot of a method's frame, so calling a method
+  // does not need a bound environment.
+  if (ft == FunctionType::Method || ft == FunctionType::Initializer) {
+    func.m_isMethod = true;
+    m_scopes.back()[SymbolTable::This] = Variable(m_thisName, VarState::READ, 0);
+  }
   for (TokPtr& param: func.m_params) {
     declare(param);
     define(param);
@@ -76,6 +91,7 @@ void Resolver::resolveFunction(FunctionExpr& func, FunctionType ft) {
   resolve(func.m_body);
   endScope();
   m_curFunction = enclosingFt;
+  m_loopDepth = enclosingLoopDepth;
 }
 
 // resolve expressions
@@ -84,20 +100,21 @@ void Resolver::resolve(ExprPtr expr) {
 }
 
 void Resolver::resolveLocal(Expr* expr, TokPtr& name, bool isRead) {
-  logMsg("In resolveLocal, expr id: ", expr->id(), ", name: ", name->lexeme);
+  LOG_MSG(cat_RESOLVER, "In resolveLocal, expr id: ", expr->id(), ", name: ", name->lexeme);
   // FIX: why we cannot receive as argument an Expr& instead Expr* ???
   // because expr is a pointer object, and a non const object, 
   // so, we cannot pass as a constant (&) object.
-  logMsg("m_scopes size: ", m_scopes.size());
+  LOG_MSG(cat_RESOLVER, "m_scopes size: ", m_scopes.size());
   for (int i = m_scopes.size() -1; i >=0; --i) {
     auto& scope = m_scopes.at(i);
-    logMsg("in loop, taken scope at index: ", i);
-    auto iter = scope.find(name->lexeme);
+    LOG_MSG(cat_RESOLVER, "in loop, taken scope at index: ", i);
+    auto iter = scope.find(name->symbol);
     if (iter != scope.end()) {
-      logMsg("find name: ", name->lexeme);
+      LOG_MSG(cat_RESOLVER, "find name: ", name->lexeme);
       int depth = m_scopes.size() -1 - i;
-      logMsg("in loop, taken depth : ", depth);
-      m_interp.resolve(*expr, depth);
+      LOG_MSG(cat_RESOLVER, "in loop, taken depth : ", depth, ", slot: ", iter->second.m_slot);
+      expr->m_depth = depth;
+      expr->m_slot = iter->second.m_slot;
       // mark variable is used
       // /*
       if (isRead) {
@@ -107,7 +124,7 @@ void Resolver::resolveLocal(Expr* expr, TokPtr& name, bool isRead) {
       
       return;
     } else {
-      logMsg("Not found name: ", name->lexeme);
+      LOG_MSG(cat_RESOLVER, "Not found name: ", name->lexeme);
     }
 
   }
@@ -115,24 +132,32 @@ void Resolver::resolveLocal(Expr* expr, TokPtr& name, bool isRead) {
   // Not found. Assume it is global
 }
 
+int Resolver::localDepth(Symbol name) {
+  for (int i = m_scopes.size() -1; i >=0; --i) {
+    if (m_scopes[i].count(name)) return m_scopes.size() -1 - i;
+  }
+
+  return -1;
+}
+
 // expressions
-ObjPtr Resolver::visitAssignExpr(AssignExpr& expr) {
-    logMsg("\nIn visitAssignExpr, Resolver, name:  ", expr.m_name);
+LukObject Resolver::visitAssignExpr(AssignExpr& expr) {
+    LOG_MSG(cat_RESOLVER, "\nIn visitAssignExpr, Resolver, name:  ", expr.m_name);
     resolve(expr.m_value);
     // variable is not read yet
     resolveLocal(&expr, expr.m_name, false);
   
-  return nilptr;
+  return LukObject();
 }
 
-ObjPtr Resolver::visitBinaryExpr(BinaryExpr& expr) {
+LukObject Resolver::visitBinaryExpr(BinaryExpr& expr) {
   resolve(expr.m_left);
   resolve(expr.m_right);
   
-  return nilptr;
+  return LukObject();
 }
 
-ObjPtr Resolver::visitCallExpr(CallExpr& expr) {
+LukObject Resolver::visitCallExpr(CallExpr& expr) {
   resolve(expr.m_callee);
   for (std::shared_ptr<Expr>& arg : expr.m_args) {
     resolve(arg);
@@ -143,56 +168,101 @@ ObjPtr Resolver::visitCallExpr(CallExpr& expr) {
   }
 
 
-  return nilptr;
+  return LukObject();
 }
 
-ObjPtr Resolver::visitFunctionExpr(FunctionExpr& expr) {
+LukObject Resolver::visitInvokeExpr(InvokeExpr& expr) {
+  resolve(expr.m_object);
+  for (auto& arg : expr.m_args) {
+    resolve(arg);
+  }
+  for (auto& it: expr.m_keywords) {
+    resolve(it.second);
+  }
+
+  return LukObject();
+}
+
+LukObject Resolver::visitFunctionExpr(FunctionExpr& expr) {
   resolveFunction(expr, FunctionType::Function);
-  return nilptr;
+  return LukObject();
 }
 
 
-ObjPtr Resolver::visitGetExpr(GetExpr& expr) {
+LukObject Resolver::visitGetExpr(GetExpr& expr) {
   resolve(expr.m_object);
 
-  return nilptr;
+  return LukObject();
 }
 
-ObjPtr Resolver::visitGroupingExpr(GroupingExpr& expr) {
+LukObject Resolver::visitGroupingExpr(GroupingExpr& expr) {
   resolve(expr.m_expression);
  
-  return nilptr;
+  return LukObject();
+}
+
+LukObject Resolver::visitIndexExpr(IndexExpr& expr) {
+  resolve(expr.m_object);
+  if (expr.m_index) resolve(expr.m_index);
+  if (expr.m_end) resolve(expr.m_end);
+
+  return LukObject();
 }
 
-ObjPtr Resolver::visitInterpolateExpr(InterpolateExpr& expr) {
+LukObject Resolver::visitInterpolateExpr(InterpolateExpr& expr) {
     for (auto& arg : expr.m_args) {
         resolve(arg);
     }
 
-    return nilptr;
+    return LukObject();
 }
 
-ObjPtr Resolver::visitLiteralExpr(LiteralExpr& expr) {
-    logMsg("\nIn visitLiteralExpr, Resolver, value: ", expr.m_value->toString());
+LukObject Resolver::visitListExpr(ListExpr& expr) {
+    for (auto& item : expr.m_items) {
+        resolve(item);
+    }
 
-    return nilptr;
+    return LukObject();
 }
 
-ObjPtr Resolver::visitLogicalExpr(LogicalExpr& expr) {
+LukObject Resolver::visitLiteralExpr(LiteralExpr& expr) {
+    LOG_MSG(cat_RESOLVER, "\nIn visitLiteralExpr, Resolver, value: ", expr.m_value.toString());
+
+    return LukObject();
+}
+
+LukObject Resolver::visitLogicalExpr(LogicalExpr& expr) {
   resolve(expr.m_left);
   resolve(expr.m_right);
   
-  return nilptr;
+  return LukObject();
+}
+
+LukObject Resolver::visitMapExpr(MapExpr& expr) {
+    for (auto& entry : expr.m_entries) {
+        resolve(entry.first);
+        resolve(entry.second);
+    }
+
+    return LukObject();
+}
+
+LukObject Resolver::visitSetExpr(SetExpr& expr) {
+  resolve(expr.m_value);
+  resolve(expr.m_object);
+
+  return LukObject();
 }
 
-ObjPtr Resolver::visitSetExpr(SetExpr& expr) {
+LukObject Resolver::visitSetIndexExpr(SetIndexExpr& expr) {
   resolve(expr.m_value);
   resolve(expr.m_object);
+  resolve(expr.m_index);
 
-  return nilptr;
+  return LukObject();
 }
 
-ObjPtr Resolver::visitSuperExpr(SuperExpr& expr) {
+LukObject Resolver::visitSuperExpr(SuperExpr& expr) {
     if (currentClass == ClassType::None) {
       m_lukErr.error(errTitle, expr.m_keyword,
           "Cannot use 'super' outside of a class.");
@@ -202,20 +272,21 @@ ObjPtr Resolver::visitSuperExpr(SuperExpr& expr) {
     }
   // mark variable is used
   resolveLocal(&expr, expr.m_keyword, true);
+  expr.m_thisDepth = localDepth(SymbolTable::This);
   
-  return nilptr;
+  return LukObject();
 }
 
-ObjPtr Resolver::visitTernaryExpr(TernaryExpr& expr) {
+LukObject Resolver::visitTernaryExpr(TernaryExpr& expr) {
     resolve(expr.m_condition);
     resolve(expr.m_thenBranch);
     resolve(expr.m_elseBranch);
   
-    return nilptr;
+    return LukObject();
 }
 
 
-ObjPtr Resolver::visitThisExpr(ThisExpr& expr) {
+LukObject Resolver::visitThisExpr(ThisExpr& expr) {
   if (currentClass == ClassType::None) {
       m_lukErr.error(errTitle, expr.m_keyword,
           "Cannot use 'this' outside of a class.");
@@ -223,19 +294,19 @@ ObjPtr Resolver::visitThisExpr(ThisExpr& expr) {
   // mark variable is used
   resolveLocal(&expr, expr.m_keyword, true);
 
-  return nilptr;
+  return LukObject();
 }
 
-ObjPtr Resolver::visitUnaryExpr(UnaryExpr& expr) {
+LukObject Resolver::visitUnaryExpr(UnaryExpr& expr) {
   resolve(expr.m_right);
   
-  return nilptr;
+  return LukObject();
 }
 
-ObjPtr Resolver::visitVariableExpr(VariableExpr& expr) {
+LukObject Resolver::visitVariableExpr(VariableExpr& expr) {
   if (m_scopes.size() != 0) {
     auto& scope = m_scopes.back();
-    auto iter = scope.find(expr.m_name->lexeme);
+    auto iter = scope.find(expr.m_name->symbol);
     if (iter != scope.end() && 
         iter->second.m_state == VarState::DECLARED) {
       m_lukErr.error(errTitle, expr.m_name, "Cannot read local variable in its own initializer.");
@@ -245,7 +316,7 @@ ObjPtr Resolver::visitVariableExpr(VariableExpr& expr) {
   // mark variable is used
   resolveLocal(&expr, expr.m_name, true);
 
-  return nilptr;
+  return LukObject();
 }
 
 // statements
@@ -256,7 +327,11 @@ void Resolver::visitBlockStmt(BlockStmt& stmt) {
 
 }
 
-void Resolver::visitBreakStmt(BreakStmt& /*stmt*/) {
+void Resolver::visitBreakStmt(BreakStmt& stmt) {
+  if (m_loopDepth == 0) {
+    m_lukErr.error(errTitle, stmt.m_keyword, 
+        "Cannot use '" + std::string(stmt.m_keyword->lexeme) + "' outside of a loop.");
+  }
 }
 
 
@@ -264,11 +339,11 @@ void Resolver::visitClassStmt(ClassStmt& stmt) {
     ClassType enclosingClass = currentClass;
     currentClass = ClassType::Class;
     
-    declare(stmt.m_name);
+    stmt.m_slot = declare(stmt.m_name);
     define(stmt.m_name);
 
     if (stmt.m_superclass != nullptr &&
-        stmt.m_name->lexeme == stmt.m_superclass->m_name->lexeme) {
+        stmt.m_name->symbol == stmt.m_superclass->m_name->symbol) {
         m_lukErr.error(errTitle, stmt.m_superclass->m_name,
           "A class cannot inherit from itself.");
     }
@@ -280,51 +355,34 @@ void Resolver::visitClassStmt(ClassStmt& stmt) {
       beginScope();
       if (m_scopes.size() == 0) return;
       auto& scope = m_scopes.back(); 
-      scope["super"] = Variable(stmt.m_superclass->m_name, VarState::READ);
+      scope[SymbolTable::Super] = Variable(stmt.m_superclass->m_name, VarState::READ, 0);
     }
     
-    beginScope();
-    if (m_scopes.size() == 0) return;
-    auto& scope = m_scopes.back(); 
-    // Using State READ for "this" to not generate an error for variable inused
-    scope["this"] = Variable(stmt.m_name, VarState::READ);
-    
-    // resolving static klass variables fields
-    TokPtr name;
-    ExprPtr initializer;
+    // Note: static variables are evaluated by the interpreter in the class's enclosing environment,
+    // so their initializers are resolved before the "this" scope.
     for (auto& it: stmt.m_vars) {
-        name = it.first;
-        initializer = it.second;
-        declare(name);
-        if (initializer != nullptr) {
-          resolve(initializer);
+        if (it.second != nullptr) {
+          resolve(it.second);
         }
-        define(name);
-        // make static already read to not generate error local variable inused
-        scope[name->lexeme] = Variable(name, VarState::READ);
     }
 
-    // resolving the methods
+    // Note: methods are declared in the class's enclosing environment,
+    // "this" is declared in the frame of each method.
+    m_thisName = stmt.m_name;
     for (auto funcStmt: stmt.m_methods) {
       auto declaration = FunctionType::Method;
-      if (funcStmt->m_name->lexeme == "init") {
+      if (funcStmt->m_name->symbol == SymbolTable::Init) {
         declaration = FunctionType::Initializer;
       }
       resolveFunction(*funcStmt->m_function, declaration); // [local] 
     }
     
-    // resolving classMethods
+    // resolving classMethods, "this" is the instance holding the static fields
     for (auto method: stmt.m_classMethods) {
-        beginScope();
-        auto& scope = m_scopes.back(); 
-        // Using State READ for "this" to not generate an error for variable inused
-        scope["this"] = Variable(method->m_name, VarState::READ);
+        m_thisName = method->m_name;
         resolveFunction(*method->m_function, FunctionType::Method); // [local] 
-        endScope();
     }
 
-
-    endScope();
     if (stmt.m_superclass != nullptr) endScope();
     currentClass = enclosingClass;
 }
@@ -336,7 +394,7 @@ void Resolver::visitExpressionStmt(ExpressionStmt& stmt) {
 
 
 void Resolver::visitFunctionStmt(FunctionStmt& stmt) {
-  declare(stmt.m_name);
+  stmt.m_slot = declare(stmt.m_name);
   define(stmt.m_name);
   resolveFunction(*stmt.m_function, FunctionType::Function);
 
@@ -374,10 +432,11 @@ void Resolver::visitReturnStmt(ReturnStmt& stmt) {
 void Resolver::visitVarStmt(VarStmt& stmt) {
     TokPtr name;
     ExprPtr initializer;
+    stmt.m_slots.clear();
     for (auto& it: stmt.m_vars) {
         name = it.first;
         initializer = it.second;
-        declare(name);
+        stmt.m_slots.push_back( declare(name) );
         if (initializer != nullptr) {
           resolve(initializer);
         }
@@ -386,8 +445,22 @@ void Resolver::visitVarStmt(VarStmt& stmt) {
 
 }
 
+void Resolver::visitForInStmt(ForInStmt& stmt) {
+  resolve(stmt.m_iterable);
+  beginScope();
+  stmt.m_slot = declare(stmt.m_name);
+  // Note: the loop variable can be unused, like in: for (i in range(3)) print "-";
+  m_scopes.back().at(stmt.m_name->symbol).m_state = VarState::READ;
+  ++m_loopDepth;
+  resolve(stmt.m_body);
+  --m_loopDepth;
+  endScope();
+}
+
 void Resolver::visitWhileStmt(WhileStmt& stmt) {
   resolve(stmt.m_condition);
+  ++m_loopDepth;
   resolve(stmt.m_body);
+  --m_loopDepth;
 }
 
@@ -27,33 +27,39 @@ namespace luky {
       explicit Resolver(Interpreter& interp, LukError& lukErr);
 
       ~Resolver() {
-        logMsg("\n~Resolver destructor");
+        LOG_MSG(cat_RESOLVER, "\n~Resolver destructor");
       }
       
       void resolve(std::vector<std::shared_ptr<Stmt>>& statements);
         
         // expressions
-        ObjPtr visitAssignExpr(AssignExpr& expr) override;
-        ObjPtr visitBinaryExpr(BinaryExpr& expr) override;
-        ObjPtr visitCallExpr(CallExpr& expr) override;
-        ObjPtr visitFunctionExpr(FunctionExpr& expr);
-        ObjPtr visitGetExpr(GetExpr& expr) override;
-        ObjPtr visitGroupingExpr(GroupingExpr& expr) override;
-        ObjPtr visitInterpolateExpr(InterpolateExpr& expr);
-        ObjPtr visitLiteralExpr(LiteralExpr& expr) override; 
-        ObjPtr visitLogicalExpr(LogicalExpr& expr) override;
-        ObjPtr visitSetExpr(SetExpr& expr) override;
-        ObjPtr visitSuperExpr(SuperExpr& expr) override;
-        ObjPtr visitTernaryExpr(TernaryExpr& expr);
-        ObjPtr visitThisExpr(ThisExpr& expr) override;
-        ObjPtr visitUnaryExpr(UnaryExpr& expr);
-        ObjPtr visitVariableExpr(VariableExpr& expr) override;
+        LukObject visitAssignExpr(AssignExpr& expr) override;
+        LukObject visitBinaryExpr(BinaryExpr& expr) override;
+        LukObject visitCallExpr(CallExpr& expr) override;
+        LukObject visitFunctionExpr(FunctionExpr& expr);
+        LukObject visitGetExpr(GetExpr& expr) override;
+        LukObject visitGroupingExpr(GroupingExpr& expr) override;
+        LukObject visitIndexExpr(IndexExpr& expr) override;
+        LukObject visitInterpolateExpr(InterpolateExpr& expr);
+        LukObject visitInvokeExpr(InvokeExpr& expr) override;
+        LukObject visitListExpr(ListExpr& expr) override;
+        LukObject visitLiteralExpr(LiteralExpr& expr) override; 
+        LukObject visitLogicalExpr(LogicalExpr& expr) override;
+        LukObject visitMapExpr(MapExpr& expr) override;
+        LukObject visitSetExpr(SetExpr& expr) override;
+        LukObject visitSetIndexExpr(SetIndexExpr& expr) override;
+        LukObject visitSuperExpr(SuperExpr& expr) override;
+        LukObject visitTernaryExpr(TernaryExpr& expr);
+        LukObject visitThisExpr(ThisExpr& expr) override;
+        LukObject visitUnaryExpr(UnaryExpr& expr);
+        LukObject visitVariableExpr(VariableExpr& expr) override;
         
         // statements
         void visitBlockStmt(BlockStmt& stmt) override;
         void visitBreakStmt(BreakStmt& stmt) override;
         void visitClassStmt(ClassStmt& stmt) override;
         void visitExpressionStmt(ExpressionStmt& stmt) override;
+        void visitForInStmt(ForInStmt& stmt) override;
         void visitFunctionStmt(FunctionStmt& stmt) override;
         void visitIfStmt(IfStmt& stmt) override;
         void visitPrintStmt(PrintStmt& stmt) override;
@@ -71,11 +77,13 @@ namespace luky {
         class Variable {
           public:
             Variable() {}
-            Variable(TokPtr& name, VarState state) : 
-              m_name(name), m_state(state) {}
+            Variable(TokPtr& name, VarState state, int slot) : 
+              m_name(name), m_state(state), m_slot(slot) {}
           
             TokPtr m_name;
             VarState m_state;
+            // index of the variable in its environment
+            int m_slot;
         };
 
 
@@ -91,12 +99,18 @@ namespace luky {
         const std::string errTitle = "ResolverError: ";
       Interpreter& m_interp;
       LukError& m_lukErr;
-      std::vector< std::unordered_map<std::string, Variable> > m_scopes;
+      // Note: scopes are keyed by the symbols of the names
+      std::vector< std::unordered_map<Symbol, Variable> > m_scopes;
       FunctionType m_curFunction = FunctionType::None;
+      // number of enclosing loops, for break and continue statements
+      int m_loopDepth =0;
+      // token reported for "this" in the method's scope
+      TokPtr m_thisName;
 
       // resolve expression
       void resolve(ExprPtr expr);
       void resolveLocal(Expr* expr, TokPtr& name, bool isRead);
+      int localDepth(Symbol name);
       
       // resolve statements
       void resolve(StmtPtr& stmt);
@@ -105,7 +119,7 @@ namespace luky {
 
       void beginScope();
       void endScope();
-      void declare(TokPtr& name);
+      int declare(TokPtr& name);
       void define(TokPtr& name);
 
     };
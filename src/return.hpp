@@ -1,17 +0,0 @@
-#ifndef RETURN_HPP
-#define RETURN_HPP
-#include "common.hpp"
-#include <stdexcept> // exception
-
-namespace luky {
-    class Return : public std::exception {
-    public:
-        explicit Return(ObjPtr& value) 
-            : m_value(value) 
-        {} 
-        
-        ObjPtr m_value;
-    };
-}
-
-#endif //  RETURN_HPP
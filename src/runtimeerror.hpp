@@ -15,7 +15,7 @@ namespace luky {
         {}
 
         RuntimeError(TokPtr& tok, const std::string& msg) 
-            : std::runtime_error(tok->lexeme + ", " + msg) 
+            : std::runtime_error(std::string(tok->lexeme) + ", " + msg) 
         {}
 
     };
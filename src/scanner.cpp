@@ -1,61 +1,43 @@
 #include "scanner.hpp"
 #include "lukerror.hpp"
+#include "reservedwords.hpp"
+#include "simd.hpp"
 using namespace luky;
 // static variables
 LukError lukErr;
 Scanner Scanner::m_scan = Scanner(lukErr);
 
-Scanner::Scanner(const std::string& source, LukError& lukErr)
+Scanner::Scanner(SourceUnit& unit, LukError& lukErr)
         : m_start(0), m_current(0),
         m_line(1), m_col(0),
-        m_source(source), m_lukErr(lukErr), 
+        p_unit(&unit), m_source(unit.source()), m_lukErr(lukErr), 
         m_addingEOF(true) {
-    logMsg("\nIn Scanner constructor");
-    initKeywords();
+    LOG_MSG(cat_SCANNER, "\nIn Scanner constructor");
+    // Note: about one token per 3 bytes of dense code, so the block is not copied while growing,
+    // the pages of a capacity never used are never touched
+    m_tokens.reserve(m_source.size() / 3 + 1);
 }
 
 Scanner::Scanner(LukError& lukErr)
         : m_start(0), m_current(0),
         m_line(1), m_col(0),
-        m_source(""), m_lukErr(lukErr),
+        p_unit(nullptr), m_source(""), m_lukErr(lukErr),
         m_addingEOF(false) {
-    logMsg("\nIn Second Scanner constructor");
-    initKeywords();
-}
-
-
-void Scanner::initKeywords() {
-    // initialize reserved m_keywords map
-    m_keywords["and"]    = TokenType::AND;
-    m_keywords["break"]    = TokenType::BREAK;
-    m_keywords["class"]  = TokenType::CLASS;
-    m_keywords["continue"]    = TokenType::CONTINUE;
-    m_keywords["do"]   = TokenType::DO;
-    m_keywords["else"]   = TokenType::ELSE;
-    m_keywords["false"]  = TokenType::FALSE;
-    m_keywords["for"]    = TokenType::FOR;
-    m_keywords["fun"]    = TokenType::FUN;
-    m_keywords["if"]     = TokenType::IF;
-    m_keywords["nil"]    = TokenType::NIL;
-    m_keywords["or"]     = TokenType::OR;
-    m_keywords["print"]  = TokenType::PRINT;
-    m_keywords["return"] = TokenType::RETURN;
-    m_keywords["super"]  = TokenType::SUPER;
-    m_keywords["this"]   = TokenType::THIS;
-    m_keywords["true"]   = TokenType::TRUE;
-    m_keywords["var"]    = TokenType::VAR;
-    m_keywords["while"]  = TokenType::WHILE;
-
-}
-
-void Scanner::initScan(const std::string& source, size_t line, size_t col, bool addingEOF) {
+    LOG_MSG(cat_SCANNER, "\nIn Second Scanner constructor");
+}
+
+
+void Scanner::initScan(SourceUnit* unit, std::string_view source, size_t line, size_t col, bool addingEOF) {
     // init global params
     m_start = m_current =0;
+    p_unit = unit;
     m_source = source;
     m_line = line;
     m_col = col;
     m_addingEOF = addingEOF;
     m_tokens.clear();
+    m_brackets =0;
+    m_outerBrackets.clear();
 
 }
 
@@ -64,34 +46,21 @@ void Scanner::addToken(const TokenType _tokenType) {
 }
 
 
-void Scanner::addToken(const TokenType type, const std::string& literal) {
-    // FIXE: manage the right lexeme
+void Scanner::addToken(const TokenType type, std::string_view literal) {
+    // Note: the lexeme is a view of the source, without string copy
     const size_t lexLen = m_current - m_start;
-    // avoid string copy
-    auto lexeme = literal;
-    if (type != TokenType::IDENTIFIER ||
-            type != TokenType::NUMBER ||
-            type != TokenType::STRING ||
-            type != TokenType::INT ||
-            type != TokenType::DOUBLE) { 
-        lexeme = m_source.substr(m_start, lexLen);
-    }
-    // std::cerr << "Token lexeme: " << lexeme << ", literal: " << literal << "\n";   
-    // Note: can  pass directly a new pointer to push_back function, without create the pointer before.
-    m_tokens.push_back( std::make_shared<Token>(type, lexeme, literal, m_line, m_col) );
+    m_tokens.emplace_back(type, m_source.substr(m_start, lexLen), literal, m_line, m_col);
 }
 
-void Scanner::insertToken(const TokenType type, const std::string& literal) { 
-    auto lexeme = literal;
+void Scanner::insertToken(const TokenType type, std::string_view literal) { 
     m_col++;
-    m_tokens.push_back( std::make_shared<Token>(type, lexeme, literal, m_line, m_col) );
+    m_tokens.emplace_back(type, literal, literal, m_line, m_col);
 
 }
 
-void Scanner::addToken(const TokenType type, const std::string& lexeme, std::string literal) {
-    if (literal == "") literal = lexeme;
-    // Note: can  pass directly a new pointer to push_back function, without create the pointer before.
-    m_tokens.push_back( std::make_shared<Token>(type, lexeme, literal, m_line, m_col) );
+void Scanner::addToken(const TokenType type, std::string_view lexeme, std::string_view literal) {
+    if (literal.empty()) literal = lexeme;
+    m_tokens.emplace_back(type, lexeme, literal, m_line, m_col);
 }
 
 void Scanner::scanToken() {
@@ -99,16 +68,33 @@ void Scanner::scanToken() {
     switch (ch) {
         case '(': addToken(TokenType::LEFT_PAREN); break;
         case ')': addToken(TokenType::RIGHT_PAREN); break;
-        case '{': addToken(TokenType::LEFT_BRACE); break;
+        case '{':
+            // Note: the parser tells a map literal from a block,
+            // and skips the semicolons inserted inside a map
+            m_outerBrackets.push_back(m_brackets);
+            m_brackets =0;
+            addToken(TokenType::LEFT_BRACE);
+            break;
+        case '[':
+            ++m_brackets;
+            addToken(TokenType::LEFT_BRACKET);
+            break;
+        case ']':
+            if (m_brackets > 0) --m_brackets;
+            addToken(TokenType::RIGHT_BRACKET);
+            break;
         
         // Automatic semicolon insertion
         case '}': 
-            lastToken = m_tokens.back();
-            if (lastToken->type != TokenType::LEFT_BRACE &&
-                    lastToken->type != TokenType::RIGHT_BRACE && 
-                    lastToken->type != TokenType::SEMICOLON) {
+            if (m_tokens.back().type != TokenType::LEFT_BRACE &&
+                    m_tokens.back().type != TokenType::RIGHT_BRACE && 
+                    m_tokens.back().type != TokenType::SEMICOLON) {
                 insertToken(TokenType::SEMICOLON, ";");
             }
+            if (!m_outerBrackets.empty()) {
+                m_brackets = m_outerBrackets.back();
+                m_outerBrackets.pop_back();
+            }
             addToken(TokenType::RIGHT_BRACE); 
             break;
         case ',': addToken(TokenType::COMMA); break;
@@ -187,24 +173,26 @@ void Scanner::scanToken() {
         case ' ':
         case '\r':
         case '\t':
-            // ignore whitespace
+            // ignore whitespace, the following blanks are skipped in bulk
+            skip(simd::spanBlanks(rest(), restSize()));
             break;
-        case '\n':
+        case '\n': {
             m_line++;
             m_col =0;
             // Automatic semicolon insertion
-            if (m_tokens.size() == 0) break;
-            lastToken = m_tokens.back();
+            if (m_tokens.size() == 0 || m_brackets > 0) break;
+            const TokenType lastType = m_tokens.back().type;
             // No insert semicolon 
-            if (lastToken->type == TokenType::RIGHT_PAREN && 
+            if (lastType == TokenType::RIGHT_PAREN && 
                     searchPrintable() == '{' ) {
                 break;
-            } else if (lastToken->type !=  TokenType::SEMICOLON &&
-                    lastToken->type != TokenType::LEFT_BRACE &&
-                    lastToken->type != TokenType::RIGHT_BRACE ) {
+            } else if (lastType !=  TokenType::SEMICOLON &&
+                    lastType != TokenType::LEFT_BRACE &&
+                    lastType != TokenType::RIGHT_BRACE) {
                 insertToken(TokenType::SEMICOLON, ";");
             }
             break;
+        }
 
 
         // support simple and double quotes string
@@ -226,7 +214,7 @@ void Scanner::scanToken() {
     }
 }
 
-const std::vector<TokPtr>&& Scanner::scanTokens() {
+void Scanner::scan() {
     while (!isAtEnd()) {
         // we are at the beginning of the next lexeme
         m_start = m_current;
@@ -234,17 +222,22 @@ const std::vector<TokPtr>&& Scanner::scanTokens() {
     }
     // Adding End Of File token?
     if (m_addingEOF) {
-        TokPtr endOfFile = std::make_shared<Token>(TokenType::END_OF_FILE, "EOF", "", m_line, m_col);
-        // Note: it will be safer to move the pointer to the vector
-        m_tokens.push_back( std::move(endOfFile) );
+        m_tokens.emplace_back(TokenType::END_OF_FILE, "EOF", "", m_line, m_col);
     }
 
-#ifdef DEBUG
-      logTokens();
-#endif
+    if (LOG_ENABLED(cat_SCANNER)) logTokens();
+}
+
+std::vector<TokPtr> Scanner::scanTokens() {
+    scan();
+    // Note: the block is moved to the unit, so its tokens keep their addresses
+    auto& block = p_unit->addTokens(std::move(m_tokens));
+    m_tokens = std::vector<Token>();
+    std::vector<TokPtr> v_tokens;
+    v_tokens.reserve(block.size());
+    for (auto& tok: block) v_tokens.push_back(&tok);
 
-    // Note: move function must be used when returning vector of pointer.
-    return std::move(m_tokens);
+    return v_tokens;
 }
 
 char Scanner::advance() {
@@ -258,46 +251,40 @@ bool Scanner::isAtEnd() const { return m_current >= m_source.size(); }
 void Scanner::identifier() {
     // using "maximal munch"
     // e.g. match "orchid" not "or" keyword and "chid"
-    while (isAlNum(peek()))
-        advance();
-    // see if the identifier is a reserved keyword
+    skip(simd::spanIdent(rest(), restSize()));
+    // see if the identifier is a reserved keyword, IDENTIFIER otherwise
     const size_t idLen = m_current - m_start;
-    const std::string identifier  = m_source.substr(m_start, idLen);
-        if ( m_keywords.find(identifier) != m_keywords.end() ) {
-            addToken(m_keywords[identifier]);
-    } else {
-        addToken(TokenType::IDENTIFIER);
-    }
+    addToken(reserved::lookup(m_source.substr(m_start, idLen)));
 }
 
 void Scanner::number() {
   bool isDecimal = false;
-    while (isDigit(peek()))
-        advance();
+    skip(simd::spanDigits(rest(), restSize()));
     // look for fractional part
     if (peek() == '.' && isDigit(peekNext())) {
       isDecimal = true;
         // consume the "."
         advance();
-        while (isDigit(peek()))
-            advance();
+        skip(simd::spanDigits(rest(), restSize()));
     }
     const size_t numLen = m_current - m_start;
-    const std::string numLiteral = m_source.substr(m_start, numLen);
+    const auto numLiteral = m_source.substr(m_start, numLen);
     if (not isDecimal) 
         addToken(TokenType::INT, numLiteral);
     else
         addToken(TokenType::DOUBLE, numLiteral);
 }
 
-std::string Scanner::unescape(const std::string& escaped) {
+std::string Scanner::unescape(std::string_view escaped) {
     // escape sequence character
     std::string strChar;
     
     for (size_t i=0; i < escaped.size(); i++) {
         if (escaped[i] == '\\') {
             i++;
-            switch (escaped[i]) {
+            // Note: a view has no null char after its end
+            const char esc = i < escaped.size() ? escaped[i] : '\0';
+            switch (esc) {
                 case 'n': strChar.push_back('\n'); break;
                 case 'r': strChar.push_back('\r'); break;
                 case '\\': strChar.push_back('\\'); break;
@@ -314,7 +301,7 @@ std::string Scanner::unescape(const std::string& escaped) {
                     /// is to create first char* in a std::string
                     m_lukErr.error(m_errTitle, m_line, m_col, 
                           std::string("Unrecognized escape sequence : '\\") +
-                          escaped[i] + "'."); 
+                          esc + "'."); 
             } 
         
         } else {
@@ -326,11 +313,23 @@ std::string Scanner::unescape(const std::string& escaped) {
     return  strChar;
 }
 
+std::string_view Scanner::stringLiteral(std::string_view raw) {
+    if (raw.find('\\') == std::string_view::npos) return raw;
+
+    return p_unit->addString(unescape(raw));
+}
+
 void Scanner::addString(char ch) {
     // the ch argument is to indicate whether it's simple or double quotes
     bool isInterp = false;
     synchronize();
     while (peek() != ch && !isAtEnd()) {
+        // Note: the chars before the next quote, newline, escape or interpolation are skipped in bulk
+        const size_t plain = simd::findAny(rest(), restSize(), ch, '\n', '\\', '$');
+        if (plain > 0) {
+            skip(plain);
+            continue;
+        }
         auto curChar = peek();
         auto nextChar = peekNext();
         if (curChar == '\n') {
@@ -343,8 +342,8 @@ void Scanner::addString(char ch) {
         // searching interpolation expression
         if ( isStartIdent(curChar) || isStartExpr(curChar) ) {
             isInterp = true;
-            auto part = unescape(getPart());
-            addToken(TokenType::STRING, unescape(part));
+            auto part = stringLiteral(getPart());
+            addToken(TokenType::STRING, stringLiteral(part));
             addToken(TokenType::INTERP_PLUS, "_+", "");
             synchronize();
 
@@ -386,8 +385,7 @@ void Scanner::addString(char ch) {
     if (strLen == 1 && isInterp) return;
     // if (strLen > 1 && isInterp) { // whether is not only '"' char
     else {
-        const std::string strLiteral = unescape(m_source.substr(m_start, strLen -1));
-        addToken(TokenType::STRING, strLiteral);
+        addToken(TokenType::STRING, stringLiteral(m_source.substr(m_start, strLen -1)));
     }
     
 
@@ -425,14 +423,11 @@ bool Scanner::isAlNum(const char c) const {
 }
 
 void Scanner::skipComments() {
-    while (!isAtEnd()) {
-        if (peek() != '\n') {
-            advance();
-        } else {
-            m_line++;
-            m_col =0;
-            return;
-        }
+    // Note: the comment is skipped in bulk, until the newline
+    skip(simd::findAny(rest(), restSize(), '\n', '\n', '\n', '\n'));
+    if (!isAtEnd()) {
+        m_line++;
+        m_col =0;
     }
 
 }
@@ -441,6 +436,8 @@ void Scanner::skipComments() {
 void Scanner::skipMultilineComments() {
     while (!isAtEnd()) {
         advance();
+        // Note: the chars which cannot start or end a comment are skipped in bulk
+        skip(simd::findAny(rest(), restSize(), '\n', '/', '*', '*'));
         if (peek() == '\n') {
             m_line++;
             m_col =0;
@@ -474,18 +471,18 @@ char Scanner::searchPrintable() {
 
 void Scanner::logTokens() {
   if (m_addingEOF)
-      logMsg("Tokens list for Main Scanner");
+      LOG_MSG(cat_SCANNER, "Tokens list for Main Scanner");
   else
-      logMsg("Tokens list for Second Scanner");
+      LOG_MSG(cat_SCANNER, "Tokens list for Second Scanner");
   for (auto& it: m_tokens) {
-    logMsg("id: ", it->id, "lexeme: ", it->lexeme);
+    LOG_MSG(cat_SCANNER, "line: ", it.line, ", col: ", it.col, ", lexeme: ", it.lexeme);
   }
 
 }
 
 void Scanner::synchronize() {
     m_start = m_col = m_current;
-    // logMsg("Synchronizing, start: ", start, ", current: ", current);
+    // LOG_MSG(cat_SCANNER, "Synchronizing, start: ", start, ", current: ", current);
 }
 
 bool Scanner::isStartIdent(const char c) const {
@@ -506,8 +503,8 @@ bool Scanner::isExpr(const char c) const {
     return true;
 }
 
-std::string Scanner::getIdent() {
-    // logMsg("\nIn getIdent, start: ", start, ", current: ", current);
+std::string_view Scanner::getIdent() {
+    // LOG_MSG(cat_SCANNER, "\nIn getIdent, start: ", start, ", current: ", current);
     // consume the '$' for the identifier
     if (!isAtEnd()) { 
         advance();
@@ -518,14 +515,14 @@ std::string Scanner::getIdent() {
         advance();
     }
     const size_t idLen = m_current - m_start;
-    const std::string ident  = m_source.substr(m_start, idLen);
-    // logMsg("Exit out  getIdent, with ident: ", ident, "\n");
+    const auto ident  = m_source.substr(m_start, idLen);
+    // LOG_MSG(cat_SCANNER, "Exit out  getIdent, with ident: ", ident, "\n");
 
     return ident;
 }
 
-std::string Scanner::getExpr() {
-    // logMsg("\nIn getExpr, start: ", start, ", current: ", current);
+std::string_view Scanner::getExpr() {
+    // LOG_MSG(cat_SCANNER, "\nIn getExpr, start: ", start, ", current: ", current);
     // consume the '${' for the expression
     auto oldStart = m_start;
     if (peek() == '$' && peekNext() == '{') { 
@@ -540,7 +537,7 @@ std::string Scanner::getExpr() {
     if (isAtEnd()) {
         auto errExpr = m_source.substr(oldStart, (m_current -1) - oldStart);
         m_lukErr.error(m_errTitle, m_line, m_col, 
-            std::string("Unterminated Interpolating Expression: '") + errExpr + "'");
+            "Unterminated Interpolating Expression: '" + std::string(errExpr) + "'");
         return errExpr;
     }
 
@@ -548,28 +545,28 @@ std::string Scanner::getExpr() {
     if (peek() == '}') advance();
     // unterminated interpolating expression
     const size_t exLen = (m_current -1) - m_start;
-    const std::string expr  = m_source.substr(m_start, exLen);
-    // logMsg("Exit out  getExpr, with expr: ", expr, "\n");
+    const auto expr  = m_source.substr(m_start, exLen);
+    // LOG_MSG(cat_SCANNER, "Exit out  getExpr, with expr: ", expr, "\n");
 
     return expr;
 }
 
 
-std::string Scanner::getPart() {
+std::string_view Scanner::getPart() {
     const size_t strLen = m_current - m_start;
-    // logMsg("\nIn addpart, start: ", start);
-    // logMsg("current: ", current, ", len: ", stringLen);
+    // LOG_MSG(cat_SCANNER, "\nIn addpart, start: ", start);
+    // LOG_MSG(cat_SCANNER, "current: ", current, ", len: ", stringLen);
     
     // trim the surrounding quotes
 
     return m_source.substr(m_start, strLen);
 }
-void Scanner::scanInterpExpr(const std::string& expr) {
-  // rescanning interpolating expression
-    m_scan.initScan(expr, m_line, m_col, false);
-    auto v_tok = m_scan.scanTokens();
-    /// Note: append v_tok into m_tokens without copy
-    std::move(v_tok.begin(), v_tok.end(), std::back_inserter(m_tokens));
+void Scanner::scanInterpExpr(std::string_view expr) {
+  // rescanning interpolating expression, a view of the same source
+    m_scan.initScan(p_unit, expr, m_line, m_col, false);
+    m_scan.scan();
+    /// Note: the tokens are small records, appended by copy
+    m_tokens.insert(m_tokens.end(), m_scan.m_tokens.begin(), m_scan.m_tokens.end());
 
 }
   
@@ -2,37 +2,43 @@
 #define SCANNER_HPP
 
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
 #include "lukerror.hpp"
+#include "luksource.hpp"
 #include "token.hpp"
 
 namespace luky {
     // class Scanner;
     class Scanner {
     public:
-        Scanner(const std::string& source, LukError& lukErr);
+        // Note: the unit is kept by the caller, the token lexemes are views into its source
+        Scanner(SourceUnit& unit, LukError& lukErr);
         Scanner(LukError& lukErr);
         
         ~Scanner() {
-          logMsg("\n~Scanner destructor");
+          LOG_MSG(cat_SCANNER, "\n~Scanner destructor");
         }    
         
-        void initScan(const std::string& source, size_t line, size_t col, bool addingEOF);
-        const std::vector<TokPtr>&& scanTokens();
+        void initScan(SourceUnit* unit, std::string_view source, size_t line, size_t col, bool addingEOF);
+        // Note: the tokens are kept in a single block of the unit
+        std::vector<TokPtr> scanTokens();
 
       private:
         size_t m_start;
         size_t m_current;
         size_t m_line;
         size_t m_col;
-        std::string m_source;
-        std::vector<TokPtr> m_tokens;
-        TokPtr lastToken;
+        // Note: the unit of the source, which keeps the tokens and the escaped literals
+        SourceUnit* p_unit;
+        std::string_view m_source;
+        std::vector<Token> m_tokens;
+        // Note: a newline inside brackets does not end the statement,
+        // so a list can be written on several lines, a brace starts a new level.
+        int m_brackets =0;
+        std::vector<int> m_outerBrackets;
         LukError& m_lukErr;
         const std::string m_errTitle = "ScanError: ";
-        // Reserved keywords
-        std::unordered_map<std::string, TokenType> m_keywords;
         bool m_addingEOF;
         /// Note: cannot put an instance of a class into itself
         /// that would result in infinite recursion
@@ -42,18 +48,26 @@ namespace luky {
         static Scanner m_scan;
 
 
-        void initKeywords();
         void addToken(TokenType);
-        void addToken(TokenType, const std::string&);
-        void addToken(TokenType, const std::string& lexeme, std::string literal);
-        void insertToken(const TokenType type, const std::string& literal);
+        void addToken(TokenType, std::string_view literal);
+        void addToken(TokenType, std::string_view lexeme, std::string_view literal);
+        void insertToken(const TokenType type, std::string_view literal);
+
+        void scan();
 
         void scanToken();
         char advance();
         bool isAtEnd() const;
+        // Note: the rest of the source from the current char, scanned by the simd kernels
+        const char* rest() const { return m_source.data() + m_current; }
+        size_t restSize() const { return m_current < m_source.size() ? m_source.size() - m_current : 0; }
+        // advances count chars, which are not newlines
+        void skip(size_t count) { m_current += count; m_col += count; }
         void identifier();
         void number();
-        std::string unescape(const std::string& escaped);
+        std::string unescape(std::string_view escaped);
+        // Note: the literal is a view of its source, materialized only whether it has escapes
+        std::string_view stringLiteral(std::string_view raw);
         void addString(char ch='"');
         bool match(char);
         char peek() const;
@@ -73,10 +87,10 @@ namespace luky {
         bool isIdent(const char c) const;
         bool isStartExpr(const char c) const;
         bool isExpr(const char c) const;
-        std::string getIdent();
-        std::string getExpr();
-        std::string getPart();
-        void scanInterpExpr(const std::string& expr);
+        std::string_view getIdent();
+        std::string_view getExpr();
+        std::string_view getPart();
+        void scanInterpExpr(std::string_view expr);
        
     };
 }
@@ -0,0 +1,313 @@
+#include "simd.hpp"
+
+#include <algorithm> // min, max
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LUKY_SIMD_X86 1
+#endif
+
+using namespace luky;
+using namespace luky::simd;
+
+namespace {
+    // Note: table of the kernels compiled for one instruction set
+    struct Kernels {
+        const char* name;
+        void (*binaryF64)(Op, const double*, const double*, bool, double*, size_t);
+        void (*binaryI64)(Op, const int64_t*, const int64_t*, bool, int64_t*, size_t);
+        void (*compareF64)(const double*, const double*, bool, int64_t*, size_t);
+        void (*compareI64)(const int64_t*, const int64_t*, bool, int64_t*, size_t);
+        double (*sumF64)(const double*, size_t);
+        int64_t (*sumI64)(const int64_t*, size_t);
+        double (*minF64)(const double*, size_t);
+        int64_t (*minI64)(const int64_t*, size_t);
+        double (*maxF64)(const double*, size_t);
+        int64_t (*maxI64)(const int64_t*, size_t);
+        double (*dotF64)(const double*, const double*, size_t);
+        int64_t (*dotI64)(const int64_t*, const int64_t*, size_t);
+    };
+
+    struct TextKernels {
+        size_t (*spanBlanks)(const char*, size_t);
+        size_t (*spanIdent)(const char*, size_t);
+        size_t (*spanDigits)(const char*, size_t);
+        size_t (*findAny)(const char*, size_t, char, char, char, char);
+    };
+
+    template <Op op>
+    inline double scalarOp(double a, double b) {
+        if constexpr (op == Op::Add) return a + b;
+        else if constexpr (op == Op::Sub) return a - b;
+        else if constexpr (op == Op::Mul) return a * b;
+        else return a / b;
+    }
+
+    // Note: the integers wrap around on overflow, like the SIMD registers
+    template <Op op>
+    inline int64_t scalarOp(int64_t a, int64_t b) {
+        uint64_t x = static_cast<uint64_t>(a);
+        uint64_t y = static_cast<uint64_t>(b);
+        if constexpr (op == Op::Add) return static_cast<int64_t>(x + y);
+        else if constexpr (op == Op::Sub) return static_cast<int64_t>(x - y);
+        else return static_cast<int64_t>(x * y);
+    }
+
+    template <class T>
+    inline int64_t cmp3(T a, T b) { return (a > b) - (a < b); }
+
+    // Note: a scalar register holds a single value
+    struct ScalarF64 {
+        using Reg = double;
+        static constexpr size_t Width =1;
+        static constexpr bool HasCompare = true;
+        static constexpr bool HasMinMax = true;
+        static Reg load(const double* p) { return *p; }
+        static void store(double* p, Reg r) { *p = r; }
+        static Reg set1(double val) { return val; }
+        static Reg zero() { return 0.0; }
+        static Reg add(Reg a, Reg b) { return a + b; }
+        static Reg sub(Reg a, Reg b) { return a - b; }
+        static Reg mul(Reg a, Reg b) { return a * b; }
+        static Reg div(Reg a, Reg b) { return a / b; }
+        static Reg min(Reg a, Reg b) { return std::min(a, b); }
+        static Reg max(Reg a, Reg b) { return std::max(a, b); }
+        static void storeCmp(int64_t* out, Reg a, Reg b) { *out = cmp3(a, b); }
+    };
+
+    struct ScalarI64 {
+        using Reg = int64_t;
+        static constexpr size_t Width =1;
+        static constexpr bool HasCompare = true;
+        static constexpr bool HasMinMax = true;
+        static Reg load(const int64_t* p) { return *p; }
+        static void store(int64_t* p, Reg r) { *p = r; }
+        static Reg set1(int64_t val) { return val; }
+        static Reg zero() { return 0; }
+        static Reg add(Reg a, Reg b) { return scalarOp<Op::Add>(a, b); }
+        static Reg sub(Reg a, Reg b) { return scalarOp<Op::Sub>(a, b); }
+        static Reg mul(Reg a, Reg b) { return scalarOp<Op::Mul>(a, b); }
+        static Reg min(Reg a, Reg b) { return std::min(a, b); }
+        static Reg max(Reg a, Reg b) { return std::max(a, b); }
+        static void storeCmp(int64_t* out, Reg a, Reg b) { *out = cmp3(a, b); }
+    };
+
+    // Note: the bytes are tested one by one, by the character classes
+    struct ScalarU8 {
+        static constexpr size_t Width =1;
+    };
+
+    namespace scalar {
+        using F64 = ScalarF64;
+        using I64 = ScalarI64;
+        using U8 = ScalarU8;
+        constexpr const char* IsaName = "scalar";
+#include "simd_kernels.inc"
+#include "simd_text.inc"
+    }
+
+#ifdef LUKY_SIMD_X86
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+    namespace sse2 {
+        struct F64 {
+            using Reg = __m128d;
+            static constexpr size_t Width =2;
+            static constexpr bool HasCompare = true;
+            static constexpr bool HasMinMax = true;
+            static Reg load(const double* p) { return _mm_loadu_pd(p); }
+            static void store(double* p, Reg r) { _mm_storeu_pd(p, r); }
+            static Reg set1(double val) { return _mm_set1_pd(val); }
+            static Reg zero() { return _mm_setzero_pd(); }
+            static Reg add(Reg a, Reg b) { return _mm_add_pd(a, b); }
+            static Reg sub(Reg a, Reg b) { return _mm_sub_pd(a, b); }
+            static Reg mul(Reg a, Reg b) { return _mm_mul_pd(a, b); }
+            static Reg div(Reg a, Reg b) { return _mm_div_pd(a, b); }
+            static Reg min(Reg a, Reg b) { return _mm_min_pd(a, b); }
+            static Reg max(Reg a, Reg b) { return _mm_max_pd(a, b); }
+            // Note: a true comparison is a mask of ones, so -1, lesser minus greater gives the sign
+            static void storeCmp(int64_t* out, Reg a, Reg b) {
+                __m128i lt = _mm_castpd_si128(_mm_cmplt_pd(a, b));
+                __m128i gt = _mm_castpd_si128(_mm_cmpgt_pd(a, b));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_sub_epi64(lt, gt));
+            }
+        };
+
+        // Note: SSE2 has no comparison of 64 bits integers
+        struct I64 {
+            using Reg = __m128i;
+            static constexpr size_t Width =2;
+            static constexpr bool HasCompare = false;
+            static constexpr bool HasMinMax = false;
+            static Reg load(const int64_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+            static void store(int64_t* p, Reg r) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), r); }
+            static Reg set1(int64_t val) { return _mm_set1_epi64x(val); }
+            static Reg zero() { return _mm_setzero_si128(); }
+            static Reg add(Reg a, Reg b) { return _mm_add_epi64(a, b); }
+            static Reg sub(Reg a, Reg b) { return _mm_sub_epi64(a, b); }
+        };
+
+        struct U8 {
+            using Reg = __m128i;
+            static constexpr size_t Width =16;
+            static constexpr uint32_t AllLanes = 0xFFFF;
+            static Reg load(const char* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+            static Reg set1(char val) { return _mm_set1_epi8(val); }
+            static Reg eq(Reg a, Reg b) { return _mm_cmpeq_epi8(a, b); }
+            static Reg gt(Reg a, Reg b) { return _mm_cmpgt_epi8(a, b); }
+            static Reg orr(Reg a, Reg b) { return _mm_or_si128(a, b); }
+            static Reg andd(Reg a, Reg b) { return _mm_and_si128(a, b); }
+            static uint32_t mask(Reg r) { return static_cast<uint32_t>(_mm_movemask_epi8(r)); }
+        };
+
+        constexpr const char* IsaName = "sse2";
+#include "simd_kernels.inc"
+#include "simd_text.inc"
+    }
+#if defined(__clang__)
+#pragma clang attribute pop
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to = function)
+#else
+#pragma GCC pop_options
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+    namespace avx2 {
+        struct F64 {
+            using Reg = __m256d;
+            static constexpr size_t Width =4;
+            static constexpr bool HasCompare = true;
+            static constexpr bool HasMinMax = true;
+            static Reg load(const double* p) { return _mm256_loadu_pd(p); }
+            static void store(double* p, Reg r) { _mm256_storeu_pd(p, r); }
+            static Reg set1(double val) { return _mm256_set1_pd(val); }
+            static Reg zero() { return _mm256_setzero_pd(); }
+            static Reg add(Reg a, Reg b) { return _mm256_add_pd(a, b); }
+            static Reg sub(Reg a, Reg b) { return _mm256_sub_pd(a, b); }
+            static Reg mul(Reg a, Reg b) { return _mm256_mul_pd(a, b); }
+            static Reg div(Reg a, Reg b) { return _mm256_div_pd(a, b); }
+            static Reg min(Reg a, Reg b) { return _mm256_min_pd(a, b); }
+            static Reg max(Reg a, Reg b) { return _mm256_max_pd(a, b); }
+            static void storeCmp(int64_t* out, Reg a, Reg b) {
+                __m256i lt = _mm256_castpd_si256(_mm256_cmp_pd(a, b, _CMP_LT_OQ));
+                __m256i gt = _mm256_castpd_si256(_mm256_cmp_pd(a, b, _CMP_GT_OQ));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_sub_epi64(lt, gt));
+            }
+        };
+
+        struct I64 {
+            using Reg = __m256i;
+            static constexpr size_t Width =4;
+            static constexpr bool HasCompare = true;
+            static constexpr bool HasMinMax = true;
+            static Reg load(const int64_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+            static void store(int64_t* p, Reg r) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), r); }
+            static Reg set1(int64_t val) { return _mm256_set1_epi64x(val); }
+            static Reg zero() { return _mm256_setzero_si256(); }
+            static Reg add(Reg a, Reg b) { return _mm256_add_epi64(a, b); }
+            static Reg sub(Reg a, Reg b) { return _mm256_sub_epi64(a, b); }
+            // Note: min and max select the lanes with the mask of the greater comparison
+            static Reg min(Reg a, Reg b) { return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b)); }
+            static Reg max(Reg a, Reg b) { return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b)); }
+            static void storeCmp(int64_t* out, Reg a, Reg b) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out),
+                        _mm256_sub_epi64(_mm256_cmpgt_epi64(b, a), _mm256_cmpgt_epi64(a, b)));
+            }
+        };
+
+        struct U8 {
+            using Reg = __m256i;
+            static constexpr size_t Width =32;
+            static constexpr uint32_t AllLanes = 0xFFFFFFFF;
+            static Reg load(const char* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+            static Reg set1(char val) { return _mm256_set1_epi8(val); }
+            static Reg eq(Reg a, Reg b) { return _mm256_cmpeq_epi8(a, b); }
+            static Reg gt(Reg a, Reg b) { return _mm256_cmpgt_epi8(a, b); }
+            static Reg orr(Reg a, Reg b) { return _mm256_or_si256(a, b); }
+            static Reg andd(Reg a, Reg b) { return _mm256_and_si256(a, b); }
+            static uint32_t mask(Reg r) { return static_cast<uint32_t>(_mm256_movemask_epi8(r)); }
+        };
+
+        constexpr const char* IsaName = "avx2";
+#include "simd_kernels.inc"
+#include "simd_text.inc"
+    }
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+#endif // LUKY_SIMD_X86
+
+    // Note: the CPU features are checked once, before main
+    const Kernels* selectKernels() {
+#ifdef LUKY_SIMD_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return &avx2::table;
+        if (__builtin_cpu_supports("sse2")) return &sse2::table;
+#endif
+        return &scalar::table;
+    }
+
+    const Kernels* s_kernels = selectKernels();
+
+    const TextKernels* selectTextKernels() {
+#ifdef LUKY_SIMD_X86
+        if (s_kernels == &avx2::table) return &avx2::textTable;
+        if (s_kernels == &sse2::table) return &sse2::textTable;
+#endif
+        return &scalar::textTable;
+    }
+
+    const TextKernels* s_text = selectTextKernels();
+}
+
+void simd::binary(Op op, const double* a, const double* b, bool bScalar, double* out, size_t n) {
+    s_kernels->binaryF64(op, a, b, bScalar, out, n);
+}
+
+void simd::binary(Op op, const int64_t* a, const int64_t* b, bool bScalar, int64_t* out, size_t n) {
+    s_kernels->binaryI64(op, a, b, bScalar, out, n);
+}
+
+void simd::compare(const double* a, const double* b, bool bScalar, int64_t* out, size_t n) {
+    s_kernels->compareF64(a, b, bScalar, out, n);
+}
+
+void simd::compare(const int64_t* a, const int64_t* b, bool bScalar, int64_t* out, size_t n) {
+    s_kernels->compareI64(a, b, bScalar, out, n);
+}
+
+double simd::sum(const double* a, size_t n) { return s_kernels->sumF64(a, n); }
+int64_t simd::sum(const int64_t* a, size_t n) { return s_kernels->sumI64(a, n); }
+double simd::min(const double* a, size_t n) { return s_kernels->minF64(a, n); }
+int64_t simd::min(const int64_t* a, size_t n) { return s_kernels->minI64(a, n); }
+double simd::max(const double* a, size_t n) { return s_kernels->maxF64(a, n); }
+int64_t simd::max(const int64_t* a, size_t n) { return s_kernels->maxI64(a, n); }
+
+double simd::dot(const double* a, const double* b, size_t n) {
+    return s_kernels->dotF64(a, b, n);
+}
+
+int64_t simd::dot(const int64_t* a, const int64_t* b, size_t n) {
+    return s_kernels->dotI64(a, b, n);
+}
+
+size_t simd::spanBlanks(const char* p, size_t n) { return s_text->spanBlanks(p, n); }
+size_t simd::spanIdent(const char* p, size_t n) { return s_text->spanIdent(p, n); }
+size_t simd::spanDigits(const char* p, size_t n) { return s_text->spanDigits(p, n); }
+
+size_t simd::findAny(const char* p, size_t n, char a, char b, char c, char d) {
+    return s_text->findAny(p, n, a, b, c, d);
+}
+
+const char* simd::level() { return s_kernels->name; }
+
+void simd::disable() {
+    s_kernels = &scalar::table;
+    s_text = &scalar::textTable;
+}
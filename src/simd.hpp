@@ -0,0 +1,50 @@
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+#include <cstddef> // size_t
+#include <cstdint> // int64_t
+
+namespace luky {
+    /// Note: element-wise kernels and reductions over unboxed buffers of doubles and int64,
+    /// used by the typed numeric arrays, and byte kernels used by the scanner.
+    /// Each kernel is compiled for AVX2, SSE2 and plain scalar code,
+    /// the best version supported by the CPU is selected once at startup.
+    namespace simd {
+        enum class Op { Add, Sub, Mul, Div };
+
+        // Note: b points to n values, or to a single value whether bScalar is true.
+        // out can be a, so the operation is done in place.
+        void binary(Op op, const double* a, const double* b, bool bScalar, double* out, size_t n);
+        // Note: Div is not an integer operation, the results wrap around on overflow
+        void binary(Op op, const int64_t* a, const int64_t* b, bool bScalar, int64_t* out, size_t n);
+        // stores -1, 0 or 1 whether a is lesser, equal or greater than b
+        void compare(const double* a, const double* b, bool bScalar, int64_t* out, size_t n);
+        void compare(const int64_t* a, const int64_t* b, bool bScalar, int64_t* out, size_t n);
+
+        double sum(const double* a, size_t n);
+        int64_t sum(const int64_t* a, size_t n);
+        // Note: n must be greater than 0
+        double min(const double* a, size_t n);
+        int64_t min(const int64_t* a, size_t n);
+        double max(const double* a, size_t n);
+        int64_t max(const int64_t* a, size_t n);
+        double dot(const double* a, const double* b, size_t n);
+        int64_t dot(const int64_t* a, const int64_t* b, size_t n);
+
+        // Note: scanner kernels over the n bytes of a source from p.
+        // A span returns the length of the run of bytes in its class, from p:
+        // blanks are ' ', '\t' and '\r', identifier chars are ASCII letters, digits and '_'.
+        size_t spanBlanks(const char* p, size_t n);
+        size_t spanIdent(const char* p, size_t n);
+        size_t spanDigits(const char* p, size_t n);
+        // position of the first byte equal to a, b, c or d, n whether there is none
+        size_t findAny(const char* p, size_t n, char a, char b, char c, char d);
+
+        // name of the selected instruction set: "avx2", "sse2" or "scalar"
+        const char* level();
+        // selects the scalar kernels, whatever the CPU supports
+        void disable();
+    }
+}
+
+#endif // SIMD_HPP
@@ -13,6 +13,7 @@ namespace luky {
     class BreakStmt;
     class ClassStmt;
     class ExpressionStmt;
+    class ForInStmt;
     class FunctionStmt;
     class IfStmt;
     class PrintStmt;
@@ -29,6 +30,7 @@ namespace luky {
         virtual void visitClassStmt(ClassStmt&) =0;
         virtual void visitBreakStmt(BreakStmt&) =0;
         virtual void visitExpressionStmt(ExpressionStmt&) =0;
+        virtual void visitForInStmt(ForInStmt&) =0;
         virtual void visitFunctionStmt(FunctionStmt&) =0;
         virtual void visitIfStmt(IfStmt&) =0;
         virtual void visitPrintStmt(PrintStmt&) =0;
@@ -77,6 +79,8 @@ namespace luky {
         std::vector<std::pair<TokPtr, ExprPtr>> m_vars;
         std::vector<FuncPtr> m_methods;
         std::vector<FuncPtr> m_classMethods;
+        // slot assigned by the resolver, -1 for a global class
+        int m_slot = -1;
 
     };
 
@@ -108,6 +112,30 @@ namespace luky {
         ExprPtr m_expression;
     };
 
+    /// Note: for (var name in iterable) body
+    /// The loop variable is a fresh local of the loop scope,
+    /// the iterable is a range, a list or a typed array.
+    class ForInStmt : public Stmt {
+    public:
+        ForInStmt(TokPtr& keyword, TokPtr& name, ExprPtr iterable, StmtPtr body) :
+            m_keyword(keyword),
+            m_name(name),
+            m_iterable(std::move(iterable)),
+            m_body(std::move(body))
+        {}
+
+        void accept(StmtVisitor& v) override {
+            v.visitForInStmt(*this);
+        }
+
+        TokPtr m_keyword;
+        TokPtr m_name;
+        ExprPtr m_iterable;
+        StmtPtr m_body;
+        // slot of the loop variable, assigned by the resolver
+        int m_slot = -1;
+    };
+
     class FunctionStmt : public Stmt {
     public:
         FunctionStmt() {}
@@ -134,6 +162,8 @@ namespace luky {
         
         TokPtr m_name;
         std::shared_ptr<FunctionExpr> m_function;
+        // slot assigned by the resolver, -1 for a global function
+        int m_slot = -1;
     };
 
 
@@ -194,6 +224,8 @@ namespace luky {
             v.visitVarStmt(*this);
         }
         std::vector<std::pair<TokPtr, ExprPtr>> m_vars;
+        // slots assigned by the resolver for each variable, -1 for a global variable
+        std::vector<int> m_slots;
 
     };
 
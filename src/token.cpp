@@ -1,18 +1,13 @@
 #include "token.hpp"
 using namespace luky;
 
-int Token::next_id =0;
-Token::Token() : id(++next_id) {
-    logMsg("\nToken constructor, id: ", id, ", lexeme: None");
-}
-
-Token::Token(const TokenType _type, const std::string& _lexeme,
-        const std::string& _literal, const int _line, const int _col)
-        : id(++next_id), type(_type), 
-        lexeme(_lexeme), literal(_literal), 
-        line(_line), col(_col) {
-
-    logMsg("\nToken constructor, id: ", id, ", lexeme: ", lexeme);
+Token::Token(const TokenType _type, std::string_view _lexeme,
+        std::string_view _literal, const int _line, const int _col)
+        : type(_type), 
+        line(_line), col(_col),
+        lexeme(_lexeme), literal(_literal) {
+    if (type == TokenType::IDENTIFIER || type == TokenType::THIS || type == TokenType::SUPER)
+        symbol = intern(lexeme);
 }
 
 std::string Token::toString() const {
@@ -21,10 +16,10 @@ std::string Token::toString() const {
         type == TokenType::NUMBER || 
         type == TokenType::INT || 
         type == TokenType::DOUBLE) { 
-        return literal;
+        return std::string(literal);
     }
 
-    return lexeme;
+    return std::string(lexeme);
 }
 
 std::string Token::stringType() const {
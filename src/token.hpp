@@ -3,15 +3,16 @@
 
 #include "common.hpp"
 #include "logger.hpp"
+#include "luksymbol.hpp"
 #include <string>
-#include <memory> // for smart pointers
+#include <string_view>
 
 namespace luky {
-    // using TokPtr = std::shared_ptr<Token>;
     enum class TokenType {
         // Single-character tokens.
         LEFT_PAREN, RIGHT_PAREN,
         LEFT_BRACE, RIGHT_BRACE,
+        LEFT_BRACKET, RIGHT_BRACKET,
         COMMA, DOT, 
         MINUS, PLUS, SEMICOLON, 
         SLASH, STAR,
@@ -46,7 +47,7 @@ namespace luky {
         DO, ELSE,
         FALSE, FOR, 
         FUN, IF, 
-        INTERP_PLUS, NIL, 
+        IN, INTERP_PLUS, NIL, 
         OR, PRINT,
         RETURN, SUPER,
         THIS, TRUE,
@@ -55,38 +56,32 @@ namespace luky {
         END_OF_FILE
     };
 
+    /// Note: a token is a small record, with no string of its own.
+    /// The lexeme and the literal are views into the source buffer of a SourceUnit,
+    /// or into a string materialized by the scanner for an escaped literal,
+    /// which live as long as the unit, like the tokens themselves.
     class Token {
-    protected:
-        static int next_id;
     public:
-        int id;
-        TokenType type;
-        std::string lexeme;
-        std::string literal;
-        int line;
-        int col;
+        TokenType type = TokenType::END_OF_FILE;
+        // Note: interned name of an identifier, this or super, NoSymbol for other tokens
+        Symbol symbol = SymbolTable::NoSymbol;
+        int line =0;
+        int col =0;
+        std::string_view lexeme;
+        std::string_view literal;
         
         // constructors
-        Token(); 
-        Token(TokenType _type, const std::string& _lexeme,
-              const std::string& _literal, const int _line, const int _col);
-        
-        // destructors
-        ~Token() {
-            logMsg("\n~Token destructor, id: ", id, ", lexeme: ", lexeme);
-        }
+        Token() = default;
+        Token(TokenType _type, std::string_view _lexeme,
+              std::string_view _literal, const int _line, const int _col);
         
         std::string toString() const;
         std::string stringType() const;
-        
-        friend inline std::ostream& operator<<(std::ostream& ost, Token& tok);
-        friend inline std::ostream& operator<<(std::ostream& ost, TokPtr& tokP);
     };
 
 }
-    // friend function declaration, because ostream accept only one argument
-    inline std::ostream& operator<<(std::ostream& ost, luky::Token& tok) { return ost << tok.lexeme; } 
-    inline std::ostream& operator<<(std::ostream& ost, luky::TokPtr& tokP) { return ost << tokP->lexeme; } 
+    inline std::ostream& operator<<(std::ostream& ost, const luky::Token& tok) { return ost << tok.lexeme; } 
+    inline std::ostream& operator<<(std::ostream& ost, const luky::TokPtr& tokP) { return ost << tokP->lexeme; } 
 
 
 #endif // TOKEN_HPP